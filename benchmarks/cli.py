@@ -6,6 +6,7 @@ Subcommands:
     suite   — run all models on a task and build a comparison report
     replay  — watch a saved winner .pkl perform
     play    — play VoxelForage yourself (keyboard)
+    packed  — time one PackedNet step over a mutated population
 
 Usage::
 
@@ -13,6 +14,7 @@ Usage::
     python -m benchmarks suite  --task voxel_forage --runs 2 --generations 15
     python -m benchmarks replay benchmarks/output/recurrent_net_scent_seed42.pkl
     python -m benchmarks play   --task voxel_forage [--no-scent]
+    python -m benchmarks packed --batch-size 1
 """
 
 from __future__ import annotations
@@ -47,6 +49,10 @@ def _cmd_train(args: argparse.Namespace) -> None:
         verbose=not args.quiet,
         eval_strategy=args.eval_strategy,
         validation_episodes=args.validation_episodes,
+        novelty=(
+            {"novelty_weight": 1.0, "fitness_weight": args.novelty_fitness_weight} if args.novelty else None
+        ),
+        racing=args.racing,
         pretrain_episodes=args.pretrain_episodes,
         pretrain_epochs=args.pretrain_epochs,
     )
@@ -278,6 +284,51 @@ def _cmd_play(args: argparse.Namespace) -> None:
     env.close()
 
 
+# ---------------------------------------------------------------------------
+# packed
+# ---------------------------------------------------------------------------
+
+
+def _cmd_packed(args: argparse.Namespace) -> None:
+    import numpy as np
+
+    import neat3p
+    from neat3p.nn.phenotypes.packed_net import PackedNet
+
+    config_path = args.config or os.path.join(os.path.dirname(__file__), "configs", "cartpole.cfg")
+    config = neat3p.Config(
+        neat3p.NativeGenome,
+        neat3p.DefaultReproduction,
+        neat3p.DefaultSpeciesSet,
+        neat3p.DefaultStagnation,
+        config_path,
+    )
+    neat3p._neat3p.seed(args.seed)
+    genomes = []
+    for key in range(args.genomes):
+        genome = neat3p.NativeGenome(key=key)
+        genome.configure_new(config.genome_config)
+        for _ in range(args.mutations):
+            genome.mutate(config.genome_config)
+        genomes.append((key, genome))
+
+    net = PackedNet.create(genomes, config, batch_size=args.batch_size, recurrent=args.recurrent)
+    rng = np.random.default_rng(args.seed)
+    inputs = rng.uniform(-1.0, 1.0, (args.genomes, args.batch_size, config.genome_config.num_inputs))
+    inputs = inputs.astype(np.float32)
+    net.activate(inputs)
+
+    t0 = time.perf_counter()
+    for _ in range(args.steps):
+        net.activate(inputs)
+    elapsed = time.perf_counter() - t0
+
+    packed = net.packed
+    print(f"{args.genomes} genomes, batch {args.batch_size}: {packed.num_nodes} nodes, {packed.num_links} links")
+    print(f"  {elapsed / args.steps * 1e6:.1f} us/step")
+    print(f"  {elapsed / (args.steps * args.genomes * args.batch_size) * 1e9:.1f} ns/network step")
+
+
 # ---------------------------------------------------------------------------
 # Entry point
 # ---------------------------------------------------------------------------
@@ -286,7 +337,7 @@ def _cmd_play(args: argparse.Namespace) -> None:
 def build_parser() -> argparse.ArgumentParser:
     parser = argparse.ArgumentParser(
         prog="python -m benchmarks",
-        description="neat3p benchmark CLI — train, suite, replay, play.",
+        description="neat3p benchmark CLI — train, suite, replay, play, packed.",
     )
     sub = parser.add_subparsers(dest="command", required=True)
 
@@ -307,6 +358,13 @@ def build_parser() -> argparse.ArgumentParser:
     p_train.add_argument("--episodes", type=int, default=3)
     p_train.add_argument("--eval-strategy", choices=["per_generation", "fixed", "random"], default="per_generation")
     p_train.add_argument("--validation-episodes", type=int, default=0)
+    p_train.add_argument(
+        "--racing", action="store_true", help="Stop evaluating genomes that cannot reach their species' survivors."
+    )
+    p_train.add_argument("--novelty", action="store_true", help="Score genomes by behavioural novelty.")
+    p_train.add_argument(
+        "--novelty-fitness-weight", type=float, default=0.0, help="Weight of reward next to novelty (with --novelty)."
+    )
     p_train.add_argument("--pretrain-episodes", type=int, default=250)
     p_train.add_argument("--pretrain-epochs", type=int, default=100)
 
@@ -352,6 +410,16 @@ def build_parser() -> argparse.ArgumentParser:
     p_play.add_argument("--no-scent", action="store_true")
     p_play.add_argument("--seed", type=int, default=None)
 
+    # ── packed ──
+    p_packed = sub.add_parser("packed", help="Time one PackedNet step over a mutated population.")
+    p_packed.add_argument("--config", default=None, help="NEAT config (default: configs/cartpole.cfg).")
+    p_packed.add_argument("--genomes", type=int, default=150)
+    p_packed.add_argument("--mutations", type=int, default=30, help="Mutations applied to each genome.")
+    p_packed.add_argument("--batch-size", type=int, default=1)
+    p_packed.add_argument("--recurrent", action="store_true")
+    p_packed.add_argument("--steps", type=int, default=2000)
+    p_packed.add_argument("--seed", type=int, default=42)
+
     return parser
 
 
@@ -366,3 +434,5 @@ def main() -> None:
         _cmd_replay(args)
     elif args.command == "play":
         _cmd_play(args)
+    elif args.command == "packed":
+        _cmd_packed(args)
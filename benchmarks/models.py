@@ -243,7 +243,7 @@ class _FeatureAttentionAdapter(ModelAdapter):
 # ---------------------------------------------------------------------------
 
 
-def _make_hyperneat_wrapper(in_c: Any, hid_c: Any, out_c: Any, device: str) -> type:
+def _make_hyperneat_wrapper(in_c: Any, hid_c: Any, out_c: Any, device: str, native: bool | None = None) -> type:
     from neat3p.nn.composite import HyperNEATNet
 
     class _W:
@@ -252,7 +252,11 @@ def _make_hyperneat_wrapper(in_c: Any, hid_c: Any, out_c: Any, device: str) -> t
 
         @classmethod
         def create(cls, genome, config, batch_size=1, use_current_activs=True, _dev=device):
-            return cls(HyperNEATNet.create(genome, config, in_c, hid_c, out_c, batch_size=batch_size, device=_dev))
+            return cls(
+                HyperNEATNet.create(
+                    genome, config, in_c, hid_c, out_c, batch_size=batch_size, device=_dev, native=native
+                )
+            )
 
         def activate(self, inputs):
             return self._net.activate(inputs)
@@ -264,14 +268,20 @@ def _make_hyperneat_wrapper(in_c: Any, hid_c: Any, out_c: Any, device: str) -> t
 
 
 class _HyperNEATAdapter(ModelAdapter):
+    """
+    ``native`` picks the substrate's execution path: unset runs it through the
+    native sparse/dense kernel on the CPU and torch elsewhere, True / False
+    force one of the two.
+    """
+
     kind = "hyper_neat"
-    tunables = {}
+    tunables = {"native": bool}
 
     def build(self, task: TaskSpec, env_id: str, seed: int, device: str, verbose: bool, **tunables: Any) -> NetBuild:
         if task.substrate is None:
             raise ValueError(f"Task '{task.name}' has no substrate; hyper_neat requires one.")
         in_c, hid_c, out_c = task.substrate()
-        return NetBuild(_make_hyperneat_wrapper(in_c, hid_c, out_c, device), {}, {})
+        return NetBuild(_make_hyperneat_wrapper(in_c, hid_c, out_c, device, tunables.get("native")), {}, {})
 
     def rebuild(self, pkg: dict, device: str) -> tuple[Any, str]:
         import neat3p
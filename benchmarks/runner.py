@@ -81,6 +81,8 @@ def run_benchmark(
     progress_position: int = 0,
     eval_strategy: str = "per_generation",
     validation_episodes: int = 0,
+    novelty: dict | None = None,
+    racing: bool = False,
     **tunables,
 ) -> dict:
     """Run one benchmark trial. Returns the canonical stats dict.
@@ -88,6 +90,8 @@ def run_benchmark(
     task_name:  key in TASKS ("cartpole", "voxel_forage", …)
     model_name: key in MODELS ("recurrent_net", "feature_attention", …)
     variant:    task variant key (e.g. "scent" / "noscent" for voxel_forage; ignored if no variants)
+    novelty:    neat3p.NoveltySearch kwargs to score genomes by novelty (None = reward only)
+    racing:     stop evaluating genomes early once they cannot reach their species' survivors
     **tunables: model-specific knobs forwarded only to the adapter that declares them
     """
     task = TASKS[task_name]
@@ -118,6 +122,8 @@ def run_benchmark(
         progress_position=progress_position,
         eval_strategy=eval_strategy,
         validation_episodes=validation_episodes,
+        novelty=novelty,
+        racing=racing,
     )
 
     rewards = result.evaluate_rewards(n_episodes=eval_episodes, seed=seed + 1)
@@ -110,21 +110,27 @@ def _make_net(
     return net_class(genome, state_dim, action_dim, config, **net_kwargs)
 
 
-def _rollout_recurrent(env, net, seed=None) -> float:
-    obs, _ = env.reset(seed=seed)
+def _behavior(obs, info) -> np.ndarray:
+    """Behaviour characterization of an episode: the final agent position if the env reports one
+    (VoxelForage does), else the final observation."""
+    return np.asarray(info.get("pos", obs), dtype=np.float32)
+
+
+def _rollout_recurrent(env, net, seed=None, with_behavior: bool = False):
+    obs, info = env.reset(seed=seed)
     net.reset(batch_size=1)
     total = 0.0
     terminated = truncated = False
     while not (terminated or truncated):
         out = net.activate([obs.tolist()])
         action = int(out[0].argmax().item())
-        obs, reward, terminated, truncated, _ = env.step(action)
+        obs, reward, terminated, truncated, info = env.step(action)
         total += float(reward)
-    return total
+    return (total, _behavior(obs, info)) if with_behavior else total
 
 
-def _rollout_module(env, net, seed=None) -> float:
-    obs, _ = env.reset(seed=seed)
+def _rollout_module(env, net, seed=None, with_behavior: bool = False):
+    obs, info = env.reset(seed=seed)
     net.reset(batch_size=1)
     total = 0.0
     terminated = truncated = False
@@ -132,15 +138,16 @@ def _rollout_module(env, net, seed=None) -> float:
         obs_t = torch.tensor(obs, dtype=torch.float32).unsqueeze(0)
         out = net(obs_t)
         action = int(out.argmax(dim=1).item())
-        obs, reward, terminated, truncated, _ = env.step(action)
+        obs, reward, terminated, truncated, info = env.step(action)
         total += float(reward)
-    return total
+    return (total, _behavior(obs, info)) if with_behavior else total
 
 
-def _rollout(env, net, recurrent_style: bool, seed=None) -> float:
+def _rollout(env, net, recurrent_style: bool, seed=None, with_behavior: bool = False):
+    """Total episode reward, or (reward, behaviour) with ``with_behavior``."""
     if recurrent_style:
-        return _rollout_recurrent(env, net, seed)
-    return _rollout_module(env, net, seed)
+        return _rollout_recurrent(env, net, seed, with_behavior)
+    return _rollout_module(env, net, seed, with_behavior)
 
 
 class GymEvalResult:
@@ -270,6 +277,8 @@ def run_neat_gym(
     progress_position: int = 0,
     eval_strategy: str = "per_generation",
     validation_episodes: int = 0,
+    novelty: dict = None,
+    racing: bool = False,
 ) -> GymEvalResult:
     """Run NEAT on a Gymnasium env and return a GymEvalResult.
 
@@ -286,6 +295,15 @@ def run_neat_gym(
     held-out worlds and record it in ``result.validation_stats`` — the clean progress curve.
     The winner is always scored on a separate held-out seed stream by ``evaluate_rewards``.
 
+    ``novelty``: keyword arguments for ``neat3p.NoveltySearch`` (``{}`` for the defaults) to score
+    genomes by novelty instead of / alongside reward, for deceptive tasks such as the ``noscent``
+    VoxelForage variant. The behaviour is the final agent position (or final observation), averaged
+    over the K worlds. The winner is then the genome with the best raw reward, not the most novel.
+
+    ``racing``: evaluate with ``neat3p.RacingEvaluator`` — episodes are played one world at a
+    time and genomes that statistically cannot reach their species' survival threshold stop early,
+    keeping the mean of the episodes they played. Not combinable with ``novelty``.
+
     verbose: if False, suppresses the StdOutReporter (useful for suite runs).
     """
     if net_kwargs is None:
@@ -323,6 +341,41 @@ def run_neat_gym(
                 genome.fitness = float(np.mean([_rollout(env, net, recurrent_style, seed=s) for s in world_seeds]))
         gen_counter[0] += 1
 
+    def eval_genomes_with_behavior(genomes, cfg):
+        world_seeds = _world_seeds(gen_counter[0])
+        if world_seeds is None:
+            world_seeds = [None] * episodes_per_genome
+        behaviors = []
+        for _gid, genome in genomes:
+            net = _make_net(net_class, genome, cfg, state_dim, action_dim, use_current_activs, net_kwargs)
+            episodes = [_rollout(env, net, recurrent_style, seed=s, with_behavior=True) for s in world_seeds]
+            genome.fitness = float(np.mean([reward for reward, _ in episodes]))
+            behaviors.append(np.mean([behavior for _, behavior in episodes], axis=0))
+        gen_counter[0] += 1
+        return behaviors
+
+    novelty_search = None
+    if novelty is not None:
+        if racing:
+            raise ValueError("racing and novelty cannot be combined")
+        novelty_search = neat3p.NoveltySearch(eval_genomes_with_behavior, **novelty)
+
+    nets = {}
+    race_seeds = [None]
+
+    def play_episode(genome, cfg, episode):
+        # One net per genome for the whole race; the seeds are fixed per generation.
+        if episode == 0:
+            nets[genome.key] = _make_net(net_class, genome, cfg, state_dim, action_dim, use_current_activs, net_kwargs)
+        return _rollout(env, nets[genome.key], recurrent_style, seed=race_seeds[0][episode])
+
+    def eval_genomes_racing(genomes, cfg):
+        world_seeds = _world_seeds(gen_counter[0])
+        race_seeds[0] = world_seeds if world_seeds is not None else [None] * episodes_per_genome
+        racer.evaluate(genomes, cfg)
+        nets.clear()
+        gen_counter[0] += 1
+
     pop = neat3p.Population(config)
     if verbose:
         pop.add_reporter(neat3p.StdOutReporter(True))
@@ -348,7 +401,14 @@ def run_neat_gym(
         torch.cuda.reset_peak_memory_stats()
 
     t0 = time.perf_counter()
-    winner = pop.run(eval_genomes, max_generations)
+    if racing:
+        racer = neat3p.RacingEvaluator(play_episode, episodes_per_genome, species_set=pop.species)
+        winner = pop.run(eval_genomes_racing, max_generations)
+    elif novelty_search is None:
+        winner = pop.run(eval_genomes, max_generations)
+    else:
+        pop.run(novelty_search.evaluate, max_generations)
+        winner = novelty_search.best_genome
     wall_time = time.perf_counter() - t0
 
     if progress_reporter is not None:
@@ -0,0 +1,102 @@
+#include "activations.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+Activation activation_from_name(const std::string &name) {
+    static const std::unordered_map<std::string, Activation> kNames = {
+        {"sigmoid", Activation::kSigmoid},
+        {"tanh", Activation::kTanh},
+        {"sin", Activation::kSin},
+        {"gauss", Activation::kGauss},
+        {"relu", Activation::kRelu},
+        {"elu", Activation::kElu},
+        {"lelu", Activation::kLelu},
+        {"selu", Activation::kSelu},
+        {"softplus", Activation::kSoftplus},
+        {"identity", Activation::kIdentity},
+        {"clamped", Activation::kClamped},
+        {"inv", Activation::kInv},
+        {"log", Activation::kLog},
+        {"exp", Activation::kExp},
+        {"abs", Activation::kAbs},
+        {"hat", Activation::kHat},
+        {"square", Activation::kSquare},
+        {"cube", Activation::kCube},
+    };
+    auto it = kNames.find(name);
+    if (it == kNames.end())
+        throw std::invalid_argument("No native implementation of activation '" + name + "'");
+    return it->second;
+}
+
+void apply_activation(Activation activation, float *v, size_t n) {
+    switch (activation) {
+        case Activation::kSigmoid:
+            for (size_t i = 0; i < n; i++) {
+                float z = std::clamp(5.0f * v[i], -60.0f, 60.0f);
+                v[i] = 1.0f / (1.0f + std::exp(-z));
+            }
+            break;
+        case Activation::kTanh:
+            for (size_t i = 0; i < n; i++) v[i] = std::tanh(std::clamp(2.5f * v[i], -60.0f, 60.0f));
+            break;
+        case Activation::kSin:
+            for (size_t i = 0; i < n; i++) v[i] = std::sin(std::clamp(5.0f * v[i], -60.0f, 60.0f));
+            break;
+        case Activation::kGauss:
+            for (size_t i = 0; i < n; i++) {
+                float z = std::clamp(v[i], -3.4f, 3.4f);
+                v[i] = std::exp(-5.0f * z * z);
+            }
+            break;
+        case Activation::kRelu:
+            for (size_t i = 0; i < n; i++) v[i] = v[i] > 0.0f ? v[i] : 0.0f;
+            break;
+        case Activation::kElu:
+            for (size_t i = 0; i < n; i++) v[i] = v[i] > 0.0f ? v[i] : std::exp(v[i]) - 1.0f;
+            break;
+        case Activation::kLelu:
+            for (size_t i = 0; i < n; i++) v[i] = v[i] > 0.0f ? v[i] : 0.005f * v[i];
+            break;
+        case Activation::kSelu: {
+            const float lam = 1.0507009873554804934193349852946f;
+            const float alpha = 1.6732632423543772848170429916717f;
+            for (size_t i = 0; i < n; i++)
+                v[i] = v[i] > 0.0f ? lam * v[i] : lam * alpha * (std::exp(v[i]) - 1.0f);
+            break;
+        }
+        case Activation::kSoftplus:
+            for (size_t i = 0; i < n; i++)
+                v[i] = 0.2f * std::log(1.0f + std::exp(std::clamp(5.0f * v[i], -60.0f, 60.0f)));
+            break;
+        case Activation::kIdentity:
+            break;
+        case Activation::kClamped:
+            for (size_t i = 0; i < n; i++) v[i] = std::clamp(v[i], -1.0f, 1.0f);
+            break;
+        case Activation::kInv:
+            for (size_t i = 0; i < n; i++) v[i] = v[i] != 0.0f ? 1.0f / v[i] : 0.0f;
+            break;
+        case Activation::kLog:
+            for (size_t i = 0; i < n; i++) v[i] = std::log(std::max(1e-7f, v[i]));
+            break;
+        case Activation::kExp:
+            for (size_t i = 0; i < n; i++) v[i] = std::exp(std::clamp(v[i], -60.0f, 60.0f));
+            break;
+        case Activation::kAbs:
+            for (size_t i = 0; i < n; i++) v[i] = std::fabs(v[i]);
+            break;
+        case Activation::kHat:
+            for (size_t i = 0; i < n; i++) v[i] = std::max(0.0f, 1.0f - std::fabs(v[i]));
+            break;
+        case Activation::kSquare:
+            for (size_t i = 0; i < n; i++) v[i] = v[i] * v[i];
+            break;
+        case Activation::kCube:
+            for (size_t i = 0; i < n; i++) v[i] = v[i] * v[i] * v[i];
+            break;
+    }
+}
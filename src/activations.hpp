@@ -0,0 +1,37 @@
+#ifndef ACTIVATIONS_HPP
+#define ACTIVATIONS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Built-in activation functions of neat3p/activations.py, applied in place to
+// contiguous float buffers so that the loops vectorize.
+enum class Activation : uint8_t {
+    kSigmoid,
+    kTanh,
+    kSin,
+    kGauss,
+    kRelu,
+    kElu,
+    kLelu,
+    kSelu,
+    kSoftplus,
+    kIdentity,
+    kClamped,
+    kInv,
+    kLog,
+    kExp,
+    kAbs,
+    kHat,
+    kSquare,
+    kCube,
+};
+
+// Throws std::invalid_argument for names that have no native implementation
+// (e.g. user-defined activations).
+Activation activation_from_name(const std::string &name);
+
+void apply_activation(Activation activation, float *values, size_t n);
+
+#endif  // ACTIVATIONS_HPP
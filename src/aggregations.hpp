@@ -0,0 +1,22 @@
+#ifndef AGGREGATIONS_HPP
+#define AGGREGATIONS_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Built-in aggregation functions of neat3p/aggregations.py that have a native
+// implementation. Median is not supported.
+enum class Aggregation : uint8_t { kSum, kProduct, kMax, kMin, kMaxAbs, kMean };
+
+inline Aggregation aggregation_from_name(const std::string &name) {
+    if (name == "sum") return Aggregation::kSum;
+    if (name == "product") return Aggregation::kProduct;
+    if (name == "max") return Aggregation::kMax;
+    if (name == "min") return Aggregation::kMin;
+    if (name == "maxabs") return Aggregation::kMaxAbs;
+    if (name == "mean") return Aggregation::kMean;
+    throw std::invalid_argument("No native implementation of aggregation '" + name + "'");
+}
+
+#endif  // AGGREGATIONS_HPP
@@ -1,50 +1,52 @@
 #ifndef ATTRIBUTES_HPP
 #define ATTRIBUTES_HPP
 
-#include <nanobind/nanobind.h>
-#include <nanobind/stl/map.h>
-#include <nanobind/stl/string.h>
-#include <nanobind/stl/vector.h>
-
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <random>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
-#include "config.hpp"  // added to access ConfigParameter
+namespace neat3p {
 
-namespace nb = nanobind;
+// Random engine shared by the attribute samplers and the genome operators.
+// Each thread owns its engine; seed() reseeds the calling thread's engine.
+inline std::mt19937 &random_engine() {
+    thread_local std::mt19937 gen(std::random_device{}());
+    return gen;
+}
 
-namespace neat3p {
+inline void seed(uint32_t value) { random_engine().seed(value); }
 
 // A simple config struct holding attribute parameters.
 struct AttributeConfig {
     // FloatAttribute parameters
-    double init_mean;
-    double init_stdev;
-    std::string init_type;
-    double replace_rate_f;
-    double mutate_rate_f;
-    double mutate_power_f;
-    double max_value_f;
-    double min_value_f;
+    double init_mean = 0.0;
+    double init_stdev = 1.0;
+    std::string init_type = "gaussian";
+    double replace_rate_f = 0.0;
+    double mutate_rate_f = 0.0;
+    double mutate_power_f = 0.0;
+    double max_value_f = 0.0;
+    double min_value_f = 0.0;
     // IntegerAttribute parameters
-    double mutate_rate_i;
-    double mutate_power_i;
-    int replace_rate_i;  // use int for simplicity
-    int max_value_i;
-    int min_value_i;
+    double mutate_rate_i = 0.0;
+    double mutate_power_i = 0.0;
+    int replace_rate_i = 0;  // use int for simplicity
+    int max_value_i = 0;
+    int min_value_i = 0;
     // BoolAttribute parameters
-    std::string default_bool;
-    double mutate_rate_b;
-    double rate_to_true_add;
-    double rate_to_false_add;
+    std::string default_bool = "true";
+    double mutate_rate_b = 0.0;
+    double rate_to_true_add = 0.0;
+    double rate_to_false_add = 0.0;
     // StringAttribute parameters
-    std::string default_str;
+    std::string default_str = "random";
     std::vector<std::string> options;
-    double mutate_rate_s;
+    double mutate_rate_s = 0.0;
 };
 
 class BaseAttribute {
@@ -58,17 +60,6 @@ class BaseAttribute {
     std::unordered_map<std::string, std::string> _config_item_names;
 
    public:
-    // New: Helper to convert nb::dict to std::unordered_map
-    static std::unordered_map<std::string, std::string> convert_dict(const nb::dict &d) {
-        std::unordered_map<std::string, std::string> res;
-        for (auto item : d) {
-            std::string key = nb::cast<std::string>(item.first);
-            std::string value = nb::cast<std::string>(item.second);
-            res[key] = value;
-        }
-        return res;
-    }
-
     // Modified constructor accepting a std::unordered_map
     BaseAttribute(const std::string &name,
                   const std::unordered_map<std::string, std::string> &default_dict = {})
@@ -86,38 +77,23 @@ class BaseAttribute {
         }
     }
 
-    // New: Overloaded constructor receiving nb::dict
-    BaseAttribute(const std::string &name, const nb::dict &default_dict)
-        : BaseAttribute(name, convert_dict(default_dict)) {}
-
     virtual ~BaseAttribute() = default;
 
     std::string config_item_name(const std::string &config_item_base_name) const {
         return name + "_" + config_item_base_name;
-    }
-
-    // NEW: Provide a get_config_params method
-    virtual std::vector<ConfigParameter> get_config_params() const {
-        return {};  // return empty vector by default
-    }
-};
+    }};
 
 class FloatAttribute : public BaseAttribute {
    public:
     // Existing constructor.
     FloatAttribute(const std::string &name) : BaseAttribute(name) {}
-    // NEW: Additional constructor overload with nb::dict.
-    FloatAttribute(const std::string &name, const nb::dict &default_dict)
-        : BaseAttribute(name, default_dict) {}
 
     double clamp(double value, const AttributeConfig &config) const {
         return std::max(std::min(value, config.max_value_f), config.min_value_f);
     }
 
     double init_value(const AttributeConfig &config) const {
-        // Use a simple random engine
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+        auto &gen = random_engine();
         if (config.init_type.find("gauss") != std::string::npos ||
             config.init_type.find("normal") != std::string::npos) {
             std::normal_distribution<> d(config.init_mean, config.init_stdev);
@@ -133,8 +109,7 @@ class FloatAttribute : public BaseAttribute {
     }
 
     double mutate_value(double value, const AttributeConfig &config) const {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+        auto &gen = random_engine();
         std::uniform_real_distribution<> dist(0.0, 1.0);
         double r = dist(gen);
         if (r < config.mutate_rate_f) {
@@ -150,35 +125,24 @@ class FloatAttribute : public BaseAttribute {
     void validate(const AttributeConfig &config) const {
         if (config.max_value_f < config.min_value_f)
             throw std::runtime_error("Invalid min/max configuration for " + name);
-    }
-
-    // NEW: Implement get_config_params (customize as needed)
-    std::vector<ConfigParameter> get_config_params() const override {
-        // For now, return an empty vector.
-        return {};
-    }
-};
+    }};
 
 class IntegerAttribute : public BaseAttribute {
    public:
     IntegerAttribute(const std::string &name) : BaseAttribute(name) {}
-    IntegerAttribute(const std::string &name, const nb::dict &default_dict)
-        : BaseAttribute(name, default_dict) {}
 
     int clamp(int value, const AttributeConfig &config) const {
         return std::max(std::min(value, config.max_value_i), config.min_value_i);
     }
 
     int init_value(const AttributeConfig &config) const {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+        auto &gen = random_engine();
         std::uniform_int_distribution<> d(config.min_value_i, config.max_value_i);
         return d(gen);
     }
 
     int mutate_value(int value, const AttributeConfig &config) const {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+        auto &gen = random_engine();
         std::uniform_real_distribution<> dist(0.0, 1.0);
         double r = dist(gen);
         if (r < config.mutate_rate_i) {
@@ -194,17 +158,11 @@ class IntegerAttribute : public BaseAttribute {
     void validate(const AttributeConfig &config) const {
         if (config.max_value_i < config.min_value_i)
             throw std::runtime_error("Invalid min/max configuration for " + name);
-    }
-
-    // NEW: Implement get_config_params
-    std::vector<ConfigParameter> get_config_params() const override { return {}; }
-};
+    }};
 
 class BoolAttribute : public BaseAttribute {
    public:
     BoolAttribute(const std::string &name) : BaseAttribute(name) {}
-    BoolAttribute(const std::string &name, const nb::dict &default_dict)
-        : BaseAttribute(name, default_dict) {}
 
     bool init_value(const AttributeConfig &config) const {
         std::string def = config.default_bool;
@@ -212,8 +170,7 @@ class BoolAttribute : public BaseAttribute {
         if (def == "1" || def == "on" || def == "yes" || def == "true") return true;
         if (def == "0" || def == "off" || def == "no" || def == "false") return false;
         if (def == "random" || def == "none") {
-            static std::random_device rd;
-            static std::mt19937 gen(rd());
+            auto &gen = random_engine();
             std::uniform_real_distribution<> dist(0.0, 1.0);
             return dist(gen) < 0.5;
         }
@@ -221,8 +178,7 @@ class BoolAttribute : public BaseAttribute {
     }
 
     bool mutate_value(bool value, const AttributeConfig &config) const {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+        auto &gen = random_engine();
         double r = std::uniform_real_distribution<>(0.0, 1.0)(gen);
         double rate = config.mutate_rate_b;
         rate += (value ? config.rate_to_false_add : config.rate_to_true_add);
@@ -238,17 +194,11 @@ class BoolAttribute : public BaseAttribute {
         if (!(def == "1" || def == "on" || def == "yes" || def == "true" || def == "0" ||
               def == "off" || def == "no" || def == "false" || def == "random" || def == "none"))
             throw std::runtime_error("Invalid default value for " + name);
-    }
-
-    // NEW: Implement get_config_params
-    std::vector<ConfigParameter> get_config_params() const override { return {}; }
-};
+    }};
 
 class StringAttribute : public BaseAttribute {
    public:
     StringAttribute(const std::string &name) : BaseAttribute(name) {}
-    StringAttribute(const std::string &name, const nb::dict &default_dict)
-        : BaseAttribute(name, default_dict) {}
 
     std::string init_value(const AttributeConfig &config) const {
         std::string def = config.default_str;
@@ -256,8 +206,7 @@ class StringAttribute : public BaseAttribute {
         std::transform(low.begin(), low.end(), low.begin(), ::tolower);
         if (low == "none" || low == "random") {
             if (config.options.empty()) throw std::runtime_error("No options provided for " + name);
-            static std::random_device rd;
-            static std::mt19937 gen(rd());
+            auto &gen = random_engine();
             std::uniform_int_distribution<> d(0, config.options.size() - 1);
             return config.options[d(gen)];
         }
@@ -265,8 +214,7 @@ class StringAttribute : public BaseAttribute {
     }
 
     std::string mutate_value(const std::string &value, const AttributeConfig &config) const {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
+        auto &gen = random_engine();
         if (config.mutate_rate_s > 0 &&
             std::uniform_real_distribution<>(0.0, 1.0)(gen) < config.mutate_rate_s) {
             if (config.options.empty()) throw std::runtime_error("No options provided for " + name);
@@ -283,11 +231,7 @@ class StringAttribute : public BaseAttribute {
             if (it == config.options.end())
                 throw std::runtime_error("Invalid initial value " + def + " for " + name);
         }
-    }
-
-    // NEW: Implement get_config_params
-    std::vector<ConfigParameter> get_config_params() const override { return {}; }
-};
+    }};
 
 }  // namespace neat3p
 
@@ -0,0 +1,165 @@
+#include "connectivity.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "graphs.hpp"
+
+namespace {
+
+enum NodeKind { kInputNode, kHiddenNode, kOutputNode };
+
+struct NodeIndex {
+    NodeKind kind;
+    int32_t index;
+};
+
+std::string invalid_connection(const std::pair<int, int> &key) {
+    return "Invalid connection from key " + std::to_string(key.first) + " to key " +
+           std::to_string(key.second);
+}
+
+size_t node_row(const DefaultGenome &genome, int key) {
+    std::ptrdiff_t row = genome.nodes.find(key);
+    if (row < 0) throw std::out_of_range("node " + std::to_string(key) + " not in genome");
+    return static_cast<size_t>(row);
+}
+
+}  // namespace
+
+RecurrentConnectivity recurrent_connectivity(const DefaultGenome &genome,
+                                             const std::vector<int> &input_keys,
+                                             const std::vector<int> &output_keys,
+                                             bool prune_empty) {
+    const NodeGeneTable &nodes = genome.nodes;
+    const ConnectionGeneTable &conns = genome.connections;
+    RecurrentConnectivity out;
+
+    std::unordered_map<int, NodeIndex> index;
+    for (size_t i = 0; i < input_keys.size(); i++)
+        index.emplace(input_keys[i], NodeIndex{kInputNode, static_cast<int32_t>(i)});
+    std::unordered_set<int> outputs(output_keys.begin(), output_keys.end());
+    for (int key : nodes.keys) {
+        if (outputs.count(key)) continue;
+        index.emplace(key, NodeIndex{kHiddenNode, static_cast<int32_t>(out.hidden_keys.size())});
+        out.hidden_keys.push_back(key);
+    }
+    for (size_t i = 0; i < output_keys.size(); i++)
+        index.emplace(output_keys[i], NodeIndex{kOutputNode, static_cast<int32_t>(i)});
+
+    out.num_inputs = static_cast<int>(input_keys.size());
+    out.num_hidden = static_cast<int>(out.hidden_keys.size());
+    out.num_outputs = static_cast<int>(output_keys.size());
+
+    out.hidden_biases.reserve(out.hidden_keys.size());
+    out.hidden_responses.reserve(out.hidden_keys.size());
+    for (int key : out.hidden_keys) {
+        size_t row = node_row(genome, key);
+        out.hidden_rows.push_back(static_cast<int32_t>(row));
+        out.hidden_biases.push_back(nodes.bias[row]);
+        out.hidden_responses.push_back(nodes.response[row]);
+    }
+
+    std::unordered_set<int> nonempty;
+    if (prune_empty) {
+        nonempty.insert(input_keys.begin(), input_keys.end());
+        for (size_t c = 0; c < conns.size(); c++)
+            if (conns.enabled[c]) nonempty.insert(conns.keys[c].second);
+    }
+
+    out.output_biases.reserve(output_keys.size());
+    out.output_responses.reserve(output_keys.size());
+    for (int key : output_keys) {
+        size_t row = node_row(genome, key);
+        bool empty = prune_empty && !nonempty.count(key);
+        out.output_rows.push_back(static_cast<int32_t>(row));
+        out.output_bias_mask.push_back(empty ? 0.0f : 1.0f);
+        out.output_biases.push_back(empty ? 0.0f : nodes.bias[row]);
+        out.output_responses.push_back(nodes.response[row]);
+    }
+
+    std::unordered_set<int> required = required_for_output(input_keys, output_keys, conns.keys);
+
+    // First pass assigns every kept connection to its block, second pass
+    // scatters it into place, so blocks come out contiguous in one allocation.
+    std::vector<int8_t> block_of(conns.size(), -1);
+    std::array<int32_t, kNumRecurrentBlocks> counts{};
+    for (size_t c = 0; c < conns.size(); c++) {
+        if (!conns.enabled[c]) continue;
+        const auto &key = conns.keys[c];
+        if (!required.count(key.first) && !required.count(key.second)) continue;
+        if (prune_empty && !nonempty.count(key.first)) continue;
+
+        auto in = index.find(key.first);
+        auto on = index.find(key.second);
+        if (in == index.end() || on == index.end() || on->second.kind == kInputNode)
+            throw std::invalid_argument(invalid_connection(key));
+        int block = (on->second.kind == kOutputNode ? kInputToOutput : kInputToHidden) +
+                    static_cast<int>(in->second.kind);
+        block_of[c] = static_cast<int8_t>(block);
+        counts[block]++;
+    }
+
+    for (int b = 0; b < kNumRecurrentBlocks; b++)
+        out.block_offsets[b + 1] = out.block_offsets[b] + counts[b];
+    int32_t nnz = out.block_offsets[kNumRecurrentBlocks];
+    out.coo.resize(2 * static_cast<size_t>(nnz));
+    out.weights.resize(nnz);
+    out.connection_rows.resize(nnz);
+
+    std::array<int32_t, kNumRecurrentBlocks> cursor;
+    std::copy(out.block_offsets.begin(), out.block_offsets.end() - 1, cursor.begin());
+    for (size_t c = 0; c < conns.size(); c++) {
+        if (block_of[c] < 0) continue;
+        int32_t pos = cursor[block_of[c]]++;
+        out.coo[2 * pos] = index.at(conns.keys[c].second).index;
+        out.coo[2 * pos + 1] = index.at(conns.keys[c].first).index;
+        out.weights[pos] = conns.weight[c];
+        out.connection_rows[pos] = static_cast<int32_t>(c);
+    }
+    return out;
+}
+
+FeedForwardConnectivity feed_forward_connectivity(const DefaultGenome &genome,
+                                                  const std::vector<int> &input_keys,
+                                                  const std::vector<int> &output_keys) {
+    const NodeGeneTable &nodes = genome.nodes;
+    const ConnectionGeneTable &conns = genome.connections;
+    FeedForwardConnectivity out;
+
+    std::vector<std::pair<int, int>> enabled;
+    std::vector<int32_t> enabled_rows;
+    for (size_t c = 0; c < conns.size(); c++) {
+        if (!conns.enabled[c]) continue;
+        enabled.push_back(conns.keys[c]);
+        enabled_rows.push_back(static_cast<int32_t>(c));
+    }
+
+    std::unordered_map<int, std::vector<size_t>> incoming;
+    for (size_t c = 0; c < enabled.size(); c++) incoming[enabled[c].second].push_back(c);
+
+    out.layer_offsets.push_back(0);
+    out.indptr.push_back(0);
+    for (const std::vector<int> &layer : feed_forward_layers(input_keys, output_keys, enabled)) {
+        for (int key : layer) {
+            size_t row = node_row(genome, key);
+            out.node_keys.push_back(key);
+            out.node_rows.push_back(static_cast<int32_t>(row));
+            out.biases.push_back(nodes.bias[row]);
+            out.responses.push_back(nodes.response[row]);
+            out.activations.push_back(nodes.activation[row]);
+            out.aggregations.push_back(nodes.aggregation[row]);
+            for (size_t c : incoming[key]) {
+                out.indices.push_back(enabled[c].first);
+                out.weights.push_back(conns.weight[enabled_rows[c]]);
+                out.connection_rows.push_back(enabled_rows[c]);
+            }
+            out.indptr.push_back(static_cast<int32_t>(out.indices.size()));
+        }
+        out.layer_offsets.push_back(static_cast<int32_t>(out.node_keys.size()));
+    }
+    return out;
+}
@@ -0,0 +1,88 @@
+#ifndef CONNECTIVITY_HPP
+#define CONNECTIVITY_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "genome.hpp"
+
+// Flat, index-based descriptions of a genome's network in the layouts built by
+// the torch phenotypes (neat3p/nn/phenotypes). Every field is a contiguous
+// array so the bindings can hand it to torch without copying.
+
+// Connection blocks of RecurrentNet, in storage order.
+enum RecurrentBlock {
+    kInputToHidden,
+    kHiddenToHidden,
+    kOutputToHidden,
+    kInputToOutput,
+    kHiddenToOutput,
+    kOutputToOutput,
+    kNumRecurrentBlocks,
+};
+
+struct RecurrentConnectivity {
+    int num_inputs = 0;
+    int num_hidden = 0;
+    int num_outputs = 0;
+
+    // Hidden nodes are every non-output node, in key order.
+    std::vector<int32_t> hidden_keys;
+    std::vector<float> hidden_biases;
+    std::vector<float> hidden_responses;
+    std::vector<float> output_biases;
+    std::vector<float> output_responses;
+
+    // Enabled connections as (row, col) = (destination, source) pairs, indexed
+    // within their block. Block b holds entries [block_offsets[b], block_offsets[b + 1]).
+    std::vector<int32_t> coo;
+    std::vector<float> weights;
+    std::array<int32_t, kNumRecurrentBlocks + 1> block_offsets{};
+
+    // Where every value above was read from, so that a genome with the same
+    // topology can refill them without redoing the analysis: rows of the node
+    // table for the hidden and output nodes, rows of the connection table for
+    // each COO entry. output_bias_mask is 0 for biases zeroed by prune_empty.
+    std::vector<int32_t> hidden_rows;
+    std::vector<int32_t> output_rows;
+    std::vector<float> output_bias_mask;
+    std::vector<int32_t> connection_rows;
+};
+
+// Partitions the genome the way RecurrentNet.create does. With prune_empty,
+// connections leaving nodes that have no enabled input are dropped and outputs
+// without enabled inputs get a zero bias.
+RecurrentConnectivity recurrent_connectivity(const DefaultGenome &genome,
+                                             const std::vector<int> &input_keys,
+                                             const std::vector<int> &output_keys,
+                                             bool prune_empty);
+
+struct FeedForwardConnectivity {
+    // Nodes in evaluation order; layer l is [layer_offsets[l], layer_offsets[l + 1]).
+    std::vector<int32_t> node_keys;
+    std::vector<int32_t> layer_offsets;
+    std::vector<float> biases;
+    std::vector<float> responses;
+    std::vector<std::string> activations;
+    std::vector<std::string> aggregations;
+
+    // Incoming enabled links in CSR form: node_keys[i] reads the source keys
+    // indices[indptr[i]:indptr[i + 1]] scaled by the matching weights.
+    std::vector<int32_t> indptr;
+    std::vector<int32_t> indices;
+    std::vector<float> weights;
+
+    // Node table rows of node_keys and connection table rows of the links, for
+    // refilling the parameters from a genome with the same topology.
+    std::vector<int32_t> node_rows;
+    std::vector<int32_t> connection_rows;
+};
+
+// Evaluation order and incoming links used by TorchFeedForwardNetwork.create.
+FeedForwardConnectivity feed_forward_connectivity(const DefaultGenome &genome,
+                                                  const std::vector<int> &input_keys,
+                                                  const std::vector<int> &output_keys);
+
+#endif  // CONNECTIVITY_HPP
@@ -0,0 +1,353 @@
+#ifndef COW_VECTOR_HPP
+#define COW_VECTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Bytes of elements (sizeof(T) each) copied by every CowVector so far, whether
+// to detach a block for writing or to assemble a contiguous view.
+inline std::atomic<std::uint64_t> cow_copied_bytes{0};
+
+// ---------------------------------------------------------------------------
+// CowVector: a vector stored as fixed-size blocks of kBlockSize elements, each
+// shared by reference count between copies and copied only when one of them
+// writes to it.
+//
+// Reads go through the const interface and never copy. set() skips writes that
+// would not change the element and otherwise copies just the block it writes
+// to, so a mutation pass that touches a few genes leaves the other blocks
+// shared with the parent. insert() and erase() rebuild the blocks from the
+// edited row onward; the blocks before it stay shared.
+//
+// data(), get() and snapshot() need the elements contiguous. They assemble a
+// buffer from the blocks on first use and cache it until the next write; copies
+// share the cached buffer along with the blocks. The cache is filled from
+// const methods, so concurrent reads of one vector need external locking.
+// snapshot() keeps the buffer alive, and unchanged, across later writes.
+//
+// pin() hands out a mutable pointer for use outside this object's control
+// (e.g. a writable NumPy view). The buffer is then the only copy of the
+// elements and is owned by this vector alone: copies of a pinned vector are
+// deep, so writes through the pointer only ever reach this vector. Resizing
+// would move the elements away from the pointer, so insert(), erase() and the
+// like throw std::runtime_error while pinned. Once the last pin is released
+// the buffer is shared by copies like blocks are, and the first write splits it
+// back into blocks.
+// ---------------------------------------------------------------------------
+template <typename T>
+class CowVector {
+   public:
+    static constexpr size_t kBlockSize = 64;
+
+    using value_type = T;
+
+    // Random-access iterator over the elements, addressed by index so that it
+    // works across block boundaries.
+    class const_iterator {
+       public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+        const_iterator(const CowVector *vector, size_t index) : vector_(vector), index_(index) {}
+
+        reference operator*() const { return (*vector_)[index_]; }
+        pointer operator->() const { return &(*vector_)[index_]; }
+        reference operator[](difference_type n) const { return (*vector_)[index_ + n]; }
+
+        const_iterator &operator++() { return *this += 1; }
+        const_iterator &operator--() { return *this -= 1; }
+        const_iterator operator++(int) { return std::exchange(*this, *this + 1); }
+        const_iterator operator--(int) { return std::exchange(*this, *this - 1); }
+        const_iterator &operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+        const_iterator &operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+
+        friend const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+        friend const_iterator operator+(difference_type n, const_iterator it) { return it += n; }
+        friend const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const const_iterator &a, const const_iterator &b) {
+            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+        }
+        friend bool operator==(const const_iterator &a, const const_iterator &b) {
+            return a.index_ == b.index_;
+        }
+        friend std::strong_ordering operator<=>(const const_iterator &a, const const_iterator &b) {
+            return a.index_ <=> b.index_;
+        }
+
+       private:
+        const CowVector *vector_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    CowVector() = default;
+    CowVector(const std::vector<T> &values) { assign_blocks(0, values.begin(), values.end()); }
+
+    CowVector(const CowVector &other) { copy_from(other); }
+    CowVector(CowVector &&other) noexcept { swap(other); }
+
+    CowVector &operator=(const CowVector &other) {
+        if (this != &other) {
+            CowVector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    CowVector &operator=(CowVector &&other) noexcept {
+        if (this != &other) {
+            CowVector moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    // Read access; never copies.
+    const T &operator[](size_t i) const {
+        if (flat_) return view_->values[i];
+        return (*blocks_[i / kBlockSize])[i % kBlockSize];
+    }
+    const T &back() const { return (*this)[size() - 1]; }
+    size_t size() const { return flat_ ? view_->values.size() : size_; }
+    bool empty() const { return size() == 0; }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // Contiguous access, assembling the cached buffer if there is none.
+    const T *data() const { return view().values.data(); }
+    const std::vector<T> &get() const { return view().values; }
+    operator const std::vector<T> &() const { return view().values; }
+
+    void set(size_t i, const T &value) {
+        if ((*this)[i] == value) return;
+        if (flat_ && pinned()) {
+            view_->values[i] = value;
+            return;
+        }
+        thaw();
+        std::vector<T> &block = detach_block(i / kBlockSize);
+        block[i % kBlockSize] = value;
+        // Keep the cached buffer current if nothing else can see it.
+        if (view_ && view_.use_count() == 1)
+            view_->values[i] = value;
+        else
+            view_.reset();
+    }
+
+    void insert(size_t row, const T &value) {
+        check_unpinned();
+        std::vector<T> tail = take_tail(row);
+        tail.insert(tail.begin() + (row % kBlockSize), value);
+        assign_tail(row / kBlockSize, std::move(tail));
+    }
+
+    void push_back(const T &value) {
+        check_unpinned();
+        thaw();
+        view_.reset();
+        if (size_ % kBlockSize == 0) {
+            blocks_.push_back(std::make_shared<std::vector<T>>());
+            blocks_.back()->reserve(kBlockSize);
+        }
+        detach_block(blocks_.size() - 1).push_back(value);
+        size_++;
+    }
+
+    void erase(size_t row) {
+        check_unpinned();
+        std::vector<T> tail = take_tail(row);
+        tail.erase(tail.begin() + (row % kBlockSize));
+        assign_tail(row / kBlockSize, std::move(tail));
+    }
+
+    // Removes every row whose flag in `remove` (one per row) is set.
+    void erase_rows(const std::vector<bool> &remove) {
+        check_unpinned();
+        size_t first = 0;
+        while (first < remove.size() && !remove[first]) first++;
+        if (first == remove.size()) return;
+        std::vector<T> tail = take_tail(first);
+        size_t out = 0;
+        for (size_t i = 0; i < tail.size(); i++)
+            if (!remove[first / kBlockSize * kBlockSize + i]) tail[out++] = std::move(tail[i]);
+        tail.resize(out);
+        assign_tail(first / kBlockSize, std::move(tail));
+    }
+
+    void reserve(size_t n) {
+        check_unpinned();
+        blocks_.reserve((n + kBlockSize - 1) / kBlockSize);
+    }
+
+    void clear() {
+        check_unpinned();
+        blocks_.clear();
+        size_ = 0;
+        view_.reset();
+        flat_ = false;
+    }
+
+    // The current elements, kept alive (and unchanged) by the returned pointer.
+    std::shared_ptr<const std::vector<T>> snapshot() const {
+        std::shared_ptr<Storage> storage =
+            pinned() ? std::make_shared<Storage>(copy_values(view_->values)) : view_ptr();
+        return std::shared_ptr<const std::vector<T>>(storage, &storage->values);
+    }
+
+    // Mutable pointer to the elements, valid while the returned pointer is
+    // alive; the vector cannot be resized until then.
+    std::shared_ptr<T> pin() {
+        if (!flat_) {
+            view_ptr();
+            blocks_.clear();
+            size_ = 0;
+            flat_ = true;
+        }
+        // Pins hold a reference each; any other reference is another vector or
+        // a snapshot.
+        if (view_.use_count() - view_->pins.load() > 1)
+            view_ = std::make_shared<Storage>(copy_values(view_->values));
+        view_->pins++;
+        std::shared_ptr<Storage> storage = view_;
+        return std::shared_ptr<T>(storage->values.data(), [storage](T *) { storage->pins--; });
+    }
+
+    bool pinned() const { return flat_ && view_->pins.load() > 0; }
+
+    // Whether both vectors currently share all their storage.
+    bool shares_with(const CowVector &other) const {
+        if (flat_ || other.flat_) return flat_ && other.flat_ && view_ == other.view_;
+        return size_ == other.size_ && blocks_ == other.blocks_;
+    }
+
+   private:
+    struct Storage {
+        Storage() = default;
+        explicit Storage(std::vector<T> values) : values(std::move(values)) {}
+        std::vector<T> values;
+        std::atomic<long> pins{0};
+    };
+
+    void swap(CowVector &other) noexcept {
+        std::swap(blocks_, other.blocks_);
+        std::swap(size_, other.size_);
+        std::swap(view_, other.view_);
+        std::swap(flat_, other.flat_);
+    }
+
+    void copy_from(const CowVector &other) {
+        if (other.pinned()) {
+            const std::vector<T> &values = other.view_->values;
+            cow_copied_bytes += values.size() * sizeof(T);
+            assign_blocks(0, values.begin(), values.end());
+        }
+        else if (other.flat_) {
+            view_ = other.view_;
+            flat_ = true;
+        }
+        else {
+            blocks_ = other.blocks_;
+            size_ = other.size_;
+            view_ = other.view_;
+        }
+    }
+
+    static std::vector<T> copy_values(const std::vector<T> &values) {
+        cow_copied_bytes += values.size() * sizeof(T);
+        return values;
+    }
+
+    // The cached buffer, assembled from the blocks if there is none.
+    const std::shared_ptr<Storage> &view_ptr() const {
+        if (!view_) {
+            std::vector<T> values;
+            values.reserve(size_);
+            for (const auto &block : blocks_)
+                values.insert(values.end(), block->begin(), block->end());
+            cow_copied_bytes += values.size() * sizeof(T);
+            view_ = std::make_shared<Storage>(std::move(values));
+        }
+        return view_;
+    }
+    const Storage &view() const { return *view_ptr(); }
+
+    // Splits an unpinned buffer back into blocks; it stays cached, since the
+    // elements are the same.
+    void thaw() {
+        if (!flat_) return;
+        flat_ = false;
+        const std::vector<T> &values = view_->values;
+        std::shared_ptr<Storage> keep = view_;
+        cow_copied_bytes += values.size() * sizeof(T);
+        assign_blocks(0, values.begin(), values.end());
+        view_ = std::move(keep);
+    }
+
+    std::vector<T> &detach_block(size_t b) {
+        if (blocks_[b].use_count() > 1) {
+            cow_copied_bytes += blocks_[b]->size() * sizeof(T);
+            blocks_[b] = std::make_shared<std::vector<T>>(*blocks_[b]);
+        }
+        return *blocks_[b];
+    }
+
+    // Copies the elements from the start of the block holding `row` onward.
+    std::vector<T> take_tail(size_t row) {
+        thaw();
+        std::vector<T> tail;
+        for (size_t b = row / kBlockSize; b < blocks_.size(); b++)
+            tail.insert(tail.end(), blocks_[b]->begin(), blocks_[b]->end());
+        cow_copied_bytes += tail.size() * sizeof(T);
+        return tail;
+    }
+
+    // Replaces the blocks from `first_block` onward with [begin, end).
+    template <typename It>
+    void assign_blocks(size_t first_block, It begin, It end) {
+        blocks_.resize(first_block);
+        size_ = first_block * kBlockSize;
+        while (begin != end) {
+            It stop = begin + std::min<std::ptrdiff_t>(kBlockSize, end - begin);
+            auto block = std::make_shared<std::vector<T>>(begin, stop);
+            block->reserve(kBlockSize);
+            size_ += block->size();
+            blocks_.push_back(std::move(block));
+            begin = stop;
+        }
+        view_.reset();
+    }
+
+    void assign_tail(size_t first_block, std::vector<T> tail) {
+        assign_blocks(first_block, std::make_move_iterator(tail.begin()),
+                      std::make_move_iterator(tail.end()));
+    }
+
+    void check_unpinned() const {
+        if (pinned())
+            throw std::runtime_error(
+                "cannot resize a gene column while a writable view of it is alive");
+    }
+
+    std::vector<std::shared_ptr<std::vector<T>>> blocks_;  // all full except the last
+    size_t size_ = 0;
+    mutable std::shared_ptr<Storage> view_;  // the cached buffer; all elements while flat_
+    bool flat_ = false;
+};
+
+#endif  // COW_VECTOR_HPP
@@ -0,0 +1,274 @@
+#include "distance_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+namespace {
+
+// Same per-gene formulas as DefaultGenome::distance, without the weight
+// coefficient.
+double node_gene_distance(float bias1, float response1, const std::string &activation1,
+                          const std::string &aggregation1, const NodeGeneTable &nodes,
+                          size_t row) {
+    double d = std::abs(bias1 - nodes.bias[row]) + std::abs(response1 - nodes.response[row]);
+    if (activation1 != nodes.activation[row]) d += 1.0;
+    if (aggregation1 != nodes.aggregation[row]) d += 1.0;
+    return d;
+}
+
+double connection_gene_distance(float weight1, uint8_t enabled1,
+                                const ConnectionGeneTable &connections, size_t row) {
+    double d = std::abs(weight1 - connections.weight[row]);
+    if (enabled1 != connections.enabled[row]) d += 1.0;
+    return d;
+}
+
+uint64_t pair_key(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+}  // namespace
+
+double DistanceTerms::distance(const DefaultGenome &a, const DefaultGenome &b,
+                               const DefaultGenomeConfig &config) const {
+    double d = 0.0;
+    const size_t max_nodes = std::max(a.nodes.size(), b.nodes.size());
+    if (max_nodes > 0)
+        d += (node_sum * config.compatibility_weight_coefficient +
+              config.compatibility_disjoint_coefficient * static_cast<double>(node_disjoint)) /
+             static_cast<double>(max_nodes);
+    const size_t max_connections = std::max(a.connections.size(), b.connections.size());
+    if (max_connections > 0)
+        d += (connection_sum * config.compatibility_weight_coefficient +
+              config.compatibility_disjoint_coefficient *
+                  static_cast<double>(connection_disjoint)) /
+             static_cast<double>(max_connections);
+    return d;
+}
+
+DistanceTerms distance_terms(const DefaultGenome &a, const DefaultGenome &b) {
+    DistanceTerms t;
+    size_t i = 0, j = 0;
+    while (i < a.nodes.size() && j < b.nodes.size()) {
+        if (a.nodes.keys[i] < b.nodes.keys[j]) {
+            t.node_disjoint++;
+            i++;
+        }
+        else if (b.nodes.keys[j] < a.nodes.keys[i]) {
+            t.node_disjoint++;
+            j++;
+        }
+        else {
+            t.node_sum += node_gene_distance(a.nodes.bias[i], a.nodes.response[i],
+                                             a.nodes.activation[i], a.nodes.aggregation[i],
+                                             b.nodes, j);
+            i++;
+            j++;
+        }
+    }
+    t.node_disjoint += static_cast<int64_t>((a.nodes.size() - i) + (b.nodes.size() - j));
+
+    i = j = 0;
+    while (i < a.connections.size() && j < b.connections.size()) {
+        if (a.connections.keys[i] < b.connections.keys[j]) {
+            t.connection_disjoint++;
+            i++;
+        }
+        else if (b.connections.keys[j] < a.connections.keys[i]) {
+            t.connection_disjoint++;
+            j++;
+        }
+        else {
+            t.connection_sum += connection_gene_distance(
+                a.connections.weight[i], a.connections.enabled[i], b.connections, j);
+            i++;
+            j++;
+        }
+    }
+    t.connection_disjoint +=
+        static_cast<int64_t>((a.connections.size() - i) + (b.connections.size() - j));
+    return t;
+}
+
+GenomeEdit genome_edit(const DefaultGenome &child, const DefaultGenome &parent) {
+    GenomeEdit edit;
+    edit.parent = parent.key;
+
+    const NodeGeneTable &cn = child.nodes;
+    const NodeGeneTable &pn = parent.nodes;
+    auto parent_node = [&](size_t j, std::ptrdiff_t child_row) {
+        edit.nodes.push_back({pn.keys[j], true, child_row, pn.bias[j], pn.response[j],
+                              pn.activation[j], pn.aggregation[j]});
+        if (child_row < 0) edit.structural++;
+    };
+    auto child_only_node = [&](size_t i) {
+        edit.nodes.push_back(
+            {cn.keys[i], false, static_cast<std::ptrdiff_t>(i), 0.0f, 0.0f, {}, {}});
+        edit.structural++;
+    };
+    size_t i = 0, j = 0;
+    while (i < cn.size() && j < pn.size()) {
+        if (cn.keys[i] < pn.keys[j]) {
+            child_only_node(i++);
+        }
+        else if (pn.keys[j] < cn.keys[i]) {
+            parent_node(j++, -1);
+        }
+        else {
+            if (cn.bias[i] != pn.bias[j] || cn.response[i] != pn.response[j] ||
+                cn.activation[i] != pn.activation[j] || cn.aggregation[i] != pn.aggregation[j])
+                parent_node(j, static_cast<std::ptrdiff_t>(i));
+            i++;
+            j++;
+        }
+    }
+    while (i < cn.size()) child_only_node(i++);
+    while (j < pn.size()) parent_node(j++, -1);
+
+    const ConnectionGeneTable &cc = child.connections;
+    const ConnectionGeneTable &pc = parent.connections;
+    auto parent_connection = [&](size_t j, std::ptrdiff_t child_row) {
+        edit.connections.push_back({pc.keys[j], true, child_row, pc.weight[j], pc.enabled[j]});
+        if (child_row < 0) edit.structural++;
+    };
+    auto child_only_connection = [&](size_t i) {
+        edit.connections.push_back({cc.keys[i], false, static_cast<std::ptrdiff_t>(i), 0.0f, 0});
+        edit.structural++;
+    };
+    i = j = 0;
+    while (i < cc.size() && j < pc.size()) {
+        if (cc.keys[i] < pc.keys[j]) {
+            child_only_connection(i++);
+        }
+        else if (pc.keys[j] < cc.keys[i]) {
+            parent_connection(j++, -1);
+        }
+        else {
+            if (cc.weight[i] != pc.weight[j] || cc.enabled[i] != pc.enabled[j])
+                parent_connection(j, static_cast<std::ptrdiff_t>(i));
+            i++;
+            j++;
+        }
+    }
+    while (i < cc.size()) child_only_connection(i++);
+    while (j < pc.size()) parent_connection(j++, -1);
+    return edit;
+}
+
+// ---------------------------------------------------------------------------
+// DistanceCache
+// ---------------------------------------------------------------------------
+void DistanceCache::record_birth(const DefaultGenome &child, const DefaultGenome &parent1,
+                                 const DefaultGenome &parent2) {
+    GenomeEdit edit = genome_edit(child, parent1);
+    if (parent2.key != parent1.key) {
+        GenomeEdit other = genome_edit(child, parent2);
+        if (other.size() < edit.size()) edit = std::move(other);
+    }
+    // Attribute changes cost one lookup each when deriving; only structural
+    // edits large enough to make the genomes unrelated fall back to merging.
+    const double genes = static_cast<double>(child.nodes.size() + child.connections.size());
+    if (static_cast<double>(edit.structural) > max_edit_fraction_ * genes) {
+        edits_.erase(child.key);
+        return;
+    }
+    edits_.insert_or_assign(child.key, std::move(edit));
+}
+
+const DistanceTerms *DistanceCache::find_terms(int a, int b) const {
+    static const DistanceTerms kIdentical;
+    if (a == b) return &kIdentical;
+    auto it = terms_.find(pair_key(a, b));
+    return it == terms_.end() ? nullptr : &it->second;
+}
+
+bool DistanceCache::derive(const DefaultGenome &child, const DefaultGenome &other,
+                           DistanceTerms &out) {
+    auto edit_it = edits_.find(child.key);
+    if (edit_it == edits_.end()) return false;
+    const GenomeEdit &edit = edit_it->second;
+    const DistanceTerms *base = find_terms(edit.parent, other.key);
+    if (base == nullptr) return false;
+
+    // Swap each edited gene's contribution under the parent for the one under
+    // the child: both present adds the gene distance, one present a disjoint.
+    out = *base;
+    for (const GenomeEdit::NodeChange &change : edit.nodes) {
+        const std::ptrdiff_t r = other.nodes.find(change.key);
+        if (change.in_parent) {
+            if (r >= 0)
+                out.node_sum -= node_gene_distance(change.bias, change.response, change.activation,
+                                                   change.aggregation, other.nodes, r);
+            else
+                out.node_disjoint--;
+        }
+        else if (r >= 0) {
+            out.node_disjoint--;
+        }
+        const std::ptrdiff_t c = change.child_row;
+        if (c >= 0 && r >= 0)
+            out.node_sum += node_gene_distance(child.nodes.bias[c], child.nodes.response[c],
+                                               child.nodes.activation[c],
+                                               child.nodes.aggregation[c], other.nodes, r);
+        else if (c >= 0 || r >= 0)
+            out.node_disjoint++;
+    }
+    for (const GenomeEdit::ConnectionChange &change : edit.connections) {
+        const std::ptrdiff_t r = other.connections.find(change.key);
+        if (change.in_parent) {
+            if (r >= 0)
+                out.connection_sum -=
+                    connection_gene_distance(change.weight, change.enabled, other.connections, r);
+            else
+                out.connection_disjoint--;
+        }
+        else if (r >= 0) {
+            out.connection_disjoint--;
+        }
+        const std::ptrdiff_t c = change.child_row;
+        if (c >= 0 && r >= 0)
+            out.connection_sum +=
+                connection_gene_distance(child.connections.weight[c], child.connections.enabled[c],
+                                         other.connections, r);
+        else if (c >= 0 || r >= 0)
+            out.connection_disjoint++;
+    }
+    // Cancellation can leave tiny negative rounding residue.
+    out.node_sum = std::max(out.node_sum, 0.0);
+    out.connection_sum = std::max(out.connection_sum, 0.0);
+    return true;
+}
+
+double DistanceCache::distance(const DefaultGenome &a, const DefaultGenome &b,
+                               const DefaultGenomeConfig &config) {
+    if (const DistanceTerms *cached = find_terms(a.key, b.key)) {
+        hits_++;
+        return cached->distance(a, b, config);
+    }
+    DistanceTerms terms;
+    if (derive(a, b, terms) || derive(b, a, terms)) {
+        derived_++;
+    }
+    else {
+        terms = distance_terms(a, b);
+        computed_++;
+    }
+    terms_.emplace(pair_key(a.key, b.key), terms);
+    return terms.distance(a, b, config);
+}
+
+void DistanceCache::retain(const std::vector<int> &keys) {
+    const std::unordered_set<int> live(keys.begin(), keys.end());
+    for (auto it = terms_.begin(); it != terms_.end();) {
+        const int a = static_cast<int>(static_cast<uint32_t>(it->first >> 32));
+        const int b = static_cast<int>(static_cast<uint32_t>(it->first));
+        it = live.count(a) && live.count(b) ? std::next(it) : terms_.erase(it);
+    }
+    // An edit is only useful until its child has been compared to the
+    // representatives; by then its parent is normally gone.
+    for (auto it = edits_.begin(); it != edits_.end();)
+        it = live.count(it->first) && live.count(it->second.parent) ? std::next(it)
+                                                                      : edits_.erase(it);
+}
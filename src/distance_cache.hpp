@@ -0,0 +1,106 @@
+#ifndef DISTANCE_CACHE_HPP
+#define DISTANCE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "genome.hpp"
+
+// The parts DefaultGenome::distance is made of, before normalization by the
+// gene counts: summed homologous gene distances and disjoint gene counts.
+struct DistanceTerms {
+    double node_sum = 0.0;
+    int64_t node_disjoint = 0;
+    double connection_sum = 0.0;
+    int64_t connection_disjoint = 0;
+
+    // The genetic distance of two genomes with these terms.
+    double distance(const DefaultGenome &a, const DefaultGenome &b,
+                    const DefaultGenomeConfig &config) const;
+};
+
+DistanceTerms distance_terms(const DefaultGenome &a, const DefaultGenome &b);
+
+// How a child differs from one of its parents: every gene that was added,
+// removed or has any attribute changed, with the parent's version of it and
+// the row of the child's (-1 if the child lacks the gene).
+struct GenomeEdit {
+    struct NodeChange {
+        int key;
+        bool in_parent;
+        std::ptrdiff_t child_row;
+        float bias;
+        float response;
+        std::string activation;
+        std::string aggregation;
+    };
+    struct ConnectionChange {
+        std::pair<int, int> key;
+        bool in_parent;
+        std::ptrdiff_t child_row;
+        float weight;
+        uint8_t enabled;
+    };
+
+    int parent;
+    std::vector<NodeChange> nodes;
+    std::vector<ConnectionChange> connections;
+    // Genes that only one of child and parent has.
+    size_t structural = 0;
+
+    size_t size() const { return nodes.size() + connections.size(); }
+};
+
+GenomeEdit genome_edit(const DefaultGenome &child, const DefaultGenome &parent);
+
+// ---------------------------------------------------------------------------
+// DistanceCache: genetic distances kept across generations, so that a child's
+// distance to a species representative can be derived from its parent's.
+//
+// Reproduction records each child's edit against the closer of its parents.
+// When the child is later compared to a representative whose distance terms
+// to that parent are cached, each edited gene is looked up once in the
+// representative (O(edit * log genes)) instead of merge-joining the two
+// genomes. Weight and bias perturbations touch most genes of a child, but
+// each only swaps one gene distance for another, so they always take this
+// path. Children whose added and removed genes exceed `max_edit_fraction` of
+// their genes are not recorded and always get the full merge-join.
+// ---------------------------------------------------------------------------
+class DistanceCache {
+   public:
+    explicit DistanceCache(double max_edit_fraction = 0.25)
+        : max_edit_fraction_(max_edit_fraction) {}
+
+    void record_birth(const DefaultGenome &child, const DefaultGenome &parent1,
+                      const DefaultGenome &parent2);
+
+    double distance(const DefaultGenome &a, const DefaultGenome &b,
+                    const DefaultGenomeConfig &config);
+
+    // Forgets everything about genomes whose keys are not in `keys`.
+    void retain(const std::vector<int> &keys);
+
+    size_t num_edits() const { return edits_.size(); }
+    size_t num_terms() const { return terms_.size(); }
+    // Distances answered from the cache, derived from a parent's, or computed.
+    size_t hits() const { return hits_; }
+    size_t derived() const { return derived_; }
+    size_t computed() const { return computed_; }
+
+   private:
+    const DistanceTerms *find_terms(int a, int b) const;
+    bool derive(const DefaultGenome &child, const DefaultGenome &other, DistanceTerms &out);
+
+    double max_edit_fraction_;
+    std::unordered_map<int, GenomeEdit> edits_;
+    std::unordered_map<uint64_t, DistanceTerms> terms_;
+    size_t hits_ = 0;
+    size_t derived_ = 0;
+    size_t computed_ = 0;
+};
+
+#endif  // DISTANCE_CACHE_HPP
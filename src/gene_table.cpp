@@ -0,0 +1,197 @@
+#include "gene_table.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Adding or removing rows moves a column's elements, which would leave a
+// writable view of the column pointing at freed memory.
+void check_resizable(bool pinned) {
+    if (pinned)
+        throw std::runtime_error(
+            "cannot add or remove genes while a writable view of a gene column is alive");
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// NodeGeneTable Implementation
+// ---------------------------------------------------------------------------
+std::ptrdiff_t NodeGeneTable::find(int key) const {
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key) return -1;
+    return it - keys.begin();
+}
+
+size_t NodeGeneTable::insert(const DefaultNodeGene& gene) {
+    auto it = std::lower_bound(keys.begin(), keys.end(), gene.key);
+    size_t row = it - keys.begin();
+    if (it != keys.end() && *it == gene.key) {
+        set(row, gene);
+        return row;
+    }
+    check_resizable(pinned());
+    keys.insert(row, gene.key);
+    bias.insert(row, gene.bias);
+    response.insert(row, gene.response);
+    activation.insert(row, gene.activation);
+    aggregation.insert(row, gene.aggregation);
+    return row;
+}
+
+void NodeGeneTable::push_back(const DefaultNodeGene& gene) {
+    check_resizable(pinned());
+    keys.push_back(gene.key);
+    bias.push_back(gene.bias);
+    response.push_back(gene.response);
+    activation.push_back(gene.activation);
+    aggregation.push_back(gene.aggregation);
+}
+
+bool NodeGeneTable::erase(int key) {
+    std::ptrdiff_t row = find(key);
+    if (row < 0) return false;
+    check_resizable(pinned());
+    keys.erase(row);
+    bias.erase(row);
+    response.erase(row);
+    activation.erase(row);
+    aggregation.erase(row);
+    return true;
+}
+
+void NodeGeneTable::reserve(size_t n) {
+    check_resizable(pinned());
+    keys.reserve(n);
+    bias.reserve(n);
+    response.reserve(n);
+    activation.reserve(n);
+    aggregation.reserve(n);
+}
+
+void NodeGeneTable::clear() {
+    check_resizable(pinned());
+    keys.clear();
+    bias.clear();
+    response.clear();
+    activation.clear();
+    aggregation.clear();
+}
+
+DefaultNodeGene NodeGeneTable::get(size_t row) const {
+    DefaultNodeGene gene(keys[row]);
+    gene.bias = bias[row];
+    gene.response = response[row];
+    gene.activation = activation[row];
+    gene.aggregation = aggregation[row];
+    return gene;
+}
+
+void NodeGeneTable::set(size_t row, const DefaultNodeGene& gene) {
+    bias.set(row, gene.bias);
+    response.set(row, gene.response);
+    activation.set(row, gene.activation);
+    aggregation.set(row, gene.aggregation);
+}
+
+bool NodeGeneTable::pinned() const {
+    return keys.pinned() || bias.pinned() || response.pinned() || activation.pinned() ||
+           aggregation.pinned();
+}
+
+int NodeGeneTable::shared_columns(const NodeGeneTable& other) const {
+    return keys.shares_with(other.keys) + bias.shares_with(other.bias) +
+           response.shares_with(other.response) + activation.shares_with(other.activation) +
+           aggregation.shares_with(other.aggregation);
+}
+
+// ---------------------------------------------------------------------------
+// ConnectionGeneTable Implementation
+// ---------------------------------------------------------------------------
+std::ptrdiff_t ConnectionGeneTable::find(const std::pair<int, int>& key) const {
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key) return -1;
+    return it - keys.begin();
+}
+
+size_t ConnectionGeneTable::insert(const DefaultConnectionGene& gene) {
+    auto it = std::lower_bound(keys.begin(), keys.end(), gene.key);
+    size_t row = it - keys.begin();
+    if (it != keys.end() && *it == gene.key) {
+        set(row, gene);
+        return row;
+    }
+    check_resizable(pinned());
+    keys.insert(row, gene.key);
+    weight.insert(row, gene.weight);
+    enabled.insert(row, gene.enabled ? 1 : 0);
+    return row;
+}
+
+void ConnectionGeneTable::push_back(const DefaultConnectionGene& gene) {
+    check_resizable(pinned());
+    keys.push_back(gene.key);
+    weight.push_back(gene.weight);
+    enabled.push_back(gene.enabled ? 1 : 0);
+}
+
+bool ConnectionGeneTable::erase(const std::pair<int, int>& key) {
+    std::ptrdiff_t row = find(key);
+    if (row < 0) return false;
+    check_resizable(pinned());
+    keys.erase(row);
+    weight.erase(row);
+    enabled.erase(row);
+    return true;
+}
+
+size_t ConnectionGeneTable::erase_touching(int node_key) {
+    auto touches = [node_key](const std::pair<int, int>& key) {
+        return key.first == node_key || key.second == node_key;
+    };
+    if (std::none_of(keys.begin(), keys.end(), touches)) return 0;
+    check_resizable(pinned());
+
+    std::vector<bool> remove(keys.size());
+    for (size_t row = 0; row < keys.size(); row++) remove[row] = touches(keys[row]);
+    keys.erase_rows(remove);
+    weight.erase_rows(remove);
+    enabled.erase_rows(remove);
+    return remove.size() - keys.size();
+}
+
+void ConnectionGeneTable::reserve(size_t n) {
+    check_resizable(pinned());
+    keys.reserve(n);
+    weight.reserve(n);
+    enabled.reserve(n);
+}
+
+void ConnectionGeneTable::clear() {
+    check_resizable(pinned());
+    keys.clear();
+    weight.clear();
+    enabled.clear();
+}
+
+DefaultConnectionGene ConnectionGeneTable::get(size_t row) const {
+    DefaultConnectionGene gene(keys[row]);
+    gene.weight = weight[row];
+    gene.enabled = enabled[row] != 0;
+    return gene;
+}
+
+void ConnectionGeneTable::set(size_t row, const DefaultConnectionGene& gene) {
+    weight.set(row, gene.weight);
+    enabled.set(row, gene.enabled ? 1 : 0);
+}
+
+bool ConnectionGeneTable::pinned() const {
+    return keys.pinned() || weight.pinned() || enabled.pinned();
+}
+
+int ConnectionGeneTable::shared_columns(const ConnectionGeneTable& other) const {
+    return keys.shares_with(other.keys) + weight.shares_with(other.weight) +
+           enabled.shares_with(other.enabled);
+}
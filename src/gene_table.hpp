@@ -0,0 +1,110 @@
+#ifndef GENE_TABLE_HPP
+#define GENE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cow_vector.hpp"
+#include "genes.hpp"
+
+// ---------------------------------------------------------------------------
+// NodeGeneTable: Node genes stored column-wise, one array per attribute, with
+// rows kept sorted by key. The numeric columns are what the Python binding
+// exposes as NumPy views.
+//
+// Columns are copy-on-write in blocks of CowVector::kBlockSize genes: copying
+// a table (e.g. a crossover child taking its genes from the fitter parent)
+// shares every block, and a block is duplicated only once a write actually
+// changes one of its genes.
+// ---------------------------------------------------------------------------
+struct NodeGeneTable {
+    CowVector<int> keys;
+    CowVector<float> bias;
+    CowVector<float> response;
+    CowVector<std::string> activation;
+    CowVector<std::string> aggregation;
+
+    size_t size() const { return keys.size(); }
+    bool empty() const { return keys.empty(); }
+    bool contains(int key) const { return find(key) >= 0; }
+
+    // Returns the row holding `key`, or -1 if there is none.
+    std::ptrdiff_t find(int key) const;
+
+    // Inserts the gene in key order (overwriting an existing row with the same
+    // key) and returns its row.
+    size_t insert(const DefaultNodeGene& gene);
+
+    // Appends a gene whose key is larger than every key already stored.
+    void push_back(const DefaultNodeGene& gene);
+
+    // Removes the row holding `key`. Returns false if there is none.
+    bool erase(int key);
+
+    void reserve(size_t n);
+    void clear();
+
+    DefaultNodeGene get(size_t row) const;
+    void set(size_t row, const DefaultNodeGene& gene);
+
+    // Whether a writable view pins any column. Adding or removing rows throws
+    // std::runtime_error while it does.
+    bool pinned() const;
+
+    // Number of columns whose storage is shared with `other`.
+    int shared_columns(const NodeGeneTable& other) const;
+};
+
+// ---------------------------------------------------------------------------
+// ConnectionGeneTable: Connection genes stored column-wise, with rows kept
+// sorted by (input, output) key. `enabled` is one byte per gene so that it can
+// be viewed as a NumPy bool array.
+// ---------------------------------------------------------------------------
+struct ConnectionGeneTable {
+    CowVector<std::pair<int, int>> keys;
+    CowVector<float> weight;
+    CowVector<uint8_t> enabled;
+
+    size_t size() const { return keys.size(); }
+    bool empty() const { return keys.empty(); }
+    bool contains(const std::pair<int, int>& key) const { return find(key) >= 0; }
+
+    // Returns the row holding `key`, or -1 if there is none.
+    std::ptrdiff_t find(const std::pair<int, int>& key) const;
+
+    // Inserts the gene in key order (overwriting an existing row with the same
+    // key) and returns its row.
+    size_t insert(const DefaultConnectionGene& gene);
+
+    // Appends a gene whose key is larger than every key already stored.
+    void push_back(const DefaultConnectionGene& gene);
+
+    // Removes the row holding `key`. Returns false if there is none.
+    bool erase(const std::pair<int, int>& key);
+
+    // Removes every row that has `node_key` as its input or output. Returns the
+    // number of rows removed.
+    size_t erase_touching(int node_key);
+
+    void reserve(size_t n);
+    void clear();
+
+    DefaultConnectionGene get(size_t row) const;
+    void set(size_t row, const DefaultConnectionGene& gene);
+
+    // Whether a writable view pins any column. Adding or removing rows throws
+    // std::runtime_error while it does.
+    bool pinned() const;
+
+    // Number of columns whose storage is shared with `other`.
+    int shared_columns(const ConnectionGeneTable& other) const;
+};
+
+// The connection key column is exposed to Python as an (N, 2) int32 array.
+static_assert(sizeof(std::pair<int, int>) == 2 * sizeof(int),
+              "std::pair<int, int> must be tightly packed");
+
+#endif  // GENE_TABLE_HPP
@@ -1,8 +1,34 @@
 #include "genome.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
 #include <random>
 #include <sstream>
+#include <stdexcept>
+
+#include "graphs.hpp"
+
+namespace {
+
+const neat3p::FloatAttribute kBiasAttribute("bias");
+const neat3p::FloatAttribute kResponseAttribute("response");
+const neat3p::StringAttribute kActivationAttribute("activation");
+const neat3p::StringAttribute kAggregationAttribute("aggregation");
+const neat3p::FloatAttribute kWeightAttribute("weight");
+const neat3p::BoolAttribute kEnabledAttribute("enabled");
+
+double uniform01() { return std::uniform_real_distribution<>(0.0, 1.0)(neat3p::random_engine()); }
+
+template <typename Values>
+const typename Values::value_type &choice(const Values &values) {
+    std::uniform_int_distribution<size_t> dist(0, values.size() - 1);
+    return values[dist(neat3p::random_engine())];
+}
+
+}  // namespace
 
 // ---------------------------------------------------------------------------
 // DefaultGenomeConfig Implementation
@@ -41,104 +67,563 @@ DefaultGenomeConfig::DefaultGenomeConfig(const GenomeParams &params)
     for (int i = 0; i < num_outputs; i++) {
         output_keys.push_back(i);
     }
+    next_node_key = num_outputs;
 }
 
-int DefaultGenomeConfig::get_new_node_key(const std::map<int, DefaultNodeGene> &node_dict) {
-    if (!node_dict.empty()) {
-        auto it = std::max_element(node_dict.begin(), node_dict.end(),
-                                   [](const auto &a, const auto &b) { return a.first < b.first; });
-        next_node_key = it->first + 1;
-    }
+int DefaultGenomeConfig::get_new_node_key(const NodeGeneTable &nodes) {
+    // Node tables are sorted, so the last key is the largest one in use.
+    if (!nodes.empty()) next_node_key = std::max(next_node_key, nodes.keys.back() + 1);
     // Ensure the new key is unique.
-    while (node_dict.find(next_node_key) != node_dict.end()) next_node_key++;
+    while (nodes.contains(next_node_key)) next_node_key++;
     return next_node_key++;
 }
 
+bool DefaultGenomeConfig::check_structural_mutation_surer() const {
+    std::string surer = structural_mutation_surer;
+    std::transform(surer.begin(), surer.end(), surer.begin(), ::tolower);
+    if (surer == "1" || surer == "yes" || surer == "true" || surer == "on") return true;
+    if (surer == "0" || surer == "no" || surer == "false" || surer == "off") return false;
+    if (surer == "default") return single_structural_mutation;
+    throw std::runtime_error("Invalid structural_mutation_surer " + structural_mutation_surer);
+}
+
+bool DefaultGenomeConfig::is_output(int key) const { return key >= 0 && key < num_outputs; }
+
 // ---------------------------------------------------------------------------
 // DefaultGenome Implementation
 // ---------------------------------------------------------------------------
-DefaultGenome::DefaultGenome(int key_) : key(key_), fitness(0.0) {}
+DefaultGenome::DefaultGenome(int key_) : key(key_), fitness(std::nullopt) {}
 
-DefaultNodeGene DefaultGenome::create_node(const DefaultGenomeConfig &config, int node_key) {
+DefaultNodeGene DefaultGenome::create_node(const DefaultGenomeConfig &config, int node_key) const {
     DefaultNodeGene node(node_key);
-    node.init_attributes();  // Assume init_attributes() is implemented (even if empty)
+    node.bias = static_cast<float>(kBiasAttribute.init_value(config.bias));
+    node.response = static_cast<float>(kResponseAttribute.init_value(config.response));
+    node.activation = kActivationAttribute.init_value(config.activation);
+    node.aggregation = kAggregationAttribute.init_value(config.aggregation);
     return node;
 }
 
-DefaultConnectionGene DefaultGenome::create_connection(const std::pair<int, int> &conn_key) {
+DefaultConnectionGene DefaultGenome::create_connection(const DefaultGenomeConfig &config,
+                                                       const std::pair<int, int> &conn_key) const {
     DefaultConnectionGene conn(conn_key);
-    conn.init_attributes();  // Assume init_attributes() is implemented (even if empty)
+    conn.weight = static_cast<float>(kWeightAttribute.init_value(config.weight));
+    conn.enabled = kEnabledAttribute.init_value(config.enabled);
     return conn;
 }
 
+void DefaultGenome::check_unpinned() const {
+    if (nodes.pinned() || connections.pinned())
+        throw std::runtime_error("genome " + std::to_string(key) +
+                                 " has live writable column views; release them before "
+                                 "changing its structure");
+}
+
 void DefaultGenome::configure_new(DefaultGenomeConfig &config) {
-    // Create output nodes.
+    check_unpinned();
+    // Create node genes for the output pins.
     for (int node_key : config.output_keys) {
-        nodes.insert({node_key, create_node(config, node_key)});
-        nodes.emplace(node_key, create_node(config, node_key));
+        nodes.insert(create_node(config, node_key));
     }
     // Add hidden nodes if requested.
     for (int i = 0; i < config.num_hidden; i++) {
         int node_key = config.get_new_node_key(nodes);
-        nodes.insert({node_key, create_node(config, node_key)});
-    }
-    // For demonstration, create a simple full connection from one random input.
-    if (!config.input_keys.empty() && !config.output_keys.empty()) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dist(0, config.input_keys.size() - 1);
-        int in_idx = dist(gen);
-        int input_id = config.input_keys[in_idx];
-        for (int output_id : config.output_keys) {
-            std::pair<int, int> conn_key(input_id, output_id);
-            connections.insert({conn_key, create_connection(conn_key)});
+        nodes.insert(create_node(config, node_key));
+    }
+
+    // Add connections based on initial connectivity type.
+    const std::string &conn = config.initial_connection;
+    if (conn.find("fs_neat") != std::string::npos) {
+        if (conn == "fs_neat_hidden") {
+            connect_fs_neat_hidden(config);
         }
+        else {
+            if (conn == "fs_neat" && config.num_hidden > 0)
+                std::cerr << "Warning: initial_connection = fs_neat will not connect to hidden "
+                             "nodes; use fs_neat_nohidden or fs_neat_hidden to silence this\n";
+            connect_fs_neat_nohidden(config);
+        }
+    }
+    else if (conn.find("full") != std::string::npos) {
+        if (conn == "full" && config.num_hidden > 0)
+            std::cerr << "Warning: initial_connection = full with hidden nodes will not do direct "
+                         "input-output connections; use full_nodirect or full_direct to silence "
+                         "this\n";
+        connect_full(config, conn == "full_direct");
+    }
+    else if (conn.find("partial") != std::string::npos) {
+        if (conn == "partial" && config.num_hidden > 0)
+            std::cerr << "Warning: initial_connection = partial with hidden nodes will not do "
+                         "direct input-output connections; use partial_nodirect or "
+                         "partial_direct to silence this\n";
+        connect_partial(config, conn == "partial_direct");
+    }
+    else if (conn != "unconnected") {
+        throw std::runtime_error("Unknown initial_connection " + conn);
     }
 }
 
-void DefaultGenome::mutate_add_node(DefaultGenomeConfig &config) {
-    if (connections.empty()) return;
+void DefaultGenome::configure_crossover(const DefaultGenome &genome1,
+                                        const DefaultGenome &genome2) {
+    check_unpinned();
+    const double ninf = -std::numeric_limits<double>::infinity();
+    const bool first_fitter = genome1.fitness.value_or(ninf) > genome2.fitness.value_or(ninf);
+    const DefaultGenome &parent1 = first_fitter ? genome1 : genome2;
+    const DefaultGenome &parent2 = first_fitter ? genome2 : genome1;
+
+    // Both tables are sorted by key, so homologous genes are found in one merge
+    // pass. Excess or disjoint genes are copied from the fittest parent;
+    // homologous genes inherit each attribute from either parent at random.
+    const ConnectionGeneTable &c1 = parent1.connections;
+    const ConnectionGeneTable &c2 = parent2.connections;
+    connections = c1;
+    for (size_t i = 0, j = 0; i < c1.size(); i++) {
+        while (j < c2.size() && c2.keys[j] < c1.keys[i]) j++;
+        if (j == c2.size() || c2.keys[j] != c1.keys[i]) continue;
+        if (uniform01() <= 0.5) connections.weight.set(i, c2.weight[j]);
+        if (uniform01() <= 0.5) connections.enabled.set(i, c2.enabled[j]);
+    }
+
+    const NodeGeneTable &n1 = parent1.nodes;
+    const NodeGeneTable &n2 = parent2.nodes;
+    nodes = n1;
+    for (size_t i = 0, j = 0; i < n1.size(); i++) {
+        while (j < n2.size() && n2.keys[j] < n1.keys[i]) j++;
+        if (j == n2.size() || n2.keys[j] != n1.keys[i]) continue;
+        if (uniform01() <= 0.5) nodes.bias.set(i, n2.bias[j]);
+        if (uniform01() <= 0.5) nodes.response.set(i, n2.response[j]);
+        if (uniform01() <= 0.5) nodes.activation.set(i, n2.activation[j]);
+        if (uniform01() <= 0.5) nodes.aggregation.set(i, n2.aggregation[j]);
+    }
+}
+
+void DefaultGenome::mutate(DefaultGenomeConfig &config) {
+    check_unpinned();
+    if (config.single_structural_mutation) {
+        double total = config.node_add_prob + config.node_delete_prob + config.conn_add_prob +
+                       config.conn_delete_prob;
+        double div = std::max(1.0, total);
+        double r = uniform01();
+        if (r < config.node_add_prob / div) {
+            mutate_add_node(config);
+        }
+        else if (r < (config.node_add_prob + config.node_delete_prob) / div) {
+            mutate_delete_node(config);
+        }
+        else if (r <
+                 (config.node_add_prob + config.node_delete_prob + config.conn_add_prob) / div) {
+            mutate_add_connection(config);
+        }
+        else if (r < total / div) {
+            mutate_delete_connection();
+        }
+    }
+    else {
+        if (uniform01() < config.node_add_prob) mutate_add_node(config);
+        if (uniform01() < config.node_delete_prob) mutate_delete_node(config);
+        if (uniform01() < config.conn_add_prob) mutate_add_connection(config);
+        if (uniform01() < config.conn_delete_prob) mutate_delete_connection();
+    }
+
+    // Mutate connection genes. Columns are copy-on-write per block and set()
+    // skips unchanged values, so blocks no gene of which mutated stay shared
+    // with the parent.
+    for (size_t i = 0; i < connections.size(); i++) {
+        connections.weight.set(i, static_cast<float>(kWeightAttribute.mutate_value(
+                                      connections.weight[i], config.weight)));
+        connections.enabled.set(
+            i, kEnabledAttribute.mutate_value(connections.enabled[i] != 0, config.enabled) ? 1 : 0);
+    }
 
-    // Select a random connection to split.
-    std::vector<std::pair<int, int>> keys;
-    for (const auto &kv : connections) keys.push_back(kv.first);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dist(0, keys.size() - 1);
-    auto selected_key = keys[dist(gen)];
+    // Mutate node genes (bias, response, etc.).
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodes.bias.set(
+            i, static_cast<float>(kBiasAttribute.mutate_value(nodes.bias[i], config.bias)));
+        nodes.response.set(i, static_cast<float>(kResponseAttribute.mutate_value(
+                                  nodes.response[i], config.response)));
+        if (config.activation.mutate_rate_s > 0)
+            nodes.activation.set(
+                i, kActivationAttribute.mutate_value(nodes.activation[i], config.activation));
+        if (config.aggregation.mutate_rate_s > 0)
+            nodes.aggregation.set(
+                i, kAggregationAttribute.mutate_value(nodes.aggregation[i], config.aggregation));
+    }
+}
 
-    // Disable the selected connection.
-    auto conn_iter = connections.find(selected_key);
-    if (conn_iter != connections.end()) {
-        conn_iter->second.enabled = false;
+int DefaultGenome::mutate_add_node(DefaultGenomeConfig &config) {
+    check_unpinned();
+    if (connections.empty()) {
+        if (config.check_structural_mutation_surer()) mutate_add_connection(config);
+        return -1;
     }
 
-    // Create a new node.
+    // Choose a random connection to split.
+    std::uniform_int_distribution<size_t> dist(0, connections.size() - 1);
+    size_t row = dist(neat3p::random_engine());
+    const auto [i, o] = connections.keys[row];
+    const float split_weight = connections.weight[row];
+
+    // Disable this connection and create two new connections joining its nodes
+    // via the new node. The new node+connections have roughly the same behavior
+    // as the original connection (depending on the activation of the new node).
+    connections.enabled.set(row, 0);
+
     int new_node_key = config.get_new_node_key(nodes);
-    nodes.insert({new_node_key, create_node(config, new_node_key)});
+    nodes.insert(create_node(config, new_node_key));
+
+    add_connection(config, i, new_node_key, 1.0f, true);
+    add_connection(config, new_node_key, o, split_weight, true);
+    return new_node_key;
+}
+
+void DefaultGenome::add_connection(const DefaultGenomeConfig &config, int input_key,
+                                   int output_key, float weight, bool enabled) {
+    if (output_key < 0) throw std::invalid_argument("Connection output must not be an input pin");
+    check_unpinned();
+    DefaultConnectionGene conn = create_connection(config, {input_key, output_key});
+    conn.weight = weight;
+    conn.enabled = enabled;
+    connections.insert(conn);
+}
+
+void DefaultGenome::mutate_add_connection(DefaultGenomeConfig &config) {
+    check_unpinned();
+    // The output node cannot be one of the network input pins.
+    if (nodes.empty()) return;
+    int out_node = choice(nodes.keys);
+
+    std::vector<int> possible_inputs(nodes.keys.begin(), nodes.keys.end());
+    possible_inputs.insert(possible_inputs.end(), config.input_keys.begin(),
+                           config.input_keys.end());
+    int in_node = choice(possible_inputs);
+
+    // Don't duplicate connections.
+    std::pair<int, int> key(in_node, out_node);
+    std::ptrdiff_t row = connections.find(key);
+    if (row >= 0) {
+        if (config.check_structural_mutation_surer()) connections.enabled.set(row, 1);
+        return;
+    }
+
+    // Don't allow connections between two output nodes.
+    if (config.is_output(in_node) && config.is_output(out_node)) return;
+
+    // For feed-forward networks, avoid creating cycles.
+    if (config.feed_forward && creates_cycle(connections.keys, key)) return;
+
+    connections.insert(create_connection(config, key));
+}
+
+int DefaultGenome::mutate_delete_node(const DefaultGenomeConfig &config) {
+    check_unpinned();
+    // Do nothing if there are no non-output nodes.
+    std::vector<int> available;
+    for (int k : nodes.keys)
+        if (!config.is_output(k)) available.push_back(k);
+    if (available.empty()) return -1;
+
+    int del_key = choice(available);
+    connections.erase_touching(del_key);
+    nodes.erase(del_key);
+    return del_key;
+}
+
+void DefaultGenome::mutate_delete_connection() {
+    check_unpinned();
+    if (connections.empty()) return;
+    connections.erase(choice(connections.keys));
+}
+
+double DefaultGenome::distance(const DefaultGenome &other,
+                               const DefaultGenomeConfig &config) const {
+    // Compute node gene distance component.
+    double node_distance = 0.0;
+    if (!nodes.empty() || !other.nodes.empty()) {
+        size_t disjoint = 0;
+        size_t i = 0, j = 0;
+        while (i < nodes.size() && j < other.nodes.size()) {
+            if (nodes.keys[i] < other.nodes.keys[j]) {
+                disjoint++;
+                i++;
+            }
+            else if (other.nodes.keys[j] < nodes.keys[i]) {
+                disjoint++;
+                j++;
+            }
+            else {
+                // Homologous genes: same formula as DefaultNodeGene::distance.
+                double d = std::abs(nodes.bias[i] - other.nodes.bias[j]) +
+                           std::abs(nodes.response[i] - other.nodes.response[j]);
+                if (nodes.activation[i] != other.nodes.activation[j]) d += 1.0;
+                if (nodes.aggregation[i] != other.nodes.aggregation[j]) d += 1.0;
+                node_distance += d * config.compatibility_weight_coefficient;
+                i++;
+                j++;
+            }
+        }
+        disjoint += (nodes.size() - i) + (other.nodes.size() - j);
+        size_t max_nodes = std::max(nodes.size(), other.nodes.size());
+        node_distance =
+            (node_distance + config.compatibility_disjoint_coefficient * disjoint) / max_nodes;
+    }
+
+    // Compute connection gene differences.
+    double connection_distance = 0.0;
+    if (!connections.empty() || !other.connections.empty()) {
+        size_t disjoint = 0;
+        size_t i = 0, j = 0;
+        while (i < connections.size() && j < other.connections.size()) {
+            if (connections.keys[i] < other.connections.keys[j]) {
+                disjoint++;
+                i++;
+            }
+            else if (other.connections.keys[j] < connections.keys[i]) {
+                disjoint++;
+                j++;
+            }
+            else {
+                double d = std::abs(connections.weight[i] - other.connections.weight[j]);
+                if (connections.enabled[i] != other.connections.enabled[j]) d += 1.0;
+                connection_distance += d * config.compatibility_weight_coefficient;
+                i++;
+                j++;
+            }
+        }
+        disjoint += (connections.size() - i) + (other.connections.size() - j);
+        size_t max_conn = std::max(connections.size(), other.connections.size());
+        connection_distance =
+            (connection_distance + config.compatibility_disjoint_coefficient * disjoint) /
+            max_conn;
+    }
+
+    return node_distance + connection_distance;
+}
+
+std::pair<int, int> DefaultGenome::size() const {
+    int num_enabled = 0;
+    for (uint8_t e : connections.enabled) num_enabled += e ? 1 : 0;
+    return {static_cast<int>(nodes.size()), num_enabled};
+}
+
+uint64_t DefaultGenome::topology_hash() const {
+    // FNV-1a over the structural columns; the parameter columns are skipped.
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const void *data, size_t n) {
+        const unsigned char *bytes = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < n; i++) {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+    };
+    mix(nodes.keys.data(), nodes.keys.size() * sizeof(int));
+    for (size_t i = 0; i < nodes.size(); i++) {
+        mix(nodes.activation[i].data(), nodes.activation[i].size() + 1);
+        mix(nodes.aggregation[i].data(), nodes.aggregation[i].size() + 1);
+    }
+    mix(connections.keys.data(), connections.keys.size() * sizeof(std::pair<int, int>));
+    mix(connections.enabled.data(), connections.enabled.size());
+    return h;
+}
+
+std::string DefaultGenome::to_string() const {
+    std::ostringstream oss;
+    oss << "Key: " << key << "\nFitness: ";
+    if (fitness)
+        oss << *fitness;
+    else
+        oss << "None";
+    oss << "\nNodes:";
+    for (size_t i = 0; i < nodes.size(); i++)
+        oss << "\n\t" << nodes.keys[i] << " " << nodes.get(i).to_string();
+    oss << "\nConnections:";
+    for (size_t i = 0; i < connections.size(); i++)
+        oss << "\n\t" << connections.get(i).to_string();
+    return oss.str();
+}
+
+std::vector<std::pair<int, int>> DefaultGenome::compute_full_connections(
+    const DefaultGenomeConfig &config, bool direct) const {
+    std::vector<int> hidden, output;
+    for (int k : nodes.keys) (config.is_output(k) ? output : hidden).push_back(k);
+
+    std::vector<std::pair<int, int>> result;
+    if (!hidden.empty()) {
+        for (int input_id : config.input_keys)
+            for (int h : hidden) result.emplace_back(input_id, h);
+        for (int h : hidden)
+            for (int output_id : output) result.emplace_back(h, output_id);
+    }
+    if (direct || hidden.empty()) {
+        for (int input_id : config.input_keys)
+            for (int output_id : output) result.emplace_back(input_id, output_id);
+    }
+    // For recurrent genomes, include node self-connections.
+    if (!config.feed_forward) {
+        for (int k : nodes.keys) result.emplace_back(k, k);
+    }
+    return result;
+}
+
+void DefaultGenome::connect_fs_neat_nohidden(const DefaultGenomeConfig &config) {
+    int input_id = choice(config.input_keys);
+    for (int output_id : config.output_keys)
+        connections.insert(create_connection(config, {input_id, output_id}));
+}
+
+void DefaultGenome::connect_fs_neat_hidden(const DefaultGenomeConfig &config) {
+    int input_id = choice(config.input_keys);
+    for (int output_id : nodes.keys)
+        connections.insert(create_connection(config, {input_id, output_id}));
+}
+
+void DefaultGenome::connect_full(const DefaultGenomeConfig &config, bool direct) {
+    for (const auto &key : compute_full_connections(config, direct))
+        connections.insert(create_connection(config, key));
+}
+
+void DefaultGenome::connect_partial(const DefaultGenomeConfig &config, bool direct) {
+    auto all_connections = compute_full_connections(config, direct);
+    std::shuffle(all_connections.begin(), all_connections.end(), neat3p::random_engine());
+    size_t num_to_add =
+        static_cast<size_t>(std::round(all_connections.size() * config.connection_fraction));
+    for (size_t i = 0; i < num_to_add; i++)
+        connections.insert(create_connection(config, all_connections[i]));
+}
+
+// ---------------------------------------------------------------------------
+// Serialization: a little-endian, length-prefixed binary layout.
+// ---------------------------------------------------------------------------
+namespace {
 
-    // Create two new connections.
-    std::pair<int, int> conn1_key(selected_key.first, new_node_key);
-    DefaultConnectionGene conn1 = create_connection(conn1_key);
-    conn1.weight = 1.0;
-    connections.insert({conn1_key, conn1});
+constexpr char kGenomeMagic[4] = {'N', '3', 'P', 'G'};
+constexpr uint32_t kGenomeFormatVersion = 1;
+
+template <typename T>
+void put(std::string &out, const T &value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
 
-    std::pair<int, int> conn2_key(new_node_key, selected_key.second);
-    DefaultConnectionGene conn2 = create_connection(conn2_key);
-    // Use the weight from the original connection.
-    conn2.weight = conn_iter->second.weight;
-    connections.insert({conn2_key, conn2});
+void put_string(std::string &out, const std::string &value) {
+    put<uint16_t>(out, static_cast<uint16_t>(value.size()));
+    out.append(value);
+}
+
+class Reader {
+   public:
+    Reader(const std::string &data, size_t pos) : data_(data), pos_(pos) {}
+
+    template <typename T>
+    T get() {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    std::string get_string() {
+        uint16_t n = get<uint16_t>();
+        require(n);
+        std::string value = data_.substr(pos_, n);
+        pos_ += n;
+        return value;
+    }
+
+   private:
+    void require(size_t n) const {
+        if (pos_ + n > data_.size()) throw std::runtime_error("Truncated genome data");
+    }
+
+    const std::string &data_;
+    size_t pos_;
+};
+
+}  // namespace
+
+std::string DefaultGenome::serialize() const {
+    std::string out;
+    out.reserve(32 + nodes.size() * 24 + connections.size() * 13);
+    out.append(kGenomeMagic, sizeof(kGenomeMagic));
+    put<uint32_t>(out, kGenomeFormatVersion);
+    put<int32_t>(out, key);
+    put<uint8_t>(out, fitness.has_value() ? 1 : 0);
+    put<double>(out, fitness.value_or(0.0));
+
+    put<uint32_t>(out, static_cast<uint32_t>(nodes.size()));
+    for (size_t i = 0; i < nodes.size(); i++) {
+        put<int32_t>(out, nodes.keys[i]);
+        put<float>(out, nodes.bias[i]);
+        put<float>(out, nodes.response[i]);
+        put_string(out, nodes.activation[i]);
+        put_string(out, nodes.aggregation[i]);
+    }
+
+    put<uint32_t>(out, static_cast<uint32_t>(connections.size()));
+    for (size_t i = 0; i < connections.size(); i++) {
+        put<int32_t>(out, connections.keys[i].first);
+        put<int32_t>(out, connections.keys[i].second);
+        put<float>(out, connections.weight[i]);
+        put<uint8_t>(out, connections.enabled[i]);
+    }
+    return out;
+}
+
+DefaultGenome DefaultGenome::deserialize(const std::string &data) {
+    if (data.size() < sizeof(kGenomeMagic) ||
+        std::memcmp(data.data(), kGenomeMagic, sizeof(kGenomeMagic)) != 0)
+        throw std::runtime_error("Not a serialized DefaultGenome");
+    Reader reader(data, sizeof(kGenomeMagic));
+    uint32_t version = reader.get<uint32_t>();
+    if (version != kGenomeFormatVersion)
+        throw std::runtime_error("Unsupported genome format version " + std::to_string(version));
+
+    DefaultGenome genome(reader.get<int32_t>());
+    bool has_fitness = reader.get<uint8_t>() != 0;
+    double fitness = reader.get<double>();
+    if (has_fitness) genome.fitness = fitness;
+
+    uint32_t num_nodes = reader.get<uint32_t>();
+    genome.nodes.reserve(num_nodes);
+    for (uint32_t i = 0; i < num_nodes; i++) {
+        DefaultNodeGene node(reader.get<int32_t>());
+        node.bias = reader.get<float>();
+        node.response = reader.get<float>();
+        node.activation = reader.get_string();
+        node.aggregation = reader.get_string();
+        genome.nodes.push_back(node);
+    }
+
+    uint32_t num_connections = reader.get<uint32_t>();
+    genome.connections.reserve(num_connections);
+    for (uint32_t i = 0; i < num_connections; i++) {
+        int32_t input = reader.get<int32_t>();
+        int32_t output = reader.get<int32_t>();
+        DefaultConnectionGene conn({input, output});
+        conn.weight = reader.get<float>();
+        conn.enabled = reader.get<uint8_t>() != 0;
+        genome.connections.push_back(conn);
+    }
+    return genome;
 }
 
 // ---------------------------------------------------------------------------
 // Utility: Get a pruned copy of the genome.
-// (This simplified version returns a copy without any pruning.)
 // ---------------------------------------------------------------------------
 DefaultGenome get_pruned_copy(const DefaultGenome &genome, const std::vector<int> &input_keys,
                               const std::vector<int> &output_keys) {
-    DefaultGenome pruned(genome.key);
-    pruned.nodes = genome.nodes;
-    pruned.connections = genome.connections;
-    pruned.fitness = genome.fitness;
+    std::unordered_set<int> used_nodes =
+        required_for_output(input_keys, output_keys, genome.connections.keys);
+    std::unordered_set<int> used_pins = used_nodes;
+    used_pins.insert(input_keys.begin(), input_keys.end());
+
+    // Rows are visited in key order, so the pruned tables stay sorted.
+    DefaultGenome pruned(0);
+    for (size_t i = 0; i < genome.nodes.size(); i++) {
+        if (used_nodes.count(genome.nodes.keys[i])) pruned.nodes.push_back(genome.nodes.get(i));
+    }
+    for (size_t i = 0; i < genome.connections.size(); i++) {
+        const auto &[in_key, out_key] = genome.connections.keys[i];
+        if (genome.connections.enabled[i] && used_pins.count(in_key) && used_pins.count(out_key))
+            pruned.connections.push_back(genome.connections.get(i));
+    }
     return pruned;
 }
@@ -1,10 +1,14 @@
 #ifndef GENOME_HPP
 #define GENOME_HPP
 
-#include <map>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "attributes.hpp"
+#include "gene_table.hpp"
 #include "genes.hpp"
 
 // Structure to hold raw genome parameters.
@@ -48,45 +52,111 @@ class DefaultGenomeConfig {
     std::vector<int> input_keys;
     std::vector<int> output_keys;
 
-    // For generating unique node keys.
+    // Per-attribute parameters for node genes (bias, response, activation,
+    // aggregation) and connection genes (weight, enabled).
+    neat3p::AttributeConfig bias;
+    neat3p::AttributeConfig response;
+    neat3p::AttributeConfig activation;
+    neat3p::AttributeConfig aggregation;
+    neat3p::AttributeConfig weight;
+    neat3p::AttributeConfig enabled;
+
+    // For generating unique node keys. Keys keep increasing across every genome
+    // sharing this config, so that independently added nodes never collide.
     int next_node_key;
 
     // Constructor: initializes configuration from raw parameters.
     DefaultGenomeConfig(const GenomeParams &params);
 
-    // Returns a new node key that is not already used in node_dict.
-    int get_new_node_key(const std::map<int, DefaultNodeGene> &node_dict);
+    // Returns a new node key that is not already used in nodes.
+    int get_new_node_key(const NodeGeneTable &nodes);
+
+    // Resolves structural_mutation_surer ("true", "false" or "default").
+    bool check_structural_mutation_surer() const;
+
+    bool is_output(int key) const;
 };
 
 // ---------------------------------------------------------------------------
 // DefaultGenome: Represents a genome containing node and connection genes.
+// Genes are held in column-wise tables sorted by key, so that homologous genes
+// of two genomes line up in a single merge pass.
 // ---------------------------------------------------------------------------
 class DefaultGenome {
    public:
     int key;  // Unique identifier for the genome.
-    std::map<int, DefaultNodeGene> nodes;
-    std::map<std::pair<int, int>, DefaultConnectionGene> connections;
-    double fitness;
+    NodeGeneTable nodes;
+    ConnectionGeneTable connections;
+    std::optional<double> fitness;
 
     // Constructor.
     DefaultGenome(int key_);
 
-    // Create a new node gene. This method calls the node's init_attributes().
-    DefaultNodeGene create_node(const DefaultGenomeConfig &config, int node_key);
+    // Create a new node gene with attributes initialized from the config.
+    DefaultNodeGene create_node(const DefaultGenomeConfig &config, int node_key) const;
 
-    // Create a new connection gene. This method calls the connection's init_attributes().
-    DefaultConnectionGene create_connection(const std::pair<int, int> &conn_key);
+    // Create a new connection gene with attributes initialized from the config.
+    DefaultConnectionGene create_connection(const DefaultGenomeConfig &config,
+                                            const std::pair<int, int> &conn_key) const;
 
     // Configure a new genome: creates output nodes, hidden nodes (if any),
-    // and adds initial connections.
+    // and adds the initial connections requested by config.initial_connection.
     void configure_new(DefaultGenomeConfig &config);
 
-    // A simple mutation: add a node by splitting a random connection.
-    void mutate_add_node(DefaultGenomeConfig &config);
+    // Configure a new genome by crossover from two parent genomes.
+    void configure_crossover(const DefaultGenome &genome1, const DefaultGenome &genome2);
+
+    // Structural mutations followed by attribute mutation of every gene.
+    void mutate(DefaultGenomeConfig &config);
+
+    // Split a random connection with a new node. Returns the new node key, or
+    // -1 if no node was added.
+    int mutate_add_node(DefaultGenomeConfig &config);
+
+    // Attempt to add a random connection.
+    void mutate_add_connection(DefaultGenomeConfig &config);
+
+    // Delete a random non-output node and its connections. Returns the deleted
+    // key, or -1 if there was nothing to delete.
+    int mutate_delete_node(const DefaultGenomeConfig &config);
+
+    void mutate_delete_connection();
+
+    void add_connection(const DefaultGenomeConfig &config, int input_key, int output_key,
+                        float weight, bool enabled);
+
+    // Genetic distance used for speciation.
+    double distance(const DefaultGenome &other, const DefaultGenomeConfig &config) const;
+
+    // Returns (number of nodes, number of enabled connections).
+    std::pair<int, int> size() const;
+
+    // Hash of everything that shapes a phenotype: node keys with their
+    // activation and aggregation, connection keys and enabled flags. Genomes
+    // that differ only in weights, biases or responses hash equal.
+    uint64_t topology_hash() const;
+
+    std::string to_string() const;
+
+    // Compact binary encoding of the genome, used for pickling.
+    std::string serialize() const;
+    static DefaultGenome deserialize(const std::string &data);
+
+   private:
+    // Throws std::runtime_error if a writable view pins any gene column, before
+    // a structural change could leave the genome half-updated.
+    void check_unpinned() const;
+
+    std::vector<std::pair<int, int>> compute_full_connections(const DefaultGenomeConfig &config,
+                                                              bool direct) const;
+    void connect_fs_neat_nohidden(const DefaultGenomeConfig &config);
+    void connect_fs_neat_hidden(const DefaultGenomeConfig &config);
+    void connect_full(const DefaultGenomeConfig &config, bool direct);
+    void connect_partial(const DefaultGenomeConfig &config, bool direct);
 };
 
-// Utility function to get a pruned copy of the genome.
-// (A full implementation would remove nodes/connections not required for outputs.)
+// Returns a copy of the genome holding only the nodes required for the outputs
+// and the enabled connections between them.
 DefaultGenome get_pruned_copy(const DefaultGenome &genome, const std::vector<int> &input_keys,
                               const std::vector<int> &output_keys);
 
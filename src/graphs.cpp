@@ -0,0 +1,86 @@
+#include "graphs.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+bool creates_cycle(const std::vector<std::pair<int, int>>& connections,
+                   const std::pair<int, int>& test) {
+    const auto [i, o] = test;
+    if (i == o) return true;
+
+    std::unordered_map<int, std::vector<int>> successors;
+    for (const auto& [a, b] : connections) successors[a].push_back(b);
+
+    // Walk forward from the new connection's output; reaching its input closes a loop.
+    std::unordered_set<int> visited{o};
+    std::vector<int> stack{o};
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        auto it = successors.find(node);
+        if (it == successors.end()) continue;
+        for (int next : it->second) {
+            if (next == i) return true;
+            if (visited.insert(next).second) stack.push_back(next);
+        }
+    }
+    return false;
+}
+
+std::unordered_set<int> required_for_output(const std::vector<int>& inputs,
+                                            const std::vector<int>& outputs,
+                                            const std::vector<std::pair<int, int>>& connections) {
+    std::unordered_set<int> input_set(inputs.begin(), inputs.end());
+    std::unordered_map<int, std::vector<int>> predecessors;
+    for (const auto& [a, b] : connections) predecessors[b].push_back(a);
+
+    std::unordered_set<int> required(outputs.begin(), outputs.end());
+    std::vector<int> stack(outputs.begin(), outputs.end());
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        auto it = predecessors.find(node);
+        if (it == predecessors.end()) continue;
+        for (int prev : it->second) {
+            if (input_set.count(prev)) continue;
+            if (required.insert(prev).second) stack.push_back(prev);
+        }
+    }
+    return required;
+}
+
+std::vector<std::vector<int>> feed_forward_layers(
+    const std::vector<int>& inputs, const std::vector<int>& outputs,
+    const std::vector<std::pair<int, int>>& connections) {
+    std::unordered_set<int> required = required_for_output(inputs, outputs, connections);
+
+    // Every predecessor of a required node is an input or itself required, so a
+    // layered topological sort restricted to required nodes matches graphs.py.
+    std::unordered_map<int, std::vector<int>> successors;
+    std::unordered_map<int, int> pending;
+    for (const auto& [a, b] : connections) {
+        successors[a].push_back(b);
+        pending[b]++;
+    }
+
+    std::unordered_set<int> evaluated(inputs.begin(), inputs.end());
+    std::vector<std::vector<int>> layers;
+    std::vector<int> frontier(evaluated.begin(), evaluated.end());
+    while (true) {
+        std::vector<int> layer;
+        for (int node : frontier) {
+            auto it = successors.find(node);
+            if (it == successors.end()) continue;
+            for (int next : it->second) {
+                if (--pending[next] == 0 && required.count(next) && !evaluated.count(next))
+                    layer.push_back(next);
+            }
+        }
+        if (layer.empty()) break;
+        std::sort(layer.begin(), layer.end());
+        evaluated.insert(layer.begin(), layer.end());
+        frontier = layer;
+        layers.push_back(std::move(layer));
+    }
+    return layers;
+}
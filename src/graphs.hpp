@@ -0,0 +1,28 @@
+#ifndef GRAPHS_HPP
+#define GRAPHS_HPP
+
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Directed graph algorithms over (input, output) connection keys; mirrors
+// neat3p/graphs.py.
+
+// Returns true if adding the `test` connection would create a cycle, assuming
+// that no cycle already exists in the graph represented by `connections`.
+bool creates_cycle(const std::vector<std::pair<int, int>>& connections,
+                   const std::pair<int, int>& test);
+
+// Collects the nodes whose state is required to compute the network outputs.
+// Input keys are never part of the result; output keys always are.
+std::unordered_set<int> required_for_output(const std::vector<int>& inputs,
+                                            const std::vector<int>& outputs,
+                                            const std::vector<std::pair<int, int>>& connections);
+
+// Groups the required nodes into layers whose members can be evaluated in
+// parallel in a feed-forward network. Nodes within a layer are sorted by key.
+std::vector<std::vector<int>> feed_forward_layers(
+    const std::vector<int>& inputs, const std::vector<int>& outputs,
+    const std::vector<std::pair<int, int>>& connections);
+
+#endif  // GRAPHS_HPP
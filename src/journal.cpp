@@ -0,0 +1,449 @@
+#include "journal.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr char kJournalMagic[4] = {'N', '3', 'P', 'J'};
+constexpr uint32_t kJournalFormatVersion = 1;
+constexpr size_t kHeaderSize = sizeof(kJournalMagic) + sizeof(uint32_t);
+constexpr size_t kRecordHeaderSize = sizeof(uint32_t) + sizeof(uint8_t);
+
+enum RecordType : uint8_t {
+    kNameRecord = 1,        // uint16 id, uint16 length, bytes
+    kGenomeRecord = 2,      // key, generation, parent1, parent2, base, then the delta
+    kEvaluationRecord = 3,  // key, generation, species, uint8 has_fitness, double fitness
+    kGenerationRecord = 4,  // generation
+};
+
+// Delta layout, each section prefixed by a uint32 count:
+//   removed node keys        int32
+//   added or changed nodes   int32 key, float bias, float response, uint16 activation,
+//                            uint16 aggregation (ids into the name table)
+//   removed connection keys  int32 input, int32 output
+//   added or changed conns   int32 input, int32 output, float weight, uint8 enabled
+
+template <typename T>
+void put(std::string &out, const T &value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// Reads fixed-size values from a mapped byte range.
+class Cursor {
+   public:
+    Cursor(const char *data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    T get() {
+        if (pos_ + sizeof(T) > size_) throw std::runtime_error("Truncated journal record");
+        T value;
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    std::string get_string() {
+        uint16_t n = get<uint16_t>();
+        if (pos_ + n > size_) throw std::runtime_error("Truncated journal record");
+        std::string value(data_ + pos_, n);
+        pos_ += n;
+        return value;
+    }
+
+   private:
+    const char *data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+bool same_node(const NodeGeneTable &a, size_t i, const NodeGeneTable &b, size_t j) {
+    return a.bias[i] == b.bias[j] && a.response[i] == b.response[j] &&
+           a.activation[i] == b.activation[j] && a.aggregation[i] == b.aggregation[j];
+}
+
+bool same_connection(const ConnectionGeneTable &a, size_t i, const ConnectionGeneTable &b,
+                     size_t j) {
+    return a.weight[i] == b.weight[j] && a.enabled[i] == b.enabled[j];
+}
+
+// Rows of the sorted key columns `from` and `to`: those only in `from` go to
+// `removed`, those only in `to` or differing per `same` go to `changed`.
+template <typename Key, typename Same>
+void diff_rows(const std::vector<Key> &from, const std::vector<Key> &to, Same same,
+               std::vector<size_t> &removed, std::vector<size_t> &changed) {
+    size_t i = 0, j = 0;
+    while (i < from.size() || j < to.size()) {
+        if (j == to.size() || (i < from.size() && from[i] < to[j])) {
+            removed.push_back(i++);
+        }
+        else if (i == from.size() || to[j] < from[i]) {
+            changed.push_back(j++);
+        }
+        else {
+            if (!same(i, j)) changed.push_back(j);
+            i++;
+            j++;
+        }
+    }
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// JournalWriter
+// ---------------------------------------------------------------------------
+JournalWriter::JournalWriter(const std::string &path, int keyframe_interval)
+    : path_(path), keyframe_interval_(keyframe_interval) {
+    if (keyframe_interval_ < 1) throw std::invalid_argument("keyframe_interval must be positive");
+
+    struct stat st;
+    bool exists = ::stat(path.c_str(), &st) == 0 && st.st_size > 0;
+    size_t valid_size = 0;
+    if (exists) {
+        // Continue an existing journal: names keep their ids. Genomes of the
+        // earlier run are not cached, so the first ones recorded are keyframes.
+        JournalReader reader(path);
+        for (size_t id = 0; id < reader.names().size(); id++)
+            names_.emplace(reader.names()[id], static_cast<uint16_t>(id));
+        valid_size = reader.valid_size();
+    }
+
+    file_ = std::fopen(path.c_str(), "ab");
+    if (file_ == nullptr) throw std::runtime_error("Cannot open journal " + path);
+    // Drop a partially written last record, which would otherwise swallow the
+    // header of the first record appended after it.
+    if (exists && valid_size < static_cast<size_t>(st.st_size) &&
+        ::ftruncate(::fileno(file_), static_cast<off_t>(valid_size)) != 0) {
+        std::fclose(file_);
+        file_ = nullptr;
+        throw std::runtime_error("Cannot truncate journal " + path);
+    }
+    if (!exists) {
+        buffer_.append(kJournalMagic, sizeof(kJournalMagic));
+        put<uint32_t>(buffer_, kJournalFormatVersion);
+        flush();
+    }
+}
+
+JournalWriter::~JournalWriter() {
+    if (file_ == nullptr) return;
+    try {
+        flush();
+    }
+    catch (...) {
+    }
+    std::fclose(file_);
+}
+
+const JournalWriter::Cached *JournalWriter::find_cached(int key) const {
+    auto it = current_.find(key);
+    if (it != current_.end()) return &it->second;
+    it = previous_.find(key);
+    return it != previous_.end() ? &it->second : nullptr;
+}
+
+uint16_t JournalWriter::name_id(const std::string &name) {
+    auto it = names_.find(name);
+    if (it != names_.end()) return it->second;
+    if (names_.size() > UINT16_MAX) throw std::length_error("Too many distinct journal names");
+    uint16_t id = static_cast<uint16_t>(names_.size());
+    names_.emplace(name, id);
+
+    put<uint32_t>(buffer_, static_cast<uint32_t>(2 * sizeof(uint16_t) + name.size()));
+    put<uint8_t>(buffer_, kNameRecord);
+    put<uint16_t>(buffer_, id);
+    put<uint16_t>(buffer_, static_cast<uint16_t>(name.size()));
+    buffer_.append(name);
+    return id;
+}
+
+void JournalWriter::record(const DefaultGenome &genome, int generation, int parent1, int parent2,
+                           int species) {
+    const Cached *known = find_cached(genome.key);
+    if (known == nullptr) {
+        const Cached *base = parent1 >= 0 ? find_cached(parent1) : nullptr;
+        if (base != nullptr && base->depth + 1 >= keyframe_interval_) base = nullptr;
+        int depth = base != nullptr ? base->depth + 1 : 0;
+        write_genome(genome, generation, parent1, parent2, base);
+        current_.insert_or_assign(genome.key, Cached{genome, depth});
+    }
+    else if (!current_.count(genome.key)) {
+        // Alive again (e.g. an elite): keep it around as a delta base.
+        current_.insert_or_assign(genome.key, *known);
+    }
+
+    put<uint32_t>(buffer_, 3 * sizeof(int32_t) + sizeof(uint8_t) + sizeof(double));
+    put<uint8_t>(buffer_, kEvaluationRecord);
+    put<int32_t>(buffer_, genome.key);
+    put<int32_t>(buffer_, generation);
+    put<int32_t>(buffer_, species);
+    put<uint8_t>(buffer_, genome.fitness.has_value() ? 1 : 0);
+    put<double>(buffer_, genome.fitness.value_or(0.0));
+}
+
+void JournalWriter::write_genome(const DefaultGenome &genome, int generation, int parent1,
+                                 int parent2, const Cached *base) {
+    static const DefaultGenome kEmpty(-1);
+    const DefaultGenome &from = base != nullptr ? base->genome : kEmpty;
+    const NodeGeneTable &fn = from.nodes;
+    const NodeGeneTable &tn = genome.nodes;
+    const ConnectionGeneTable &fc = from.connections;
+    const ConnectionGeneTable &tc = genome.connections;
+
+    std::vector<size_t> nodes_removed, nodes_changed, conns_removed, conns_changed;
+    diff_rows(
+        fn.keys.get(), tn.keys.get(), [&](size_t i, size_t j) { return same_node(fn, i, tn, j); },
+        nodes_removed, nodes_changed);
+    diff_rows(
+        fc.keys.get(), tc.keys.get(),
+        [&](size_t i, size_t j) { return same_connection(fc, i, tc, j); }, conns_removed,
+        conns_changed);
+
+    // Names are registered before the genome record that refers to them.
+    std::vector<std::pair<uint16_t, uint16_t>> name_ids;
+    name_ids.reserve(nodes_changed.size());
+    for (size_t j : nodes_changed)
+        name_ids.emplace_back(name_id(tn.activation[j]), name_id(tn.aggregation[j]));
+
+    std::string payload;
+    put<int32_t>(payload, genome.key);
+    put<int32_t>(payload, generation);
+    put<int32_t>(payload, parent1);
+    put<int32_t>(payload, parent2);
+    put<int32_t>(payload, base != nullptr ? base->genome.key : -1);
+
+    put<uint32_t>(payload, static_cast<uint32_t>(nodes_removed.size()));
+    for (size_t i : nodes_removed) put<int32_t>(payload, fn.keys[i]);
+    put<uint32_t>(payload, static_cast<uint32_t>(nodes_changed.size()));
+    for (size_t n = 0; n < nodes_changed.size(); n++) {
+        size_t j = nodes_changed[n];
+        put<int32_t>(payload, tn.keys[j]);
+        put<float>(payload, tn.bias[j]);
+        put<float>(payload, tn.response[j]);
+        put<uint16_t>(payload, name_ids[n].first);
+        put<uint16_t>(payload, name_ids[n].second);
+    }
+    put<uint32_t>(payload, static_cast<uint32_t>(conns_removed.size()));
+    for (size_t i : conns_removed) {
+        put<int32_t>(payload, fc.keys[i].first);
+        put<int32_t>(payload, fc.keys[i].second);
+    }
+    put<uint32_t>(payload, static_cast<uint32_t>(conns_changed.size()));
+    for (size_t j : conns_changed) {
+        put<int32_t>(payload, tc.keys[j].first);
+        put<int32_t>(payload, tc.keys[j].second);
+        put<float>(payload, tc.weight[j]);
+        put<uint8_t>(payload, tc.enabled[j]);
+    }
+
+    put<uint32_t>(buffer_, static_cast<uint32_t>(payload.size()));
+    put<uint8_t>(buffer_, kGenomeRecord);
+    buffer_.append(payload);
+}
+
+void JournalWriter::end_generation(int generation) {
+    put<uint32_t>(buffer_, sizeof(int32_t));
+    put<uint8_t>(buffer_, kGenerationRecord);
+    put<int32_t>(buffer_, generation);
+    previous_ = std::move(current_);
+    current_.clear();
+    flush();
+}
+
+void JournalWriter::flush() {
+    if (!buffer_.empty() &&
+        std::fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size())
+        throw std::runtime_error("Cannot write journal " + path_);
+    buffer_.clear();
+    if (std::fflush(file_) != 0) throw std::runtime_error("Cannot write journal " + path_);
+}
+
+// ---------------------------------------------------------------------------
+// JournalReader
+// ---------------------------------------------------------------------------
+JournalReader::JournalReader(const std::string &path) : path_(path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open journal " + path);
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat journal " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map journal " + path);
+        }
+        data_ = static_cast<const char *>(mapped);
+    }
+    ::close(fd);
+
+    auto fail = [this](const std::string &message) {
+        if (data_ != nullptr) ::munmap(const_cast<char *>(data_), size_);
+        data_ = nullptr;
+        throw std::runtime_error(message);
+    };
+    if (size_ < kHeaderSize || std::memcmp(data_, kJournalMagic, sizeof(kJournalMagic)) != 0)
+        fail("Not a genome journal: " + path);
+    uint32_t version;
+    std::memcpy(&version, data_ + sizeof(kJournalMagic), sizeof(version));
+    if (version != kJournalFormatVersion)
+        fail("Unsupported journal format version " + std::to_string(version));
+
+    size_t pos = kHeaderSize;
+    while (pos + kRecordHeaderSize <= size_) {
+        uint32_t length;
+        std::memcpy(&length, data_ + pos, sizeof(length));
+        uint8_t type = static_cast<uint8_t>(data_[pos + sizeof(length)]);
+        size_t payload = pos + kRecordHeaderSize;
+        if (payload + length > size_) break;  // partially written record
+        Cursor cursor(data_ + payload, length);
+
+        if (type == kNameRecord) {
+            uint16_t id = cursor.get<uint16_t>();
+            if (id != names_.size()) fail("Corrupt journal name table");
+            names_.push_back(cursor.get_string());
+        }
+        else if (type == kGenomeRecord) {
+            Entry e;
+            e.offset = payload;
+            e.info.key = cursor.get<int32_t>();
+            e.info.generation = cursor.get<int32_t>();
+            e.info.parent1 = cursor.get<int32_t>();
+            e.info.parent2 = cursor.get<int32_t>();
+            e.base = cursor.get<int32_t>();
+            e.info.species = -1;
+            if (genomes_.insert_or_assign(e.info.key, e).second) keys_.push_back(e.info.key);
+        }
+        else if (type == kEvaluationRecord) {
+            int32_t key = cursor.get<int32_t>();
+            int32_t generation = cursor.get<int32_t>();
+            int32_t species = cursor.get<int32_t>();
+            bool has_fitness = cursor.get<uint8_t>() != 0;
+            double fitness = cursor.get<double>();
+            auto it = genomes_.find(key);
+            if (it != genomes_.end()) {
+                it->second.info.species = species;
+                it->second.info.fitness =
+                    has_fitness ? std::optional<double>(fitness) : std::nullopt;
+            }
+            auto [span, added] = generation_spans_.emplace(generation, std::make_pair(pos, pos));
+            if (added) generation_ids_.push_back(generation);
+            span->second.second = payload + length;
+        }
+        pos = payload + length;
+    }
+    valid_size_ = pos;
+}
+
+JournalReader::~JournalReader() {
+    if (data_ != nullptr) ::munmap(const_cast<char *>(data_), size_);
+    data_ = nullptr;
+}
+
+const JournalReader::Entry &JournalReader::entry(int key) const {
+    auto it = genomes_.find(key);
+    if (it == genomes_.end())
+        throw std::out_of_range("genome " + std::to_string(key) + " not in journal");
+    return it->second;
+}
+
+JournalGenomeInfo JournalReader::info(int key) const { return entry(key).info; }
+
+void JournalReader::apply_delta(size_t offset, DefaultGenome &genome) const {
+    Cursor cursor(data_ + offset, size_ - offset);
+    for (int i = 0; i < 5; i++) cursor.get<int32_t>();
+
+    auto name = [&](uint16_t id) -> const std::string & {
+        if (id >= names_.size()) throw std::runtime_error("Corrupt journal name id");
+        return names_[id];
+    };
+
+    uint32_t n = cursor.get<uint32_t>();
+    for (uint32_t i = 0; i < n; i++) genome.nodes.erase(cursor.get<int32_t>());
+    n = cursor.get<uint32_t>();
+    for (uint32_t i = 0; i < n; i++) {
+        DefaultNodeGene node(cursor.get<int32_t>());
+        node.bias = cursor.get<float>();
+        node.response = cursor.get<float>();
+        node.activation = name(cursor.get<uint16_t>());
+        node.aggregation = name(cursor.get<uint16_t>());
+        genome.nodes.insert(node);
+    }
+    n = cursor.get<uint32_t>();
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t input = cursor.get<int32_t>();
+        int32_t output = cursor.get<int32_t>();
+        genome.connections.erase({input, output});
+    }
+    n = cursor.get<uint32_t>();
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t input = cursor.get<int32_t>();
+        int32_t output = cursor.get<int32_t>();
+        DefaultConnectionGene conn({input, output});
+        conn.weight = cursor.get<float>();
+        conn.enabled = cursor.get<uint8_t>() != 0;
+        genome.connections.insert(conn);
+    }
+}
+
+DefaultGenome JournalReader::genome(int key) const {
+    std::vector<size_t> chain;
+    for (const Entry *e = &entry(key);; e = &entry(e->base)) {
+        chain.push_back(e->offset);
+        if (e->base < 0) break;
+        if (chain.size() > genomes_.size()) throw std::runtime_error("Corrupt journal delta chain");
+    }
+
+    const Entry &target = entry(key);
+    DefaultGenome genome(key);
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) apply_delta(*it, genome);
+    genome.fitness = target.info.fitness;
+    return genome;
+}
+
+std::vector<int32_t> JournalReader::lineage(int key) const {
+    std::vector<int32_t> out{key};
+    for (const Entry *e = &entry(key); e->info.parent1 >= 0 && contains(e->info.parent1);
+         e = &entry(e->info.parent1)) {
+        out.push_back(e->info.parent1);
+        if (out.size() > genomes_.size()) throw std::runtime_error("Corrupt journal lineage");
+    }
+    return out;
+}
+
+std::vector<JournalEvaluation> JournalReader::evaluations(int generation) const {
+    std::vector<JournalEvaluation> out;
+    auto span = generation_spans_.find(generation);
+    if (span == generation_spans_.end()) return out;
+
+    size_t pos = span->second.first;
+    while (pos < span->second.second) {
+        uint32_t length;
+        std::memcpy(&length, data_ + pos, sizeof(length));
+        uint8_t type = static_cast<uint8_t>(data_[pos + sizeof(length)]);
+        size_t payload = pos + kRecordHeaderSize;
+        if (type == kEvaluationRecord) {
+            Cursor cursor(data_ + payload, length);
+            JournalEvaluation ev;
+            ev.key = cursor.get<int32_t>();
+            ev.generation = cursor.get<int32_t>();
+            ev.species = cursor.get<int32_t>();
+            bool has_fitness = cursor.get<uint8_t>() != 0;
+            double fitness = cursor.get<double>();
+            if (has_fitness) ev.fitness = fitness;
+            if (ev.generation == generation) out.push_back(ev);
+        }
+        pos = payload + length;
+    }
+    return out;
+}
@@ -0,0 +1,144 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "genome.hpp"
+
+// ---------------------------------------------------------------------------
+// Genome journal: an append-only binary log of a run. Each genome is written
+// once, when first seen, as a delta against its first parent (or in full, as a
+// keyframe, when the parent is unknown or the delta chain gets long); every
+// generation it is alive adds a small evaluation record with its fitness and
+// species. The writer only keeps the genomes of the last two generations in
+// memory, and the reader maps the file instead of loading it.
+//
+// Layout: the magic "N3PJ" and a uint32 format version, then records of
+// [uint32 payload size][uint8 type][payload], little-endian like
+// DefaultGenome::serialize. A truncated last record (e.g. after a crash) is
+// ignored by the reader, and cut off by a writer that continues the journal.
+// ---------------------------------------------------------------------------
+
+struct JournalEvaluation {
+    int32_t key;
+    int32_t generation;
+    int32_t species;
+    std::optional<double> fitness;
+};
+
+struct JournalGenomeInfo {
+    int32_t key;
+    int32_t generation;  // generation it was first recorded in
+    int32_t parent1;     // -1 if none
+    int32_t parent2;
+    int32_t species;     // from its latest evaluation
+    std::optional<double> fitness;
+};
+
+class JournalWriter {
+   public:
+    // Opens `path` for appending, creating it if needed. A delta chain never
+    // gets longer than keyframe_interval, which bounds the cost of a replay.
+    explicit JournalWriter(const std::string &path, int keyframe_interval = 32);
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter &) = delete;
+    JournalWriter &operator=(const JournalWriter &) = delete;
+
+    // Records that `genome` is alive in `generation`, with its fitness and
+    // species. The genome itself is written the first time its key is seen;
+    // the parents are only used then. Parents must have been recorded in this
+    // or the previous generation to be used as a delta base.
+    void record(const DefaultGenome &genome, int generation, int parent1, int parent2,
+                int species);
+
+    // Closes a generation: writes a marker, forgets the genomes of the one
+    // before it and flushes to disk.
+    void end_generation(int generation);
+
+    void flush();
+
+    const std::string &path() const { return path_; }
+
+   private:
+    struct Cached {
+        DefaultGenome genome;
+        int depth;  // deltas since the last keyframe
+    };
+
+    const Cached *find_cached(int key) const;
+    uint16_t name_id(const std::string &name);
+    void write_genome(const DefaultGenome &genome, int generation, int parent1, int parent2,
+                      const Cached *base);
+
+    std::string path_;
+    std::FILE *file_ = nullptr;
+    int keyframe_interval_;
+    std::string buffer_;
+    std::unordered_map<std::string, uint16_t> names_;
+    std::unordered_map<int, Cached> current_;
+    std::unordered_map<int, Cached> previous_;
+};
+
+class JournalReader {
+   public:
+    // Maps `path` read-only and indexes its records. Records appended after
+    // opening are not visible.
+    explicit JournalReader(const std::string &path);
+    ~JournalReader();
+
+    JournalReader(const JournalReader &) = delete;
+    JournalReader &operator=(const JournalReader &) = delete;
+
+    size_t num_genomes() const { return genomes_.size(); }
+    // Generations that have evaluation records, in order of appearance.
+    const std::vector<int32_t> &generations() const { return generation_ids_; }
+    const std::vector<std::string> &names() const { return names_; }
+    // File offset just past the last complete record.
+    size_t valid_size() const { return valid_size_; }
+    bool contains(int key) const { return genomes_.count(key) != 0; }
+
+    // Keys of every recorded genome, in recording order.
+    std::vector<int32_t> keys() const { return keys_; }
+
+    JournalGenomeInfo info(int key) const;
+
+    // Rebuilds the genome by replaying its deltas from the nearest keyframe.
+    // Its fitness is the one of its latest evaluation.
+    DefaultGenome genome(int key) const;
+
+    // First parents, from `key` back to a genome without parents.
+    std::vector<int32_t> lineage(int key) const;
+
+    // Every evaluation written for `generation`.
+    std::vector<JournalEvaluation> evaluations(int generation) const;
+
+   private:
+    struct Entry {
+        size_t offset;  // of the genome record payload
+        int32_t base;   // delta base key, -1 for a keyframe
+        JournalGenomeInfo info;
+    };
+
+    const Entry &entry(int key) const;
+    void apply_delta(size_t offset, DefaultGenome &genome) const;
+
+    std::string path_;
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+    size_t valid_size_ = 0;
+    std::vector<std::string> names_;
+    std::unordered_map<int, Entry> genomes_;
+    std::vector<int32_t> keys_;
+    // The evaluation records of generation g lie within [begin, end) of the file.
+    std::unordered_map<int32_t, std::pair<size_t, size_t>> generation_spans_;
+    std::vector<int32_t> generation_ids_;
+};
+
+#endif  // JOURNAL_HPP
@@ -0,0 +1,143 @@
+#include "migration.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kRingMagic[4] = {'N', '3', 'P', 'R'};
+constexpr uint32_t kRingFormatVersion = 1;
+constexpr uint32_t kWrapMarker = UINT32_MAX;
+constexpr size_t kLengthSize = sizeof(uint32_t);
+
+size_t align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+}  // namespace
+
+// The producer and consumer counters live on separate cache lines.
+struct MigrationRing::Header {
+    char magic[4];
+    uint32_t version;
+    uint64_t capacity;
+    alignas(64) uint64_t head;
+    alignas(64) uint64_t tail;
+};
+
+static_assert(std::atomic_ref<uint64_t>::is_always_lock_free,
+              "migration rings need lock-free 64-bit atomics");
+
+MigrationRing::MigrationRing(const std::string &path, size_t capacity, bool create)
+    : path_(path) {
+    const size_t header_size = align8(sizeof(Header));
+    int fd = create ? ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600)
+                    : ::open(path.c_str(), O_RDWR);
+    if (fd < 0) throw std::runtime_error("Cannot open migration ring " + path);
+
+    if (create) {
+        capacity = align8(capacity);
+        if (capacity < 64) {
+            ::close(fd);
+            throw std::invalid_argument("migration ring capacity must be at least 64 bytes");
+        }
+        mapped_size_ = header_size + capacity;
+        if (::ftruncate(fd, static_cast<off_t>(mapped_size_)) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot size migration ring " + path);
+        }
+    }
+    else {
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < header_size) {
+            ::close(fd);
+            throw std::runtime_error("Not a migration ring: " + path);
+        }
+        mapped_size_ = static_cast<size_t>(st.st_size);
+    }
+
+    void *mapped = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) throw std::runtime_error("Cannot map migration ring " + path);
+    header_ = static_cast<Header *>(mapped);
+    data_ = static_cast<char *>(mapped) + header_size;
+
+    if (create) {
+        std::memcpy(header_->magic, kRingMagic, sizeof(kRingMagic));
+        header_->version = kRingFormatVersion;
+        header_->capacity = capacity;
+        std::atomic_ref<uint64_t>(header_->head).store(0, std::memory_order_relaxed);
+        std::atomic_ref<uint64_t>(header_->tail).store(0, std::memory_order_release);
+    }
+    else if (std::memcmp(header_->magic, kRingMagic, sizeof(kRingMagic)) != 0 ||
+             header_->version != kRingFormatVersion ||
+             header_size + header_->capacity > mapped_size_) {
+        ::munmap(mapped, mapped_size_);
+        throw std::runtime_error("Not a migration ring: " + path);
+    }
+    capacity_ = header_->capacity;
+}
+
+MigrationRing::~MigrationRing() {
+    if (header_ != nullptr) ::munmap(header_, mapped_size_);
+}
+
+size_t MigrationRing::used() const {
+    const uint64_t head = std::atomic_ref<uint64_t>(header_->head).load(std::memory_order_acquire);
+    const uint64_t tail = std::atomic_ref<uint64_t>(header_->tail).load(std::memory_order_acquire);
+    return static_cast<size_t>(head - tail);
+}
+
+bool MigrationRing::push(const char *data, size_t n) {
+    const size_t needed = align8(kLengthSize + n);
+    if (needed > capacity_)
+        throw std::invalid_argument("message of " + std::to_string(n) +
+                                    " bytes does not fit in migration ring " + path_);
+
+    std::atomic_ref<uint64_t> head_ref(header_->head);
+    const uint64_t head = head_ref.load(std::memory_order_relaxed);
+    const uint64_t tail = std::atomic_ref<uint64_t>(header_->tail).load(std::memory_order_acquire);
+    const size_t offset = static_cast<size_t>(head % capacity_);
+    const size_t to_end = capacity_ - offset;
+    // Positions stay 8-aligned, so there is always room for a wrap marker.
+    const size_t skip = needed > to_end ? to_end : 0;
+    if (skip + needed > capacity_ - static_cast<size_t>(head - tail)) return false;
+
+    size_t at = offset;
+    if (skip > 0) {
+        std::memcpy(data_ + offset, &kWrapMarker, kLengthSize);
+        at = 0;
+    }
+    const uint32_t length = static_cast<uint32_t>(n);
+    std::memcpy(data_ + at, &length, kLengthSize);
+    std::memcpy(data_ + at + kLengthSize, data, n);
+    head_ref.store(head + skip + needed, std::memory_order_release);
+    return true;
+}
+
+bool MigrationRing::pop(std::string &out) {
+    std::atomic_ref<uint64_t> tail_ref(header_->tail);
+    uint64_t tail = tail_ref.load(std::memory_order_relaxed);
+    const uint64_t head = std::atomic_ref<uint64_t>(header_->head).load(std::memory_order_acquire);
+    if (tail == head) return false;
+
+    size_t offset = static_cast<size_t>(tail % capacity_);
+    uint32_t length;
+    std::memcpy(&length, data_ + offset, kLengthSize);
+    if (length == kWrapMarker) {
+        // The message after a wrap marker is published together with it.
+        tail += capacity_ - offset;
+        offset = 0;
+        std::memcpy(&length, data_, kLengthSize);
+    }
+    const size_t needed = align8(kLengthSize + length);
+    if (needed > capacity_ || tail + needed > head)
+        throw std::runtime_error("Corrupt migration ring " + path_);
+    out.assign(data_ + offset + kLengthSize, length);
+    tail_ref.store(tail + needed, std::memory_order_release);
+    return true;
+}
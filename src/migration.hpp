@@ -0,0 +1,52 @@
+#ifndef MIGRATION_HPP
+#define MIGRATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// MigrationRing: a lock-free single-producer / single-consumer queue of byte
+// messages (serialized genomes) in a memory-mapped file, shared between two
+// processes. Each message is a u32 length and its payload, padded to 8 bytes;
+// a message that does not fit before the end of the buffer is preceded by a
+// wrap marker and written at the start instead.
+//
+// The producer only writes `head` and the consumer only writes `tail`, both
+// monotonically increasing byte counts, so neither side ever waits on the
+// other: push() fails when the ring is full and pop() when it is empty.
+// ---------------------------------------------------------------------------
+class MigrationRing {
+   public:
+    // Creates the ring file at `path` with room for `capacity` bytes of
+    // messages (rounded up to a multiple of 8), or attaches to an existing
+    // one when `create` is false.
+    MigrationRing(const std::string &path, size_t capacity, bool create);
+    ~MigrationRing();
+
+    MigrationRing(const MigrationRing &) = delete;
+    MigrationRing &operator=(const MigrationRing &) = delete;
+
+    const std::string &path() const { return path_; }
+    size_t capacity() const { return capacity_; }
+    // Bytes currently queued, including padding.
+    size_t used() const;
+
+    // Producer side. Returns false, dropping the message, if it does not fit
+    // in the free space; throws if it could never fit.
+    bool push(const char *data, size_t n);
+
+    // Consumer side. Returns false if the ring is empty.
+    bool pop(std::string &out);
+
+   private:
+    struct Header;
+
+    std::string path_;
+    Header *header_ = nullptr;
+    char *data_ = nullptr;
+    size_t capacity_ = 0;
+    size_t mapped_size_ = 0;
+};
+
+#endif  // MIGRATION_HPP
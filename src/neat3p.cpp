@@ -5,25 +5,127 @@
 #define ENTT_ENTITY_TYPE int
 
 #include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
 #include <nanobind/operators.h>
 #include <nanobind/stl/bind_map.h>
 #include <nanobind/stl/bind_vector.h>
 #include <nanobind/stl/map.h>
 #include <nanobind/stl/optional.h>
+#include <nanobind/stl/pair.h>
+#include <nanobind/stl/shared_ptr.h>
 #include <nanobind/stl/string.h>
 #include <nanobind/stl/unique_ptr.h>
 #include <nanobind/stl/variant.h>
 #include <nanobind/stl/vector.h>
 #include <spdlog/spdlog.h>
 
+#include <cmath>
 #include <cstdint>
+#include <map>
+#include <new>
 
 #include "config.hpp"
+#include "connectivity.hpp"
+#include "distance_cache.hpp"
 #include "genes.hpp"
+#include "genome.hpp"
+#include "journal.hpp"
+#include "migration.hpp"
+#include "novelty.hpp"
+#include "packed_net.hpp"
+#include "population.hpp"
+#include "quantized.hpp"
+#include "sparse_layer.hpp"
+#include "streaming_stats.hpp"
 
 // Create a shortcut for nanobind
 namespace nb = nanobind;
 
+// One-dimensional NumPy view over a gene table column.
+template <typename T>
+using Column = nb::ndarray<nb::numpy, T, nb::ndim<1>, nb::c_contig>;
+
+template <typename T>
+Column<T> column(T *data, size_t n, nb::handle owner = nb::handle()) {
+    return Column<T>(data, {n}, owner);
+}
+
+// Moves `value` to the heap and returns a capsule that deletes it, for use as
+// the owner of arrays viewing its members. NumPy arrays implement __dlpack__,
+// so torch.from_dlpack() adopts them without a copy.
+template <typename T>
+nb::capsule heap_owner(T *&ptr, T &&value) {
+    ptr = new T(std::move(value));
+    return nb::capsule(ptr, [](void *p) noexcept { delete static_cast<T *>(p); });
+}
+
+// Read-only view over a copy-on-write gene column. The view's owner holds a
+// snapshot of the column, which stays shared with the genome's relatives and
+// is left unchanged by later writes to the genome.
+template <typename T, typename U = T>
+Column<const U> snapshot_column(const CowVector<T> &values) {
+    std::shared_ptr<const std::vector<T>> *snapshot;
+    nb::capsule owner = heap_owner(snapshot, values.snapshot());
+    return column(reinterpret_cast<const U *>((*snapshot)->data()), (*snapshot)->size(), owner);
+}
+
+// Writable view over a copy-on-write gene column; the view's owner holds the
+// pin that keeps the column unshared.
+template <typename T, typename U = T>
+Column<U> pinned_column(CowVector<T> &values) {
+    std::shared_ptr<T> *pin;
+    nb::capsule owner = heap_owner(pin, values.pin());
+    return column(reinterpret_cast<U *>(pin->get()), values.size(), owner);
+}
+
+using KeyColumn = nb::ndarray<nb::numpy, const int, nb::shape<-1, 2>, nb::c_contig>;
+
+// Key-addressed proxies handed out by the genome's mapping views. They hold a
+// reference to the Python genome object, and every access looks the key up
+// again, so a proxy never dangles; it raises KeyError once its gene is gone.
+struct NodeGeneRef {
+    nb::object owner;
+    DefaultGenome *genome;
+    int key;
+
+    size_t row() const {
+        std::ptrdiff_t r = genome->nodes.find(key);
+        if (r < 0) throw nb::key_error(std::to_string(key).c_str());
+        return static_cast<size_t>(r);
+    }
+};
+
+struct ConnectionGeneRef {
+    nb::object owner;
+    DefaultGenome *genome;
+    std::pair<int, int> key;
+
+    size_t row() const {
+        std::ptrdiff_t r = genome->connections.find(key);
+        if (r < 0) throw nb::key_error("connection not found");
+        return static_cast<size_t>(r);
+    }
+};
+
+// dict-like views over DefaultGenome.nodes / DefaultGenome.connections.
+struct NodeGeneMap {
+    nb::object owner;
+    DefaultGenome *genome;
+};
+
+struct ConnectionGeneMap {
+    nb::object owner;
+    DefaultGenome *genome;
+};
+
+// Builds an instance of type(self) holding `genome`, so Python subclasses of
+// DefaultGenome get their own type back.
+static nb::object same_type(const DefaultGenome &self, DefaultGenome &&genome) {
+    nb::object result = nb::find(&self).type()(genome.key);
+    nb::cast<DefaultGenome &>(result) = std::move(genome);
+    return result;
+}
+
 NB_MODULE(_neat3p, m) {
     nb::class_<ConfigParameter>(m, "ConfigParameter")
         .def(nb::init<const std::string &, const nb::object &, std::optional<ConfigValue> >(),
@@ -45,6 +147,875 @@ NB_MODULE(_neat3p, m) {
     nb::class_<DefaultNodeGene>(m, "DefaultNodeGene")
         .def(nb::init<int>(), "Initialize with an integer key")
         .def_rw("key", &DefaultNodeGene::key)
+        .def_rw("bias", &DefaultNodeGene::bias)
+        .def_rw("response", &DefaultNodeGene::response)
+        .def_rw("activation", &DefaultNodeGene::activation)
+        .def_rw("aggregation", &DefaultNodeGene::aggregation)
         .def("copy", &DefaultNodeGene::copy)
-        .def("distance", &DefaultNodeGene::distance);
-}
\ No newline at end of file
+        .def("distance", &DefaultNodeGene::distance)
+        .def("__repr__", &DefaultNodeGene::to_string);
+
+    nb::class_<DefaultConnectionGene>(m, "DefaultConnectionGene")
+        .def(nb::init<const std::pair<int, int> &>(), nb::arg("key"))
+        .def_rw("key", &DefaultConnectionGene::key)
+        .def_rw("weight", &DefaultConnectionGene::weight)
+        .def_rw("enabled", &DefaultConnectionGene::enabled)
+        .def("copy", &DefaultConnectionGene::copy)
+        .def("distance", &DefaultConnectionGene::distance)
+        .def("__repr__", &DefaultConnectionGene::to_string);
+
+    m.def("seed", &neat3p::seed, nb::arg("value"),
+          "Seed the native random engine of the calling thread.");
+    m.def(
+        "cow_copied_bytes", [] { return cow_copied_bytes.load(); },
+        "Bytes of gene column elements copied so far, by copy-on-write or to assemble a view.");
+    m.attr("gene_block_size") = CowVector<float>::kBlockSize;
+
+    nb::class_<GenomeParams>(m, "GenomeParams")
+        .def(nb::init<>())
+        .def_rw("num_inputs", &GenomeParams::num_inputs)
+        .def_rw("num_outputs", &GenomeParams::num_outputs)
+        .def_rw("num_hidden", &GenomeParams::num_hidden)
+        .def_rw("feed_forward", &GenomeParams::feed_forward)
+        .def_rw("compatibility_disjoint_coefficient",
+                &GenomeParams::compatibility_disjoint_coefficient)
+        .def_rw("compatibility_weight_coefficient",
+                &GenomeParams::compatibility_weight_coefficient)
+        .def_rw("conn_add_prob", &GenomeParams::conn_add_prob)
+        .def_rw("conn_delete_prob", &GenomeParams::conn_delete_prob)
+        .def_rw("node_add_prob", &GenomeParams::node_add_prob)
+        .def_rw("node_delete_prob", &GenomeParams::node_delete_prob)
+        .def_rw("single_structural_mutation", &GenomeParams::single_structural_mutation)
+        .def_rw("structural_mutation_surer", &GenomeParams::structural_mutation_surer)
+        .def_rw("initial_connection", &GenomeParams::initial_connection);
+
+    nb::class_<neat3p::AttributeConfig>(m, "AttributeConfig")
+        .def(nb::init<>())
+        .def_rw("init_mean", &neat3p::AttributeConfig::init_mean)
+        .def_rw("init_stdev", &neat3p::AttributeConfig::init_stdev)
+        .def_rw("init_type", &neat3p::AttributeConfig::init_type)
+        .def_rw("replace_rate_f", &neat3p::AttributeConfig::replace_rate_f)
+        .def_rw("mutate_rate_f", &neat3p::AttributeConfig::mutate_rate_f)
+        .def_rw("mutate_power_f", &neat3p::AttributeConfig::mutate_power_f)
+        .def_rw("max_value_f", &neat3p::AttributeConfig::max_value_f)
+        .def_rw("min_value_f", &neat3p::AttributeConfig::min_value_f)
+        .def_rw("default_bool", &neat3p::AttributeConfig::default_bool)
+        .def_rw("mutate_rate_b", &neat3p::AttributeConfig::mutate_rate_b)
+        .def_rw("rate_to_true_add", &neat3p::AttributeConfig::rate_to_true_add)
+        .def_rw("rate_to_false_add", &neat3p::AttributeConfig::rate_to_false_add)
+        .def_rw("default_str", &neat3p::AttributeConfig::default_str)
+        .def_rw("options", &neat3p::AttributeConfig::options)
+        .def_rw("mutate_rate_s", &neat3p::AttributeConfig::mutate_rate_s);
+
+    nb::class_<DefaultGenomeConfig>(m, "DefaultGenomeConfig")
+        .def(nb::init<const GenomeParams &>(), nb::arg("params"))
+        .def_rw("num_inputs", &DefaultGenomeConfig::num_inputs)
+        .def_rw("num_outputs", &DefaultGenomeConfig::num_outputs)
+        .def_rw("num_hidden", &DefaultGenomeConfig::num_hidden)
+        .def_rw("feed_forward", &DefaultGenomeConfig::feed_forward)
+        .def_rw("compatibility_disjoint_coefficient",
+                &DefaultGenomeConfig::compatibility_disjoint_coefficient)
+        .def_rw("compatibility_weight_coefficient",
+                &DefaultGenomeConfig::compatibility_weight_coefficient)
+        .def_rw("conn_add_prob", &DefaultGenomeConfig::conn_add_prob)
+        .def_rw("conn_delete_prob", &DefaultGenomeConfig::conn_delete_prob)
+        .def_rw("node_add_prob", &DefaultGenomeConfig::node_add_prob)
+        .def_rw("node_delete_prob", &DefaultGenomeConfig::node_delete_prob)
+        .def_rw("single_structural_mutation", &DefaultGenomeConfig::single_structural_mutation)
+        .def_rw("structural_mutation_surer", &DefaultGenomeConfig::structural_mutation_surer)
+        .def_rw("initial_connection", &DefaultGenomeConfig::initial_connection)
+        .def_rw("connection_fraction", &DefaultGenomeConfig::connection_fraction)
+        .def_rw("input_keys", &DefaultGenomeConfig::input_keys)
+        .def_rw("output_keys", &DefaultGenomeConfig::output_keys)
+        .def_rw("bias", &DefaultGenomeConfig::bias)
+        .def_rw("response", &DefaultGenomeConfig::response)
+        .def_rw("activation", &DefaultGenomeConfig::activation)
+        .def_rw("aggregation", &DefaultGenomeConfig::aggregation)
+        .def_rw("weight", &DefaultGenomeConfig::weight)
+        .def_rw("enabled", &DefaultGenomeConfig::enabled)
+        .def_rw("next_node_key", &DefaultGenomeConfig::next_node_key);
+
+    nb::class_<NodeGeneRef>(m, "NodeGeneRef")
+        .def_prop_ro("key", [](const NodeGeneRef &r) { return r.key; })
+        .def_prop_rw(
+            "bias", [](const NodeGeneRef &r) { return r.genome->nodes.bias[r.row()]; },
+            [](NodeGeneRef &r, float v) { r.genome->nodes.bias.set(r.row(), v); })
+        .def_prop_rw(
+            "response", [](const NodeGeneRef &r) { return r.genome->nodes.response[r.row()]; },
+            [](NodeGeneRef &r, float v) { r.genome->nodes.response.set(r.row(), v); })
+        .def_prop_rw(
+            "activation",
+            [](const NodeGeneRef &r) { return r.genome->nodes.activation[r.row()]; },
+            [](NodeGeneRef &r, const std::string &v) {
+                r.genome->nodes.activation.set(r.row(), v);
+            })
+        .def_prop_rw(
+            "aggregation",
+            [](const NodeGeneRef &r) { return r.genome->nodes.aggregation[r.row()]; },
+            [](NodeGeneRef &r, const std::string &v) {
+                r.genome->nodes.aggregation.set(r.row(), v);
+            })
+        .def("copy", [](const NodeGeneRef &r) { return r.genome->nodes.get(r.row()); })
+        .def("__repr__",
+             [](const NodeGeneRef &r) { return r.genome->nodes.get(r.row()).to_string(); });
+
+    nb::class_<ConnectionGeneRef>(m, "ConnectionGeneRef")
+        .def_prop_ro("key", [](const ConnectionGeneRef &r) { return r.key; })
+        .def_prop_rw(
+            "weight",
+            [](const ConnectionGeneRef &r) { return r.genome->connections.weight[r.row()]; },
+            [](ConnectionGeneRef &r, float v) { r.genome->connections.weight.set(r.row(), v); })
+        .def_prop_rw(
+            "enabled",
+            [](const ConnectionGeneRef &r) {
+                return r.genome->connections.enabled[r.row()] != 0;
+            },
+            [](ConnectionGeneRef &r, bool v) {
+                r.genome->connections.enabled.set(r.row(), v ? 1 : 0);
+            })
+        .def("copy",
+             [](const ConnectionGeneRef &r) { return r.genome->connections.get(r.row()); })
+        .def("__repr__", [](const ConnectionGeneRef &r) {
+            return r.genome->connections.get(r.row()).to_string();
+        });
+
+    nb::class_<NodeGeneMap>(m, "NodeGeneMap")
+        .def("__len__", [](const NodeGeneMap &v) { return v.genome->nodes.size(); })
+        .def("__contains__",
+             [](const NodeGeneMap &v, int key) { return v.genome->nodes.contains(key); })
+        .def(
+            "__getitem__",
+            [](const NodeGeneMap &v, int key) {
+                NodeGeneRef ref{v.owner, v.genome, key};
+                ref.row();
+                return ref;
+            })
+        .def("__setitem__",
+             [](NodeGeneMap &v, int key, const DefaultNodeGene &gene) {
+                 DefaultNodeGene copy = gene;
+                 copy.key = key;
+                 v.genome->nodes.insert(copy);
+             })
+        .def("__delitem__",
+             [](NodeGeneMap &v, int key) {
+                 if (!v.genome->nodes.erase(key)) throw nb::key_error(std::to_string(key).c_str());
+             })
+        .def("__iter__",
+             [](const NodeGeneMap &v) { return nb::iter(nb::cast(v.genome->nodes.keys.get())); })
+        .def("keys", [](const NodeGeneMap &v) { return v.genome->nodes.keys.get(); })
+        .def(
+            "values",
+            [](const NodeGeneMap &v) {
+                std::vector<NodeGeneRef> refs;
+                refs.reserve(v.genome->nodes.size());
+                for (int key : v.genome->nodes.keys) refs.push_back({v.owner, v.genome, key});
+                return refs;
+            })
+        .def(
+            "items",
+            [](const NodeGeneMap &v) {
+                std::vector<std::pair<int, NodeGeneRef>> items;
+                items.reserve(v.genome->nodes.size());
+                for (int key : v.genome->nodes.keys)
+                    items.push_back({key, {v.owner, v.genome, key}});
+                return items;
+            })
+        .def(
+            "get",
+            [](const NodeGeneMap &v, int key, nb::object fallback) -> nb::object {
+                if (!v.genome->nodes.contains(key)) return fallback;
+                return nb::cast(NodeGeneRef{v.owner, v.genome, key});
+            },
+            nb::arg("key"), nb::arg("default") = nb::none());
+
+    nb::class_<ConnectionGeneMap>(m, "ConnectionGeneMap")
+        .def("__len__", [](const ConnectionGeneMap &v) { return v.genome->connections.size(); })
+        .def("__contains__",
+             [](const ConnectionGeneMap &v, const std::pair<int, int> &key) {
+                 return v.genome->connections.contains(key);
+             })
+        .def(
+            "__getitem__",
+            [](const ConnectionGeneMap &v, const std::pair<int, int> &key) {
+                ConnectionGeneRef ref{v.owner, v.genome, key};
+                ref.row();
+                return ref;
+            })
+        .def("__setitem__",
+             [](ConnectionGeneMap &v, const std::pair<int, int> &key,
+                const DefaultConnectionGene &gene) {
+                 DefaultConnectionGene copy = gene;
+                 copy.key = key;
+                 v.genome->connections.insert(copy);
+             })
+        .def("__delitem__",
+             [](ConnectionGeneMap &v, const std::pair<int, int> &key) {
+                 if (!v.genome->connections.erase(key))
+                     throw nb::key_error("connection not found");
+             })
+        .def("__iter__",
+             [](const ConnectionGeneMap &v) {
+                 return nb::iter(nb::cast(v.genome->connections.keys.get()));
+             })
+        .def("keys", [](const ConnectionGeneMap &v) { return v.genome->connections.keys.get(); })
+        .def(
+            "values",
+            [](const ConnectionGeneMap &v) {
+                std::vector<ConnectionGeneRef> refs;
+                refs.reserve(v.genome->connections.size());
+                for (const auto &key : v.genome->connections.keys)
+                    refs.push_back({v.owner, v.genome, key});
+                return refs;
+            })
+        .def(
+            "items",
+            [](const ConnectionGeneMap &v) {
+                std::vector<std::pair<std::pair<int, int>, ConnectionGeneRef>> items;
+                items.reserve(v.genome->connections.size());
+                for (const auto &key : v.genome->connections.keys)
+                    items.push_back({key, {v.owner, v.genome, key}});
+                return items;
+            })
+        .def(
+            "get",
+            [](const ConnectionGeneMap &v, const std::pair<int, int> &key,
+               nb::object fallback) -> nb::object {
+                if (!v.genome->connections.contains(key)) return fallback;
+                return nb::cast(ConnectionGeneRef{v.owner, v.genome, key});
+            },
+            nb::arg("key"), nb::arg("default") = nb::none());
+
+    nb::class_<DefaultGenome>(m, "DefaultGenome")
+        .def(nb::init<int>(), nb::arg("key"))
+        .def_rw("key", &DefaultGenome::key)
+        .def_rw("fitness", &DefaultGenome::fitness)
+        .def_prop_ro(
+            "nodes", [](DefaultGenome &g) { return NodeGeneMap{nb::find(&g), &g}; })
+        .def_prop_ro(
+            "connections", [](DefaultGenome &g) { return ConnectionGeneMap{nb::find(&g), &g}; })
+        // NumPy arrays over the gene columns. The key arrays are read-only
+        // copies. The parameter views are zero-copy, read-only snapshots that
+        // keep the columns shared with copies and crossover children of the
+        // genome; re-read them after changing the genome. writable_*() pins a
+        // column instead, which unshares it, and structural changes (adding or
+        // removing genes) raise RuntimeError while any writable view is alive.
+        .def_prop_ro("node_keys",
+                     [](const DefaultGenome &g) {
+                         std::vector<int> *keys;
+                         nb::capsule owner = heap_owner(keys, std::vector<int>(g.nodes.keys));
+                         return column<const int>(keys->data(), keys->size(), owner);
+                     })
+        .def_prop_ro("biases",
+                     [](const DefaultGenome &g) { return snapshot_column(g.nodes.bias); })
+        .def_prop_ro("responses",
+                     [](const DefaultGenome &g) { return snapshot_column(g.nodes.response); })
+        .def_prop_ro("connection_keys",
+                     [](const DefaultGenome &g) {
+                         std::vector<std::pair<int, int>> *keys;
+                         nb::capsule owner = heap_owner(
+                             keys, std::vector<std::pair<int, int>>(g.connections.keys));
+                         size_t shape[2] = {keys->size(), 2};
+                         return KeyColumn(reinterpret_cast<const int *>(keys->data()), 2, shape,
+                                          owner);
+                     })
+        .def_prop_ro("weights",
+                     [](const DefaultGenome &g) { return snapshot_column(g.connections.weight); })
+        .def_prop_ro("enabled",
+                     [](const DefaultGenome &g) {
+                         return snapshot_column<uint8_t, bool>(g.connections.enabled);
+                     })
+        .def(
+            "writable_biases", [](DefaultGenome &g) { return pinned_column(g.nodes.bias); },
+            "Writable view of the biases.")
+        .def(
+            "writable_responses", [](DefaultGenome &g) { return pinned_column(g.nodes.response); },
+            "Writable view of the responses.")
+        .def(
+            "writable_weights",
+            [](DefaultGenome &g) { return pinned_column(g.connections.weight); },
+            "Writable view of the connection weights.")
+        .def(
+            "writable_enabled",
+            [](DefaultGenome &g) { return pinned_column<uint8_t, bool>(g.connections.enabled); },
+            "Writable view of the connection enabled flags.")
+        .def(
+            "shared_columns",
+            [](const DefaultGenome &g, const DefaultGenome &other) {
+                return std::make_pair(g.nodes.shared_columns(other.nodes),
+                                      g.connections.shared_columns(other.connections));
+            },
+            nb::arg("other"),
+            "(node columns, connection columns) whose storage is shared with `other`.")
+        .def_prop_rw(
+            "activations", [](const DefaultGenome &g) { return g.nodes.activation.get(); },
+            [](DefaultGenome &g, const std::vector<std::string> &v) {
+                if (v.size() != g.nodes.size())
+                    throw std::length_error("expected one activation per node");
+                g.nodes.activation = v;
+            })
+        .def_prop_rw(
+            "aggregations", [](const DefaultGenome &g) { return g.nodes.aggregation.get(); },
+            [](DefaultGenome &g, const std::vector<std::string> &v) {
+                if (v.size() != g.nodes.size())
+                    throw std::length_error("expected one aggregation per node");
+                g.nodes.aggregation = v;
+            })
+        .def("configure_new", &DefaultGenome::configure_new, nb::arg("config"))
+        .def(
+            "configure_crossover",
+            [](DefaultGenome &g, const DefaultGenome &genome1, const DefaultGenome &genome2,
+               const DefaultGenomeConfig &) { g.configure_crossover(genome1, genome2); },
+            nb::arg("genome1"), nb::arg("genome2"), nb::arg("config"))
+        .def("mutate", &DefaultGenome::mutate, nb::arg("config"))
+        .def("mutate_add_node", &DefaultGenome::mutate_add_node, nb::arg("config"))
+        .def("mutate_add_connection", &DefaultGenome::mutate_add_connection, nb::arg("config"))
+        .def("mutate_delete_node", &DefaultGenome::mutate_delete_node, nb::arg("config"))
+        .def("mutate_delete_connection", &DefaultGenome::mutate_delete_connection)
+        .def("add_connection", &DefaultGenome::add_connection, nb::arg("config"),
+             nb::arg("input_key"), nb::arg("output_key"), nb::arg("weight"), nb::arg("enabled"))
+        .def("distance", &DefaultGenome::distance, nb::arg("other"), nb::arg("config"))
+        .def("size", &DefaultGenome::size)
+        .def("topology_hash", &DefaultGenome::topology_hash)
+        .def("__str__", &DefaultGenome::to_string)
+        .def(
+            "get_pruned_copy",
+            [](const DefaultGenome &g, const DefaultGenomeConfig &config) {
+                return same_type(g, get_pruned_copy(g, config.input_keys, config.output_keys));
+            },
+            nb::arg("config"))
+        .def("to_bytes",
+             [](const DefaultGenome &g) {
+                 std::string data = g.serialize();
+                 return nb::bytes(data.data(), data.size());
+             })
+        .def("__getstate__",
+             [](const DefaultGenome &g) {
+                 std::string data = g.serialize();
+                 return nb::bytes(data.data(), data.size());
+             })
+        .def("__setstate__", [](DefaultGenome &g, const nb::bytes &state) {
+            new (&g) DefaultGenome(
+                DefaultGenome::deserialize(std::string(state.c_str(), state.size())));
+        });
+
+    m.def(
+        "export_recurrent",
+        [](const DefaultGenome &genome, const std::vector<int> &input_keys,
+           const std::vector<int> &output_keys, bool prune_empty) {
+            RecurrentConnectivity *c;
+            nb::capsule owner = heap_owner(
+                c, recurrent_connectivity(genome, input_keys, output_keys, prune_empty));
+            size_t shape[2] = {c->weights.size(), 2};
+            nb::dict out;
+            out["num_inputs"] = c->num_inputs;
+            out["num_hidden"] = c->num_hidden;
+            out["num_outputs"] = c->num_outputs;
+            out["hidden_keys"] = column(c->hidden_keys.data(), c->hidden_keys.size(), owner);
+            out["hidden_biases"] = column(c->hidden_biases.data(), c->hidden_biases.size(), owner);
+            out["hidden_responses"] =
+                column(c->hidden_responses.data(), c->hidden_responses.size(), owner);
+            out["output_biases"] = column(c->output_biases.data(), c->output_biases.size(), owner);
+            out["output_responses"] =
+                column(c->output_responses.data(), c->output_responses.size(), owner);
+            out["coo"] = nb::ndarray<nb::numpy, int32_t, nb::shape<-1, 2>, nb::c_contig>(
+                c->coo.data(), 2, shape, owner);
+            out["weights"] = column(c->weights.data(), c->weights.size(), owner);
+            out["block_offsets"] =
+                std::vector<int32_t>(c->block_offsets.begin(), c->block_offsets.end());
+            out["hidden_rows"] = column(c->hidden_rows.data(), c->hidden_rows.size(), owner);
+            out["output_rows"] = column(c->output_rows.data(), c->output_rows.size(), owner);
+            out["output_bias_mask"] =
+                column(c->output_bias_mask.data(), c->output_bias_mask.size(), owner);
+            out["connection_rows"] =
+                column(c->connection_rows.data(), c->connection_rows.size(), owner);
+            return out;
+        },
+        nb::arg("genome"), nb::arg("input_keys"), nb::arg("output_keys"),
+        nb::arg("prune_empty") = false,
+        "Partition a genome into RecurrentNet blocks: int32 (destination, source) COO "
+        "pairs grouped by block_offsets plus float32 weights, biases and responses.");
+
+    m.def(
+        "export_feed_forward",
+        [](const DefaultGenome &genome, const std::vector<int> &input_keys,
+           const std::vector<int> &output_keys) {
+            FeedForwardConnectivity *c;
+            nb::capsule owner =
+                heap_owner(c, feed_forward_connectivity(genome, input_keys, output_keys));
+            nb::dict out;
+            out["node_keys"] = column(c->node_keys.data(), c->node_keys.size(), owner);
+            out["layer_offsets"] = column(c->layer_offsets.data(), c->layer_offsets.size(), owner);
+            out["biases"] = column(c->biases.data(), c->biases.size(), owner);
+            out["responses"] = column(c->responses.data(), c->responses.size(), owner);
+            out["activations"] = c->activations;
+            out["aggregations"] = c->aggregations;
+            out["indptr"] = column(c->indptr.data(), c->indptr.size(), owner);
+            out["indices"] = column(c->indices.data(), c->indices.size(), owner);
+            out["weights"] = column(c->weights.data(), c->weights.size(), owner);
+            out["node_rows"] = column(c->node_rows.data(), c->node_rows.size(), owner);
+            out["connection_rows"] =
+                column(c->connection_rows.data(), c->connection_rows.size(), owner);
+            return out;
+        },
+        nb::arg("genome"), nb::arg("input_keys"), nb::arg("output_keys"),
+        "Evaluation order of a feed-forward genome with its incoming links in int32 CSR form.");
+
+    nb::class_<PackedNetworks>(m, "PackedNetworks")
+        .def(
+            "__init__",
+            [](PackedNetworks *self, const std::vector<DefaultGenome *> &genomes,
+               const std::vector<int> &input_keys, const std::vector<int> &output_keys,
+               int batch_size, bool recurrent) {
+                std::vector<const DefaultGenome *> packed(genomes.begin(), genomes.end());
+                new (self) PackedNetworks(packed, input_keys, output_keys, batch_size, recurrent);
+            },
+            nb::arg("genomes"), nb::arg("input_keys"), nb::arg("output_keys"),
+            nb::arg("batch_size") = 1, nb::arg("recurrent") = false)
+        .def_prop_ro("num_genomes", &PackedNetworks::num_genomes)
+        .def_prop_ro("batch_size", &PackedNetworks::batch_size)
+        .def_prop_ro("num_inputs", &PackedNetworks::num_inputs)
+        .def_prop_ro("num_outputs", &PackedNetworks::num_outputs)
+        .def_prop_ro("recurrent", &PackedNetworks::recurrent)
+        .def_prop_ro("num_nodes", &PackedNetworks::num_nodes)
+        .def_prop_ro("num_links", &PackedNetworks::num_links)
+        .def(
+            "activate",
+            [](PackedNetworks &net,
+               nb::ndarray<const float, nb::ndim<3>, nb::c_contig, nb::device::cpu> inputs) {
+                if (inputs.shape(0) != static_cast<size_t>(net.num_genomes()) ||
+                    inputs.shape(1) != static_cast<size_t>(net.batch_size()) ||
+                    inputs.shape(2) != static_cast<size_t>(net.num_inputs()))
+                    throw std::invalid_argument(
+                        "inputs must have shape (num_genomes, batch_size, num_inputs)");
+                std::vector<float> *out;
+                nb::capsule owner = heap_owner(
+                    out, std::vector<float>(inputs.shape(0) * inputs.shape(1) * net.num_outputs()));
+                {
+                    nb::gil_scoped_release release;
+                    net.activate(inputs.data(), out->data());
+                }
+                size_t shape[3] = {inputs.shape(0), inputs.shape(1),
+                                   static_cast<size_t>(net.num_outputs())};
+                return nb::ndarray<nb::numpy, float, nb::ndim<3>>(out->data(), 3, shape, owner);
+            },
+            nb::arg("inputs"),
+            "Advance every network one step; inputs and outputs are "
+            "(num_genomes, batch_size, num_inputs / num_outputs) float32 arrays.")
+        .def("reset", &PackedNetworks::reset);
+
+    nb::class_<JournalWriter>(m, "JournalWriter")
+        .def(nb::init<const std::string &, int>(), nb::arg("path"),
+             nb::arg("keyframe_interval") = 32)
+        .def_prop_ro("path", &JournalWriter::path)
+        .def("record", &JournalWriter::record, nb::arg("genome"), nb::arg("generation"),
+             nb::arg("parent1") = -1, nb::arg("parent2") = -1, nb::arg("species") = -1,
+             "Record that a genome is alive in a generation; it is written as a delta "
+             "against parent1 the first time its key is seen.")
+        .def("end_generation", &JournalWriter::end_generation, nb::arg("generation"))
+        .def("flush", &JournalWriter::flush);
+
+    nb::class_<JournalGenomeInfo>(m, "JournalGenomeInfo")
+        .def_ro("key", &JournalGenomeInfo::key)
+        .def_ro("generation", &JournalGenomeInfo::generation)
+        .def_ro("parent1", &JournalGenomeInfo::parent1)
+        .def_ro("parent2", &JournalGenomeInfo::parent2)
+        .def_ro("species", &JournalGenomeInfo::species)
+        .def_ro("fitness", &JournalGenomeInfo::fitness);
+
+    nb::class_<JournalReader>(m, "JournalReader")
+        .def(nb::init<const std::string &>(), nb::arg("path"))
+        .def("__len__", &JournalReader::num_genomes)
+        .def("__contains__", &JournalReader::contains, nb::arg("key"))
+        .def("keys", &JournalReader::keys)
+        .def_prop_ro("generations", &JournalReader::generations)
+        .def("info", &JournalReader::info, nb::arg("key"))
+        .def("lineage", &JournalReader::lineage, nb::arg("key"))
+        .def(
+            "genome_bytes",
+            [](const JournalReader &r, int key) {
+                std::string data = r.genome(key).serialize();
+                return nb::bytes(data.data(), data.size());
+            },
+            nb::arg("key"),
+            "The genome rebuilt from the journal, in DefaultGenome.to_bytes format.")
+        .def(
+            "evaluations",
+            [](const JournalReader &r, int generation) {
+                std::vector<JournalEvaluation> evals = r.evaluations(generation);
+                std::vector<int32_t> *keys;
+                std::vector<int32_t> *species;
+                std::vector<double> *fitness;
+                nb::capsule keys_owner = heap_owner(keys, std::vector<int32_t>(evals.size()));
+                nb::capsule species_owner =
+                    heap_owner(species, std::vector<int32_t>(evals.size()));
+                nb::capsule fitness_owner = heap_owner(fitness, std::vector<double>(evals.size()));
+                for (size_t i = 0; i < evals.size(); i++) {
+                    (*keys)[i] = evals[i].key;
+                    (*species)[i] = evals[i].species;
+                    (*fitness)[i] = evals[i].fitness.value_or(std::nan(""));
+                }
+                nb::dict out;
+                out["keys"] = column(keys->data(), keys->size(), keys_owner);
+                out["species"] = column(species->data(), species->size(), species_owner);
+                out["fitness"] = column(fitness->data(), fitness->size(), fitness_owner);
+                return out;
+            },
+            nb::arg("generation"),
+            "Keys, species and fitness (NaN if unset) of every genome recorded in a generation.");
+
+    nb::class_<StreamingStats>(m, "StreamingStats")
+        .def(nb::init<size_t, std::vector<double>>(), nb::arg("window") = 1024,
+             nb::arg("quantiles") = std::vector<double>{0.1, 0.5, 0.9})
+        .def(
+            "ingest",
+            [](StreamingStats &stats, int generation,
+               nb::ndarray<const double, nb::ndim<1>, nb::c_contig, nb::device::cpu> fitness,
+               nb::ndarray<const int32_t, nb::ndim<1>, nb::c_contig, nb::device::cpu> species) {
+                if (fitness.shape(0) != species.shape(0))
+                    throw std::invalid_argument("fitness and species must have the same length");
+                stats.ingest(generation, fitness.data(), species.data(), fitness.shape(0));
+            },
+            nb::arg("generation"), nb::arg("fitness"), nb::arg("species"),
+            "Add one generation: float64 fitness and int32 species id of each genome.")
+        .def_prop_ro("window", &StreamingStats::window)
+        .def("__len__", &StreamingStats::size)
+        .def_prop_ro("total_generations", &StreamingStats::total_generations)
+        .def(
+            "summary",
+            [](const StreamingStats &stats) {
+                const size_t n = stats.size();
+                std::vector<int32_t> *generation;
+                nb::capsule generation_owner = heap_owner(generation, std::vector<int32_t>(n));
+                // mean, stdev, median, min, max as one (5, n) block.
+                std::vector<double> *values;
+                nb::capsule values_owner = heap_owner(values, std::vector<double>(5 * n));
+                for (size_t i = 0; i < n; i++) {
+                    const GenerationSummary &s = stats.summary(i);
+                    (*generation)[i] = s.generation;
+                    const double row[5] = {s.mean, s.stdev, s.median, s.min, s.max};
+                    for (size_t k = 0; k < 5; k++) (*values)[k * n + i] = row[k];
+                }
+                nb::dict out;
+                out["generation"] = column(generation->data(), n, generation_owner);
+                const char *names[5] = {"mean", "stdev", "median", "min", "max"};
+                for (size_t k = 0; k < 5; k++)
+                    out[names[k]] = column(values->data() + k * n, n, values_owner);
+                return out;
+            },
+            "Per-generation int32 generation ids and float64 mean, stdev, median, min and max "
+            "fitness over the window, oldest first.")
+        .def(
+            "species_table",
+            [](const StreamingStats &stats) {
+                // Columns are species 1..max_species, as in StatisticsReporter.
+                const size_t n = stats.size();
+                const size_t m = static_cast<size_t>(stats.max_species());
+                std::vector<int32_t> *sizes;
+                std::vector<double> *fitness;
+                nb::capsule sizes_owner = heap_owner(sizes, std::vector<int32_t>(n * m, 0));
+                nb::capsule fitness_owner =
+                    heap_owner(fitness, std::vector<double>(n * m, std::nan("")));
+                for (size_t i = 0; i < n; i++) {
+                    for (const SpeciesSummary &s : stats.species(i)) {
+                        if (s.species < 1) continue;
+                        const size_t at = i * m + static_cast<size_t>(s.species - 1);
+                        (*sizes)[at] = s.size;
+                        (*fitness)[at] = s.mean_fitness;
+                    }
+                }
+                size_t shape[2] = {n, m};
+                nb::dict out;
+                out["sizes"] = nb::ndarray<nb::numpy, int32_t, nb::ndim<2>>(sizes->data(), 2,
+                                                                           shape, sizes_owner);
+                out["fitness"] = nb::ndarray<nb::numpy, double, nb::ndim<2>>(
+                    fitness->data(), 2, shape, fitness_owner);
+                return out;
+            },
+            "(generations, max_species) int32 species sizes and float64 mean species fitness "
+            "(NaN where a species is absent) over the window.")
+        .def_prop_ro("run_count",
+                     [](const StreamingStats &stats) { return stats.run_moments().count(); })
+        .def_prop_ro("run_mean",
+                     [](const StreamingStats &stats) { return stats.run_moments().mean(); })
+        .def_prop_ro("run_stdev",
+                     [](const StreamingStats &stats) { return stats.run_moments().stdev(); })
+        .def_prop_ro("run_min",
+                     [](const StreamingStats &stats) { return stats.run_moments().min(); })
+        .def_prop_ro("run_max",
+                     [](const StreamingStats &stats) { return stats.run_moments().max(); })
+        .def(
+            "run_quantiles",
+            [](const StreamingStats &stats) {
+                std::map<double, double> out;
+                for (const P2Quantile &q : stats.run_quantiles()) out[q.q()] = q.value();
+                return out;
+            },
+            "Estimated quantiles of every fitness value seen in the run, keyed by quantile.");
+
+    nb::class_<NoveltyArchive>(m, "NoveltyArchive")
+        .def(nb::init<size_t, size_t>(), nb::arg("dim"), nb::arg("k") = 15)
+        .def_prop_ro("dim", &NoveltyArchive::dim)
+        .def_prop_ro("k", &NoveltyArchive::k)
+        .def("__len__", &NoveltyArchive::size)
+        .def(
+            "add",
+            [](NoveltyArchive &archive,
+               nb::ndarray<const float, nb::ndim<2>, nb::c_contig, nb::device::cpu> behaviors) {
+                if (behaviors.shape(1) != archive.dim())
+                    throw std::invalid_argument("behaviors must have shape (n, dim)");
+                nb::gil_scoped_release release;
+                archive.add(behaviors.data(), behaviors.shape(0));
+            },
+            nb::arg("behaviors"), "Archive an (n, dim) float32 array of behaviours.")
+        .def(
+            "score",
+            [](NoveltyArchive &archive,
+               nb::ndarray<const float, nb::ndim<2>, nb::c_contig, nb::device::cpu> behaviors,
+               size_t num_threads) {
+                if (behaviors.shape(1) != archive.dim())
+                    throw std::invalid_argument("behaviors must have shape (n, dim)");
+                const size_t n = behaviors.shape(0);
+                std::vector<float> *novelty;
+                nb::capsule owner = heap_owner(novelty, std::vector<float>(n));
+                {
+                    nb::gil_scoped_release release;
+                    archive.score(behaviors.data(), n, novelty->data(), num_threads);
+                }
+                return column(novelty->data(), n, owner);
+            },
+            nb::arg("behaviors"), nb::arg("num_threads") = 0,
+            "Novelty of each row of an (n, dim) float32 array: the mean distance to its k "
+            "nearest neighbours among the archive and the other rows.")
+        .def(
+            "behaviors",
+            [](const NoveltyArchive &archive) {
+                std::vector<float> *points;
+                nb::capsule owner = heap_owner(points, std::vector<float>(archive.points()));
+                size_t shape[2] = {archive.size(), archive.dim()};
+                return nb::ndarray<nb::numpy, float, nb::ndim<2>>(points->data(), 2, shape, owner);
+            },
+            "Copy of the archived behaviours as an (n, dim) float32 array.");
+
+    nb::class_<MigrationRing>(m, "MigrationRing")
+        .def(nb::init<const std::string &, size_t, bool>(), nb::arg("path"),
+             nb::arg("capacity") = size_t(1) << 22, nb::arg("create") = false,
+             "Create (create=True) or attach to the shared-memory ring file at `path`.")
+        .def_prop_ro("path", &MigrationRing::path)
+        .def_prop_ro("capacity", &MigrationRing::capacity)
+        .def_prop_ro("used", &MigrationRing::used)
+        .def(
+            "push",
+            [](MigrationRing &ring, const nb::bytes &message) {
+                return ring.push(message.c_str(), message.size());
+            },
+            nb::arg("message"), "Queue a message; False if the ring is full.")
+        .def(
+            "pop",
+            [](MigrationRing &ring) -> nb::object {
+                std::string message;
+                if (!ring.pop(message)) return nb::none();
+                return nb::bytes(message.data(), message.size());
+            },
+            "The oldest queued message, or None if the ring is empty.");
+
+    nb::class_<QuantizedLayer>(m, "QuantizedLayer")
+        .def(
+            "__init__",
+            [](QuantizedLayer *self,
+               nb::ndarray<const float, nb::ndim<2>, nb::c_contig, nb::device::cpu> weights,
+               nb::ndarray<const float, nb::ndim<1>, nb::c_contig, nb::device::cpu> bias,
+               const std::string &precision, const std::string &activation) {
+                if (bias.shape(0) != weights.shape(0))
+                    throw std::invalid_argument("bias must have one entry per weight row");
+                new (self) QuantizedLayer(weights.data(), bias.data(), weights.shape(0),
+                                          weights.shape(1), precision_from_name(precision),
+                                          activation_from_name(activation));
+            },
+            nb::arg("weights"), nb::arg("bias"), nb::arg("precision") = "int8",
+            nb::arg("activation") = "identity",
+            "Quantize a (rows, cols) float32 weight matrix to int8 (per-row scales) or fp16.")
+        .def_prop_ro("rows", &QuantizedLayer::rows)
+        .def_prop_ro("cols", &QuantizedLayer::cols)
+        .def_prop_ro("precision",
+                     [](const QuantizedLayer &layer) {
+                         return layer.precision() == Precision::kInt8 ? "int8" : "fp16";
+                     })
+        .def_prop_ro("weight_bytes", &QuantizedLayer::weight_bytes)
+        .def(
+            "dequantized",
+            [](const QuantizedLayer &layer) {
+                std::vector<float> *weights;
+                nb::capsule owner = heap_owner(weights, layer.dequantized());
+                size_t shape[2] = {layer.rows(), layer.cols()};
+                return nb::ndarray<nb::numpy, float, nb::ndim<2>>(weights->data(), 2, shape, owner);
+            },
+            "The weights as used by forward(), as a (rows, cols) float32 array.")
+        .def(
+            "forward",
+            [](const QuantizedLayer &layer,
+               nb::ndarray<const float, nb::ndim<2>, nb::c_contig, nb::device::cpu> inputs) {
+                if (inputs.shape(1) != layer.cols())
+                    throw std::invalid_argument("inputs must have shape (batch_size, cols)");
+                const size_t batch = inputs.shape(0);
+                std::vector<float> *out;
+                nb::capsule owner = heap_owner(out, std::vector<float>(batch * layer.rows()));
+                {
+                    nb::gil_scoped_release release;
+                    layer.forward(inputs.data(), batch, out->data());
+                }
+                size_t shape[2] = {batch, layer.rows()};
+                return nb::ndarray<nb::numpy, float, nb::ndim<2>>(out->data(), 2, shape, owner);
+            },
+            nb::arg("inputs"),
+            "activation(W x + bias) for a (batch_size, cols) float32 array; returns "
+            "(batch_size, rows).");
+
+    nb::class_<SparseLayer>(m, "SparseLayer")
+        .def(
+            "__init__",
+            [](SparseLayer *self,
+               nb::ndarray<const float, nb::ndim<2>, nb::c_contig, nb::device::cpu> weights,
+               nb::ndarray<const float, nb::ndim<1>, nb::c_contig, nb::device::cpu> bias,
+               const std::string &activation, double max_density) {
+                if (bias.shape(0) != weights.shape(0))
+                    throw std::invalid_argument("bias must have one entry per weight row");
+                new (self) SparseLayer(weights.data(), bias.data(), weights.shape(0),
+                                       weights.shape(1), activation_from_name(activation),
+                                       max_density);
+            },
+            nb::arg("weights"), nb::arg("bias"), nb::arg("activation") = "identity",
+            nb::arg("max_density") = SparseLayer::kDefaultMaxDensity,
+            "Store a thresholded (rows, cols) float32 weight matrix in CSR if at most "
+            "max_density of it is nonzero, densely otherwise.")
+        .def_prop_ro("rows", &SparseLayer::rows)
+        .def_prop_ro("cols", &SparseLayer::cols)
+        .def_prop_ro("format",
+                     [](const SparseLayer &layer) {
+                         return layer.format() == WeightFormat::kCsr ? "csr" : "dense";
+                     })
+        .def_prop_ro("nnz", &SparseLayer::nnz)
+        .def_prop_ro("density", &SparseLayer::density)
+        .def_prop_ro("weight_bytes", &SparseLayer::weight_bytes)
+        .def(
+            "dense",
+            [](const SparseLayer &layer) {
+                std::vector<float> *weights;
+                nb::capsule owner = heap_owner(weights, layer.dense());
+                size_t shape[2] = {layer.rows(), layer.cols()};
+                return nb::ndarray<nb::numpy, float, nb::ndim<2>>(weights->data(), 2, shape, owner);
+            },
+            "The weights as a (rows, cols) float32 array.")
+        .def(
+            "forward",
+            [](const SparseLayer &layer,
+               nb::ndarray<const float, nb::ndim<2>, nb::c_contig, nb::device::cpu> inputs) {
+                if (inputs.shape(1) != layer.cols())
+                    throw std::invalid_argument("inputs must have shape (batch_size, cols)");
+                const size_t batch = inputs.shape(0);
+                std::vector<float> *out;
+                nb::capsule owner = heap_owner(out, std::vector<float>(batch * layer.rows()));
+                {
+                    nb::gil_scoped_release release;
+                    layer.forward(inputs.data(), batch, out->data());
+                }
+                size_t shape[2] = {batch, layer.rows()};
+                return nb::ndarray<nb::numpy, float, nb::ndim<2>>(out->data(), 2, shape, owner);
+            },
+            nb::arg("inputs"),
+            "activation(W x + bias) for a (batch_size, cols) float32 array; returns "
+            "(batch_size, rows).");
+
+    nb::class_<DistanceCache>(m, "DistanceCache")
+        .def(nb::init<double>(), nb::arg("max_edit_fraction") = 0.25)
+        .def("record_birth", &DistanceCache::record_birth, nb::arg("child"), nb::arg("parent1"),
+             nb::arg("parent2"),
+             "Remember how `child` differs from the closer of its parents, unless the genes "
+             "it added or removed exceed max_edit_fraction of its genes.")
+        .def("distance", &DistanceCache::distance, nb::arg("genome1"), nb::arg("genome2"),
+             nb::arg("config"),
+             "Same as genome1.distance(genome2, config), cached per key pair and derived from "
+             "a parent's cached distance when possible.")
+        .def("retain", &DistanceCache::retain, nb::arg("keys"),
+             "Forget every genome whose key is not in `keys`.")
+        .def_prop_ro("num_edits", &DistanceCache::num_edits)
+        .def_prop_ro("num_terms", &DistanceCache::num_terms)
+        .def_prop_ro("hits", &DistanceCache::hits)
+        .def_prop_ro("derived", &DistanceCache::derived)
+        .def_prop_ro("computed", &DistanceCache::computed);
+
+    nb::class_<SpeciesSetParams>(m, "SpeciesSetParams")
+        .def(nb::init<>())
+        .def_rw("compatibility_threshold", &SpeciesSetParams::compatibility_threshold);
+
+    nb::class_<StagnationParams>(m, "StagnationParams")
+        .def(nb::init<>())
+        .def_rw("species_fitness_func", &StagnationParams::species_fitness_func)
+        .def_rw("max_stagnation", &StagnationParams::max_stagnation)
+        .def_rw("species_elitism", &StagnationParams::species_elitism);
+
+    nb::class_<ReproductionParams>(m, "ReproductionParams")
+        .def(nb::init<>())
+        .def_rw("elitism", &ReproductionParams::elitism)
+        .def_rw("survival_threshold", &ReproductionParams::survival_threshold)
+        .def_rw("min_species_size", &ReproductionParams::min_species_size);
+
+    nb::class_<PopulationParams>(m, "PopulationParams")
+        .def(nb::init<>())
+        .def_rw("pop_size", &PopulationParams::pop_size)
+        .def_rw("fitness_criterion", &PopulationParams::fitness_criterion)
+        .def_rw("fitness_threshold", &PopulationParams::fitness_threshold)
+        .def_rw("reset_on_extinction", &PopulationParams::reset_on_extinction)
+        .def_rw("no_fitness_termination", &PopulationParams::no_fitness_termination)
+        .def_rw("species_set", &PopulationParams::species_set)
+        .def_rw("stagnation", &PopulationParams::stagnation)
+        .def_rw("reproduction", &PopulationParams::reproduction);
+
+    nb::exception<CompleteExtinctionException>(m, "CompleteExtinctionException");
+
+    nb::class_<Population>(m, "Population")
+        .def(nb::init<const DefaultGenomeConfig &, const PopulationParams &>(),
+             nb::arg("genome_config"), nb::arg("params"))
+        .def(
+            "run",
+            [](Population &population, nb::callable fitness_function, std::optional<int> n) {
+                GenomePtr best = population.run(
+                    [&](const std::vector<DefaultGenome *> &genomes) {
+                        // Each Python genome shares ownership with the population,
+                        // so fitness written by the callback reaches the population
+                        // and genomes kept past reproduction stay valid.
+                        nb::list items;
+                        for (DefaultGenome *g : genomes)
+                            items.append(
+                                nb::make_tuple(g->key, nb::cast(population.population.at(g->key))));
+                        fitness_function(items);
+                    },
+                    n);
+                return best ? std::optional<DefaultGenome>(*best) : std::nullopt;
+            },
+            nb::arg("fitness_function"), nb::arg("n") = nb::none(),
+            "Run at most n generations; fitness_function(genomes) gets a list of (key, genome) "
+            "and assigns genome.fitness. Returns a copy of the best genome.")
+        .def_prop_ro("generation", [](const Population &p) { return p.generation; })
+        .def_prop_ro("genome_config",
+                     [](const Population &p) { return p.genome_config; })
+        .def_prop_ro("population_keys",
+                     [](const Population &p) {
+                         std::vector<int> keys;
+                         for (const auto &[key, genome] : p.population) keys.push_back(key);
+                         return keys;
+                     })
+        .def_prop_ro("species_ids",
+                     [](const Population &p) {
+                         return std::map<int, int>(p.species.genome_to_species.begin(),
+                                                   p.species.genome_to_species.end());
+                     },
+                     "Species key of every genome of the current generation.")
+        .def(
+            "genome",
+            [](const Population &p, int key) {
+                auto it = p.population.find(key);
+                if (it == p.population.end()) throw nb::key_error(std::to_string(key).c_str());
+                return DefaultGenome(*it->second);
+            },
+            nb::arg("key"), "Copy of a genome of the current generation.");
+}
@@ -1,13 +1,14 @@
-// #include <SDL2/SDL.h>
-// #include <SDL2/SDL_image.h>
-// #include <imgui/backends/imgui_impl_sdl2.h>
-// #include <imgui/backends/imgui_impl_sdlrenderer2.h>
-#define ENTT_ENTITY_TYPE int
-
-#include <spdlog/spdlog.h>
-
 #include <cstdint>
 
-#include "config.hpp"
+// The Python-free core (the neat3p_core library). config.hpp, which parses
+// config files through Python's configparser, belongs to the bindings only.
+#include "activations.hpp"
+#include "aggregations.hpp"
+#include "connectivity.hpp"
+#include "distance_cache.hpp"
 #include "genes.hpp"
-#include "genome.hpp"
\ No newline at end of file
+#include "genome.hpp"
+#include "packed_net.hpp"
+#include "population.hpp"
+#include "reproduction.hpp"
+#include "species.hpp"
@@ -10,13 +10,19 @@ from .checkpoint import Checkpointer
 from .config import Config
 from .distributed import DistributedEvaluator, host_is_local
 from .genome import DefaultGenome
+from .islands import IslandModel
+from .journal import GenomeJournal, JournalReporter
+from .native_genome import NativeGenome
+from .novelty import NoveltySearch
 from .parallel import ParallelEvaluator
 from .population import CompleteExtinctionException, Population
+from .racing import RacingEvaluator
 from .reporting import StdOutReporter
 from .reproduction import DefaultReproduction
 from .species import DefaultSpeciesSet
 from .stagnation import DefaultStagnation
-from .statistics import StatisticsReporter
+from .statistics import StatisticsReporter, StreamingStatisticsReporter
+from .steady_state import SteadyStatePopulation
 from .threaded import ThreadedEvaluator
 from .utils import this_is_neat
 
@@ -28,14 +34,22 @@ __all__ = [
     "DistributedEvaluator",
     "host_is_local",
     "DefaultGenome",
+    "IslandModel",
+    "GenomeJournal",
+    "JournalReporter",
+    "NativeGenome",
+    "NoveltySearch",
     "ParallelEvaluator",
     "CompleteExtinctionException",
     "Population",
+    "RacingEvaluator",
     "StdOutReporter",
     "DefaultReproduction",
     "DefaultSpeciesSet",
     "DefaultStagnation",
     "StatisticsReporter",
+    "StreamingStatisticsReporter",
+    "SteadyStatePopulation",
     "ThreadedEvaluator",
     "this_is_neat",
 ]
@@ -18,6 +18,11 @@ def write_pretty_params(f, config, params):
         f.write(f"{p.name.ljust(longest_name)} = {p.format(getattr(config, p.name))}\n")
 
 
+def section_name(cls):
+    """Name of the configuration section read by `cls` (its class name unless overridden)."""
+    return getattr(cls, "config_section", cls.__name__)
+
+
 class UnknownConfigItemError(NameError):
     """Error for unknown configuration option - partially to catch typos."""
 
@@ -115,16 +120,16 @@ class Config(object):
             raise UnknownConfigItemError(f"Unknown (section 'NEAT') configuration item {unknown_list[0]!s}")
 
         # Parse type sections.
-        genome_dict = dict(parameters.items(genome_type.__name__))
+        genome_dict = dict(parameters.items(section_name(genome_type)))
         self.genome_config = genome_type.parse_config(genome_dict)
 
-        species_set_dict = dict(parameters.items(species_set_type.__name__))
+        species_set_dict = dict(parameters.items(section_name(species_set_type)))
         self.species_set_config = species_set_type.parse_config(species_set_dict)
 
-        stagnation_dict = dict(parameters.items(stagnation_type.__name__))
+        stagnation_dict = dict(parameters.items(section_name(stagnation_type)))
         self.stagnation_config = stagnation_type.parse_config(stagnation_dict)
 
-        reproduction_dict = dict(parameters.items(reproduction_type.__name__))
+        reproduction_dict = dict(parameters.items(section_name(reproduction_type)))
         self.reproduction_config = reproduction_type.parse_config(reproduction_dict)
 
     def save(self, filename):
@@ -134,14 +139,14 @@ class Config(object):
             f.write("[NEAT]\n")
             write_pretty_params(f, self, self.__params)
 
-            f.write(f"\n[{self.genome_type.__name__}]\n")
+            f.write(f"\n[{section_name(self.genome_type)}]\n")
             self.genome_type.write_config(f, self.genome_config)
 
-            f.write(f"\n[{self.species_set_type.__name__}]\n")
+            f.write(f"\n[{section_name(self.species_set_type)}]\n")
             self.species_set_type.write_config(f, self.species_set_config)
 
-            f.write(f"\n[{self.stagnation_type.__name__}]\n")
+            f.write(f"\n[{section_name(self.stagnation_type)}]\n")
             self.stagnation_type.write_config(f, self.stagnation_config)
 
-            f.write(f"\n[{self.reproduction_type.__name__}]\n")
+            f.write(f"\n[{section_name(self.reproduction_type)}]\n")
             self.reproduction_type.write_config(f, self.reproduction_config)
@@ -177,7 +177,7 @@ class VoxelForageEnv(gym.Env):
         return np.concatenate([patch.reshape(-1), scalars]).astype(np.float32)
 
     def _info(self) -> dict:
-        return {"energy": self.energy, "collected": self.collected, "steps": self.steps}
+        return {"energy": self.energy, "collected": self.collected, "steps": self.steps, "pos": tuple(int(v) for v in self.pos)}
 
     # ── dynamics ────────────────────────────────────────────────────────────
     def step(self, action: int) -> tuple[np.ndarray, float, bool, bool, dict]:
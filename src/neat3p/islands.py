@@ -0,0 +1,284 @@
+"""
+Island-model evolution: independent populations in separate processes, each
+running the full evaluate / reproduce / speciate loop, that periodically send
+their best genomes to neighbouring islands through shared-memory rings.
+"""
+
+import multiprocessing
+import os
+import pickle
+import queue
+import random
+import shutil
+import tempfile
+from itertools import count
+
+from . import _neat3p
+from .population import Population
+from .reporting import BaseReporter
+
+
+def island_topology(topology, num_islands):
+    """
+    The islands each island sends migrants to, as a dict. `topology` is "ring"
+    (i -> i + 1), "bidirectional_ring", "fully_connected", or such a dict.
+    """
+    if isinstance(topology, dict):
+        edges = {i: sorted(set(topology.get(i, ())) - {i}) for i in range(num_islands)}
+        for i, targets in edges.items():
+            if any(not 0 <= j < num_islands for j in targets):
+                raise RuntimeError(f"Island {i} migrates to an island outside 0..{num_islands - 1}")
+        return edges
+    if num_islands < 2:
+        return {i: [] for i in range(num_islands)}
+    if topology == "ring":
+        return {i: [(i + 1) % num_islands] for i in range(num_islands)}
+    if topology == "bidirectional_ring":
+        return {i: sorted({(i + 1) % num_islands, (i - 1) % num_islands}) for i in range(num_islands)}
+    if topology == "fully_connected":
+        return {i: [j for j in range(num_islands) if j != i] for i in range(num_islands)}
+    raise RuntimeError(f"Unexpected island topology: {topology!r}")
+
+
+class _StopIsland(Exception):
+    pass
+
+
+class MigrationReporter(BaseReporter):
+    """
+    Sends copies of the island's fittest genomes out every `interval` generations
+    and replaces random offspring (never elites) with the migrants that arrived.
+    Migrants get fresh keys and are speciated with the rest of the generation.
+
+    Genomes travel in the NativeGenome byte format when the genome type has
+    one (`from_bytes`), pickled otherwise. A full ring drops the migrant.
+    """
+
+    def __init__(self, reproduction, outgoing, incoming, interval, num_migrants, stop_event=None):
+        self.reproduction = reproduction
+        self.outgoing = outgoing
+        self.incoming = incoming
+        self.interval = interval
+        self.num_migrants = num_migrants
+        self.stop_event = stop_event
+        self.generation = None
+        self.emigrants = []
+        self.evaluated = set()
+        self.sent = 0
+        self.received = 0
+        self.dropped = 0
+
+    def start_generation(self, generation):
+        if self.stop_event is not None and self.stop_event.is_set():
+            raise _StopIsland()
+        self.generation = generation
+
+    def post_evaluate(self, config, population, species, best_genome):
+        self.evaluated = set(population)
+        if self._migrating():
+            fittest = sorted(population.values(), key=lambda g: g.fitness, reverse=True)
+            self.emigrants = [self._encode(g) for g in fittest[: self.num_migrants]]
+
+    def end_generation(self, config, population, species_set):
+        if not self._migrating():
+            return
+
+        for ring in self.outgoing:
+            for message in self.emigrants:
+                if ring.push(message):
+                    self.sent += 1
+                else:
+                    self.dropped += 1
+        self.emigrants = []
+
+        migrants = []
+        for ring in self.incoming:
+            message = ring.pop()
+            while message is not None:
+                migrants.append(self._decode(config, message))
+                message = ring.pop()
+        # Elites carried over from the evaluated generation are kept.
+        replaceable = [gid for gid in population if gid not in self.evaluated]
+        random.shuffle(replaceable)
+        migrants = migrants[: len(replaceable)]
+        if not migrants:
+            return
+
+        for gid, migrant in zip(replaceable, migrants):
+            del population[gid]
+            self.reproduction.ancestors.pop(gid, None)
+            key = next(self.reproduction.genome_indexer)
+            migrant.key = key
+            migrant.fitness = None
+            population[key] = migrant
+            self.reproduction.ancestors[key] = tuple()
+        self.received += len(migrants)
+        species_set.speciate(config, population, self.generation)
+
+    def found_solution(self, config, generation, best):
+        if self.stop_event is not None and not config.no_fitness_termination:
+            self.stop_event.set()
+
+    def _migrating(self):
+        return self.num_migrants > 0 and self.generation % self.interval == self.interval - 1
+
+    @staticmethod
+    def _encode(genome):
+        if hasattr(type(genome), "from_bytes"):
+            return genome.to_bytes()
+        return pickle.dumps(genome)
+
+    @staticmethod
+    def _decode(config, message):
+        if hasattr(config.genome_type, "from_bytes"):
+            # The native config skips keys a genome already uses when adding nodes.
+            return config.genome_type.from_bytes(message)
+        migrant = pickle.loads(message)
+        # The migrant's node keys come from the sending island's indexer: move
+        # ours past them, so that adding a node to it never reuses one.
+        genome_config = config.genome_config
+        if migrant.nodes:
+            next_key = max(migrant.nodes) + 1
+            if genome_config.node_indexer is not None:
+                next_key = max(next_key, next(genome_config.node_indexer))
+            genome_config.node_indexer = count(next_key)
+        return migrant
+
+
+def _run_island(island, config, fitness_function, n, outgoing, incoming, interval, num_migrants, seed, stop, results):
+    # Native genomes draw from the native engine, which a forked island would
+    # otherwise inherit in the parent's state.
+    random.seed(seed)
+    _neat3p.seed(seed)
+    outgoing = [_neat3p.MigrationRing(path) for path in outgoing]
+    incoming = [_neat3p.MigrationRing(path) for path in incoming]
+
+    population = Population(config)
+    migration = MigrationReporter(population.reproduction, outgoing, incoming, interval, num_migrants, stop)
+    population.add_reporter(migration)
+    try:
+        population.run(fitness_function, n)
+    except _StopIsland:
+        pass
+    results.put(
+        (
+            island,
+            population.best_genome,
+            population.generation,
+            {"sent": migration.sent, "received": migration.received, "dropped": migration.dropped},
+        )
+    )
+
+
+class IslandModel(object):
+    """
+    Runs `num_islands` populations, one process each, built from the same config.
+    Every `migration_interval` generations each island sends its
+    `migration_rate * pop_size` fittest genomes (at least one) to each of its
+    neighbours in `topology` (see island_topology).
+
+    Each directed link is its own single-producer / single-consumer ring in
+    shared memory, so islands never lock or wait on each other: migrants that
+    have not arrived yet are picked up at the next migration.
+
+    Node keys are allocated per island, so equal keys on genomes from different
+    islands do not imply a shared origin; crossover treats them as matching
+    genes all the same.
+
+    When one island reaches the fitness threshold the others stop at the start
+    of their next generation. The fitness function must be picklable if the
+    multiprocessing start method is not "fork".
+    """
+
+    def __init__(
+        self,
+        config,
+        num_islands=None,
+        migration_interval=10,
+        migration_rate=0.05,
+        topology="ring",
+        ring_capacity=1 << 22,
+        seed=None,
+        mp_context=None,
+    ):
+        self.config = config
+        self.num_islands = num_islands if num_islands is not None else max(1, os.cpu_count() or 1)
+        self.migration_interval = migration_interval
+        self.num_migrants = max(1, int(round(migration_rate * config.pop_size))) if migration_rate > 0 else 0
+        self.topology = island_topology(topology, self.num_islands)
+        self.ring_capacity = ring_capacity
+        self.seed = seed if seed is not None else random.randrange(2**31)
+        self.context = mp_context if mp_context is not None else multiprocessing.get_context()
+        self.best_genomes = {}
+        self.generations = {}
+        self.migration_counts = {}
+
+    def run(self, fitness_function, n=None):
+        """
+        Evolves every island for at most n generations and returns the best
+        genome found on any of them. Per-island results are kept in
+        `best_genomes`, `generations` and `migration_counts`.
+        """
+        if self.config.no_fitness_termination and (n is None):
+            raise RuntimeError("Cannot have no generational limit with no fitness termination")
+
+        shm = "/dev/shm" if os.path.isdir("/dev/shm") else None
+        ring_dir = tempfile.mkdtemp(prefix="neat3p-islands-", dir=shm)
+        try:
+            outgoing = {i: [] for i in range(self.num_islands)}
+            incoming = {i: [] for i in range(self.num_islands)}
+            for i, targets in self.topology.items():
+                for j in targets:
+                    path = os.path.join(ring_dir, f"{i}-{j}.ring")
+                    _neat3p.MigrationRing(path, self.ring_capacity, create=True)
+                    outgoing[i].append(path)
+                    incoming[j].append(path)
+
+            stop = self.context.Event()
+            results = self.context.Queue()
+            processes = [
+                self.context.Process(
+                    target=_run_island,
+                    args=(
+                        i,
+                        self.config,
+                        fitness_function,
+                        n,
+                        outgoing[i],
+                        incoming[i],
+                        self.migration_interval,
+                        self.num_migrants,
+                        self.seed + i,
+                        stop,
+                        results,
+                    ),
+                    daemon=True,
+                )
+                for i in range(self.num_islands)
+            ]
+            for p in processes:
+                p.start()
+            try:
+                while len(self.best_genomes) < self.num_islands:
+                    try:
+                        island, best, generation, counts = results.get(timeout=1.0)
+                    except queue.Empty:
+                        failed = [i for i, p in enumerate(processes) if p.exitcode not in (None, 0)]
+                        if failed:
+                            raise RuntimeError(f"Islands {failed} exited abnormally")
+                        continue
+                    self.best_genomes[island] = best
+                    self.generations[island] = generation
+                    self.migration_counts[island] = counts
+            finally:
+                stop.set()
+                for p in processes:
+                    p.join()
+        finally:
+            shutil.rmtree(ring_dir, ignore_errors=True)
+
+        return max(
+            (g for g in self.best_genomes.values() if g is not None),
+            key=lambda g: g.fitness,
+            default=None,
+        )
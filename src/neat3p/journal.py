@@ -0,0 +1,88 @@
+"""
+Append-only genome journal: every genome of a run, stored as deltas against its
+parent in a compact binary log that is memory-mapped for reading.
+"""
+
+import numpy as np
+
+from . import _neat3p
+from .native_genome import NativeGenome
+from .reporting import BaseReporter
+
+
+class JournalReporter(BaseReporter):
+    """
+    Writes each generation's genomes, with their fitness, species and parents,
+    to a native journal. Only works with NativeGenome populations.
+
+    Parent ids are taken from `reproduction.ancestors`. With `prune_ancestors`,
+    entries are removed from it once journaled, so that the dict no longer grows
+    over the run; the journal's lineage() answers the same question.
+    """
+
+    def __init__(self, path, reproduction=None, keyframe_interval=32, prune_ancestors=True):
+        self.writer = _neat3p.JournalWriter(path, keyframe_interval)
+        self.reproduction = reproduction
+        self.prune_ancestors = prune_ancestors
+        self.generation = None
+
+    def start_generation(self, generation):
+        self.generation = generation
+
+    def post_evaluate(self, config, population, species, best_genome):
+        ancestors = self.reproduction.ancestors if self.reproduction is not None else {}
+        for gid, genome in population.items():
+            parents = ancestors.pop(gid, ()) if self.prune_ancestors else ancestors.get(gid, ())
+            parent1 = parents[0] if len(parents) > 0 else -1
+            parent2 = parents[1] if len(parents) > 1 else -1
+            self.writer.record(genome, self.generation, parent1, parent2, species.get_species_id(gid))
+
+    def end_generation(self, config, population, species_set):
+        self.writer.end_generation(self.generation)
+
+    def found_solution(self, config, generation, best):
+        self.writer.flush()
+
+
+class GenomeJournal(object):
+    """Read access to a journal written by JournalReporter."""
+
+    def __init__(self, path, genome_type=NativeGenome):
+        self.reader = _neat3p.JournalReader(path)
+        self.genome_type = genome_type
+
+    def __len__(self):
+        return len(self.reader)
+
+    def __contains__(self, key):
+        return key in self.reader
+
+    def keys(self):
+        return self.reader.keys()
+
+    @property
+    def generations(self):
+        return self.reader.generations
+
+    def info(self, key):
+        """Birth generation, parents and latest species / fitness of a genome."""
+        return self.reader.info(key)
+
+    def genome(self, key):
+        """Rebuilds a historic genome (with its latest fitness)."""
+        return self.genome_type.from_bytes(self.reader.genome_bytes(key))
+
+    def lineage(self, key):
+        """Keys along the first-parent line, from `key` back to an initial genome."""
+        return self.reader.lineage(key)
+
+    def evaluations(self, generation):
+        """Dict of `keys`, `species` and `fitness` arrays for a generation."""
+        return self.reader.evaluations(generation)
+
+    def best_genome(self, generation):
+        """The fittest genome recorded in a generation."""
+        evals = self.evaluations(generation)
+        if len(evals["keys"]) == 0:
+            raise KeyError(generation)
+        return self.genome(int(evals["keys"][np.nanargmax(evals["fitness"])]))
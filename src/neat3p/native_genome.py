@@ -0,0 +1,197 @@
+"""Genome backed by the native (C++) DefaultGenome.
+
+Genes live in column-wise tables owned by C++; ``node_keys``, ``biases``,
+``responses``, ``connection_keys``, ``weights`` and ``enabled`` are zero-copy
+NumPy views over them. The parameter views are read-only snapshots, so that
+reading them keeps the columns shared with the genome's parents; write through
+``writable_biases()``, ``writable_responses()``, ``writable_weights()`` and
+``writable_enabled()`` instead. ``nodes`` and ``connections`` keep the dict-like access of
+the pure Python DefaultGenome, so reporters and phenotype builders work unchanged.
+"""
+
+from . import _neat3p
+from .genes import DefaultConnectionGene, DefaultNodeGene
+from .genome import DefaultGenomeConfig
+
+_GENOME_PARAMS = [
+    "num_inputs",
+    "num_outputs",
+    "num_hidden",
+    "feed_forward",
+    "compatibility_disjoint_coefficient",
+    "compatibility_weight_coefficient",
+    "conn_add_prob",
+    "conn_delete_prob",
+    "node_add_prob",
+    "node_delete_prob",
+    "single_structural_mutation",
+    "structural_mutation_surer",
+]
+
+
+def _float_attribute(config, name):
+    attr = _neat3p.AttributeConfig()
+    attr.init_mean = getattr(config, f"{name}_init_mean")
+    attr.init_stdev = getattr(config, f"{name}_init_stdev")
+    attr.init_type = getattr(config, f"{name}_init_type")
+    attr.replace_rate_f = getattr(config, f"{name}_replace_rate")
+    attr.mutate_rate_f = getattr(config, f"{name}_mutate_rate")
+    attr.mutate_power_f = getattr(config, f"{name}_mutate_power")
+    attr.max_value_f = getattr(config, f"{name}_max_value")
+    attr.min_value_f = getattr(config, f"{name}_min_value")
+    return attr
+
+
+def _bool_attribute(config, name):
+    attr = _neat3p.AttributeConfig()
+    attr.default_bool = str(getattr(config, f"{name}_default")).lower()
+    attr.mutate_rate_b = getattr(config, f"{name}_mutate_rate")
+    attr.rate_to_true_add = getattr(config, f"{name}_rate_to_true_add")
+    attr.rate_to_false_add = getattr(config, f"{name}_rate_to_false_add")
+    return attr
+
+
+def _string_attribute(config, name):
+    attr = _neat3p.AttributeConfig()
+    attr.default_str = getattr(config, f"{name}_default")
+    attr.options = list(getattr(config, f"{name}_options"))
+    attr.mutate_rate_s = getattr(config, f"{name}_mutate_rate")
+    return attr
+
+
+def build_native_config(config):
+    """Translate a parsed DefaultGenomeConfig into the native DefaultGenomeConfig."""
+    params = _neat3p.GenomeParams()
+    for name in _GENOME_PARAMS:
+        setattr(params, name, getattr(config, name))
+    params.initial_connection = config.initial_connection
+    if config.connection_fraction is not None:
+        params.initial_connection = f"{config.initial_connection} {config.connection_fraction}"
+
+    native = _neat3p.DefaultGenomeConfig(params)
+    native.bias = _float_attribute(config, "bias")
+    native.response = _float_attribute(config, "response")
+    native.activation = _string_attribute(config, "activation")
+    native.aggregation = _string_attribute(config, "aggregation")
+    native.weight = _float_attribute(config, "weight")
+    native.enabled = _bool_attribute(config, "enabled")
+    return native
+
+
+def build_population_params(config):
+    """
+    Translate the [NEAT], [DefaultSpeciesSet], [DefaultStagnation] and
+    [DefaultReproduction] sections of a neat3p.Config into the PopulationParams
+    of the native Population driver.
+    """
+    params = _neat3p.PopulationParams()
+    params.pop_size = config.pop_size
+    params.fitness_criterion = config.fitness_criterion
+    params.fitness_threshold = config.fitness_threshold
+    params.reset_on_extinction = config.reset_on_extinction
+    params.no_fitness_termination = config.no_fitness_termination
+
+    species_set = _neat3p.SpeciesSetParams()
+    species_set.compatibility_threshold = config.species_set_config.compatibility_threshold
+    params.species_set = species_set
+
+    stagnation = _neat3p.StagnationParams()
+    for name in ("species_fitness_func", "max_stagnation", "species_elitism"):
+        setattr(stagnation, name, getattr(config.stagnation_config, name))
+    params.stagnation = stagnation
+
+    reproduction = _neat3p.ReproductionParams()
+    for name in ("elitism", "survival_threshold", "min_species_size"):
+        setattr(reproduction, name, getattr(config.reproduction_config, name))
+    params.reproduction = reproduction
+    return params
+
+
+class NativeGenomeConfig(DefaultGenomeConfig):
+    """DefaultGenomeConfig that also holds the equivalent native config.
+
+    The native config is rebuilt lazily after any attribute change; the node key
+    counter carries over so that new node keys stay unique.
+    """
+
+    def __init__(self, params):
+        self._native = None
+        self._next_node_key = 0
+        super().__init__(params)
+
+    def __setattr__(self, name, value):
+        native = self.__dict__.get("_native")
+        if native is not None and name not in ("_native", "_next_node_key"):
+            self.__dict__["_next_node_key"] = native.next_node_key
+            self.__dict__["_native"] = None
+        object.__setattr__(self, name, value)
+
+    @property
+    def native(self):
+        if self._native is None:
+            native = build_native_config(self)
+            native.next_node_key = max(native.next_node_key, self._next_node_key)
+            self.__dict__["_native"] = native
+        return self._native
+
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        if state["_native"] is not None:
+            state["_next_node_key"] = state["_native"].next_node_key
+        state["_native"] = None
+        return state
+
+
+class NativeGenome(_neat3p.DefaultGenome):
+    """Drop-in replacement for DefaultGenome that stores its genes natively.
+
+    Reads the same ``[DefaultGenome]`` configuration section.
+    """
+
+    config_section = "DefaultGenome"
+
+    @classmethod
+    def parse_config(cls, param_dict):
+        param_dict["node_gene_type"] = DefaultNodeGene
+        param_dict["connection_gene_type"] = DefaultConnectionGene
+        return NativeGenomeConfig(param_dict)
+
+    @classmethod
+    def write_config(cls, f, config):
+        config.save(f)
+
+    @classmethod
+    def from_bytes(cls, data):
+        genome = cls.__new__(cls)
+        genome.__setstate__(data)
+        return genome
+
+    def configure_new(self, config):
+        super().configure_new(config.native)
+
+    def configure_crossover(self, genome1, genome2, config):
+        super().configure_crossover(genome1, genome2, config.native)
+
+    def mutate(self, config):
+        super().mutate(config.native)
+
+    def mutate_add_node(self, config):
+        return super().mutate_add_node(config.native)
+
+    def mutate_add_connection(self, config):
+        super().mutate_add_connection(config.native)
+
+    def mutate_delete_node(self, config):
+        return super().mutate_delete_node(config.native)
+
+    def add_connection(self, config, input_key, output_key, weight, enabled):
+        super().add_connection(config.native, input_key, output_key, weight, enabled)
+
+    def distance(self, other, config):
+        return super().distance(other, config.native)
+
+    def get_pruned_copy(self, genome_config):
+        return super().get_pruned_copy(genome_config.native)
+
+    def __repr__(self):
+        return f"NativeGenome(key={self.key}, fitness={self.fitness}, size={self.size()})"
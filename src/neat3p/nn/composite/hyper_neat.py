@@ -17,12 +17,43 @@ output per connection layer — no ``pre`` / ``post`` / ``w`` synaptic-activity
 
 Substrate geometry is supplied as coordinate lists ``[[x, y], ...]`` for the input,
 hidden and output layers. ``make_grid_coords`` builds an evenly spaced 1-D row.
+
+On the CPU both nets run their painted weights through a ``SparseSubstrateNet``
+(also returned by ``sparse()``): a native kernel that stores each thresholded
+layer in CSR when few enough of its weights survive ``weight_threshold``, and
+densely otherwise. On other devices, or with ``native=False``, they use torch
+matmuls. ``quantized("int8" | "fp16")`` converts them into a
+``QuantizedSubstrateNet`` that evaluates the weights natively in reduced
+precision; its ``calibrate`` reports the output drift.
 """
 
 import torch
 
-from neat3p.nn.modules.activations import tanh_activation
+from neat3p.nn.modules.activations import str_to_activation, tanh_activation
 from neat3p.nn.phenotypes.cppn import clamp_weights_, create_cppn, get_coord_inputs
+from neat3p.nn.phenotypes.quantized_net import QuantizedSubstrateNet
+from neat3p.nn.phenotypes.sparse_net import SparseSubstrateNet
+
+# Activations whose native implementation matches the torch one.
+_NATIVE_ACTIVATIONS = ("sigmoid", "tanh", "abs", "gauss", "identity", "relu")
+
+
+def _find_native_activation(activation):
+    for name in _NATIVE_ACTIVATIONS:
+        if str_to_activation[name] is activation:
+            return name
+    return None
+
+
+def _native_activation_name(activation):
+    name = _find_native_activation(activation)
+    if name is None:
+        raise ValueError(f"No native implementation of activation {activation!r} for native inference")
+    return name
+
+
+def _as_numpy(tensor):
+    return tensor.detach().cpu().numpy()
 
 
 def make_grid_coords(dim: int, y_value: float = 0.0) -> list:
@@ -32,7 +63,54 @@ def make_grid_coords(dim: int, y_value: float = 0.0) -> list:
     return [[-1 + 2 * i / (dim - 1), y_value] for i in range(dim)]
 
 
-class HyperNEATNet:
+class _SubstrateNet:
+    """
+    What HyperNEATNet and HyperNEATLinearNet share: painting a weight matrix
+    from a CPPN node, and running the painted layers (``_layers``) natively.
+
+    ``native`` None runs them through a SparseSubstrateNet when the net lives on
+    the CPU and its activation has a native implementation, True always does
+    (the outputs then are CPU tensors), False keeps the torch matmuls.
+    """
+
+    def _get_weights(self, in_coords, out_coords, w_node):
+        (x_out, y_out), (x_in, y_in) = get_coord_inputs(in_coords, out_coords)
+        weights = w_node(x_out=x_out, y_out=y_out, x_in=x_in, y_in=y_in)
+        clamp_weights_(weights, self.weight_threshold, self.weight_max)
+        return weights
+
+    def _build_native_net(self):
+        if self.native is None:
+            runs_natively = (
+                torch.device(self.device).type == "cpu" and _find_native_activation(self.activation) is not None
+            )
+        else:
+            runs_natively = self.native
+        self.native_net = self.sparse() if runs_natively else None
+
+    def _layers(self):
+        raise NotImplementedError
+
+    def quantized(self, precision="int8"):
+        """This net's current weights as a QuantizedSubstrateNet (CPU, numpy in/out)."""
+        return QuantizedSubstrateNet.create(
+            self._layers(),
+            precision=precision,
+            activation=_native_activation_name(self.activation),
+            batch_size=self.batch_size,
+        )
+
+    def sparse(self, max_density=None):
+        """This net's current weights as a SparseSubstrateNet (CPU, numpy in/out)."""
+        return SparseSubstrateNet.create(
+            self._layers(),
+            activation=_native_activation_name(self.activation),
+            max_density=max_density,
+            batch_size=self.batch_size,
+        )
+
+
+class HyperNEATNet(_SubstrateNet):
     """
     Plain HyperNEAT: a CPPN paints a **fixed** input→hidden→output feed-forward net
     over the substrate geometry. Weights are queried once at construction and never
@@ -56,6 +134,7 @@ class HyperNEATNet:
         activation=tanh_activation,
         batch_size=1,
         device="cuda:0",
+        native=None,
     ):
         self.w_ih_node = w_ih_node
         self.b_h_node = b_h_node
@@ -72,14 +151,9 @@ class HyperNEATNet:
         self.activation = activation
         self.batch_size = batch_size
         self.device = device
+        self.native = native
         self.reset()
 
-    def _get_weights(self, in_coords, out_coords, w_node):
-        (x_out, y_out), (x_in, y_in) = get_coord_inputs(in_coords, out_coords)
-        weights = w_node(x_out=x_out, y_out=y_out, x_in=x_in, y_in=y_in)
-        clamp_weights_(weights, self.weight_threshold, self.weight_max)
-        return weights
-
     def reset(self, batch_size=None):
         """Build the fixed substrate weights from the CPPN.
 
@@ -95,15 +169,24 @@ class HyperNEATNet:
             self.bias_hidden = self._get_weights(bias_coords, self.hidden_coords, self.b_h_node)
             self.hidden_to_output = self._get_weights(self.hidden_coords, self.output_coords, self.w_ho_node)
             self.bias_output = self._get_weights(bias_coords, self.output_coords, self.b_o_node)
+        self._build_native_net()
 
     def activate(self, inputs):
         """inputs: (batch_size, n_inputs) → (batch_size, n_outputs)"""
+        if self.native_net is not None:
+            return torch.from_numpy(self.native_net.activate(inputs))
         with torch.no_grad():
             inputs = torch.tensor(inputs, dtype=torch.float32, device=self.device).unsqueeze(2)
             hidden = self.activation(self.input_to_hidden.matmul(inputs) + self.bias_hidden)
             outputs = self.activation(self.hidden_to_output.matmul(hidden) + self.bias_output)
         return outputs.squeeze(2)
 
+    def _layers(self):
+        return [
+            (_as_numpy(self.input_to_hidden), _as_numpy(self.bias_hidden)),
+            (_as_numpy(self.hidden_to_output), _as_numpy(self.bias_output)),
+        ]
+
     @staticmethod
     def create(
         genome,
@@ -116,12 +199,15 @@ class HyperNEATNet:
         activation=tanh_activation,
         batch_size=1,
         device="cuda:0",
+        plan_cache=None,
+        native=None,
     ):
         nodes = create_cppn(
             genome,
             config,
             ["x_in", "y_in", "x_out", "y_out"],
             ["w_ih", "b_h", "w_ho", "b_o"],
+            plan_cache=plan_cache,
         )
         return HyperNEATNet(
             *nodes,
@@ -133,10 +219,11 @@ class HyperNEATNet:
             activation=activation,
             batch_size=batch_size,
             device=device,
+            native=native,
         )
 
 
-class HyperNEATLinearNet:
+class HyperNEATLinearNet(_SubstrateNet):
     """
     Plain HyperNEAT with no hidden layer: a CPPN paints a **fixed** input→output
     weight matrix over the substrate geometry. The minimal HyperNEAT phenotype.
@@ -155,6 +242,7 @@ class HyperNEATLinearNet:
         activation=tanh_activation,
         batch_size=1,
         device="cuda:0",
+        native=None,
     ):
         self.w_node = w_node
         self.b_o_node = b_o_node
@@ -167,14 +255,9 @@ class HyperNEATLinearNet:
         self.activation = activation
         self.batch_size = batch_size
         self.device = device
+        self.native = native
         self.reset()
 
-    def _get_weights(self, in_coords, out_coords, w_node):
-        (x_out, y_out), (x_in, y_in) = get_coord_inputs(in_coords, out_coords)
-        weights = w_node(x_out=x_out, y_out=y_out, x_in=x_in, y_in=y_in)
-        clamp_weights_(weights, self.weight_threshold, self.weight_max)
-        return weights
-
     def reset(self, batch_size=None):
         """Build the fixed input→output weights from the CPPN (batch-independent)."""
         if batch_size is not None:
@@ -183,14 +266,20 @@ class HyperNEATLinearNet:
             bias_coords = torch.zeros((1, 2), dtype=torch.float32, device=self.device)
             self.input_to_output = self._get_weights(self.input_coords, self.output_coords, self.w_node)
             self.bias_output = self._get_weights(bias_coords, self.output_coords, self.b_o_node)
+        self._build_native_net()
 
     def activate(self, inputs):
         """inputs: (batch_size, n_inputs) → (batch_size, n_outputs)"""
+        if self.native_net is not None:
+            return torch.from_numpy(self.native_net.activate(inputs))
         with torch.no_grad():
             inputs = torch.tensor(inputs, dtype=torch.float32, device=self.device).unsqueeze(2)
             outputs = self.activation(self.input_to_output.matmul(inputs) + self.bias_output)
         return outputs.squeeze(2)
 
+    def _layers(self):
+        return [(_as_numpy(self.input_to_output), _as_numpy(self.bias_output))]
+
     @staticmethod
     def create(
         genome,
@@ -202,6 +291,8 @@ class HyperNEATLinearNet:
         activation=tanh_activation,
         batch_size=1,
         device="cuda:0",
+        plan_cache=None,
+        native=None,
     ):
         input_coords = make_grid_coords(state_dim, y_value=0.5)
         output_coords = make_grid_coords(action_dim, y_value=-0.5)
@@ -210,6 +301,7 @@ class HyperNEATLinearNet:
             config,
             ["x_in", "y_in", "x_out", "y_out"],
             ["w", "b_o"],
+            plan_cache=plan_cache,
         )
         return HyperNEATLinearNet(
             *nodes,
@@ -220,4 +312,5 @@ class HyperNEATLinearNet:
             activation=activation,
             batch_size=batch_size,
             device=device,
+            native=native,
         )
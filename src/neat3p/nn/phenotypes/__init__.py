@@ -1,14 +1,26 @@
-"""Genome → phenotype builders: recurrent, feed-forward, and CPPN networks."""
+"""Genome → phenotype builders: recurrent, feed-forward, packed-population, quantized, sparse and CPPN networks."""
 
-from .cppn import Leaf, Node, create_cppn, get_coord_inputs
+from .cppn import Leaf, Node, create_cppn, get_coord_inputs, update_cppn_parameters
 from .feed_forward_net import TorchFeedForwardNetwork
+from .packed_net import PackedNet
+from .plan_cache import PlanCache
+from .quantized_net import QuantizedSubstrateNet, output_drift
 from .recurrent_net import OptimizedRecurrentNet, RecurrentNet
+from .sparse_net import SparseSubstrateNet
+from .substrate_net import NativeSubstrateNet
 
 __all__ = [
     "RecurrentNet",
     "OptimizedRecurrentNet",
     "TorchFeedForwardNetwork",
+    "PackedNet",
+    "PlanCache",
+    "NativeSubstrateNet",
+    "QuantizedSubstrateNet",
+    "SparseSubstrateNet",
+    "output_drift",
     "create_cppn",
+    "update_cppn_parameters",
     "Node",
     "Leaf",
     "get_coord_inputs",
@@ -14,9 +14,11 @@
 
 import torch
 
+from neat3p._neat3p import DefaultGenome as NativeDefaultGenome
 from neat3p.graphs import required_for_output
 from neat3p.nn.modules.activations import str_to_activation
 from neat3p.nn.modules.aggregations import str_to_aggregation
+from neat3p.nn.phenotypes.plan_cache import TopologySignature, cached_plan
 
 
 class Node:
@@ -138,8 +140,12 @@ class Leaf:
         self._reset()
 
 
-def create_cppn(genome, config, leaf_names, node_names, output_activation=None):
+def create_cppn(genome, config, leaf_names, node_names, output_activation=None, plan_cache=None):
     genome_config = config.genome_config
+    if isinstance(genome, NativeDefaultGenome):
+        plan = cached_plan(plan_cache, "cppn", genome, lambda g: CppnPlan(g, genome_config))
+        return plan.build(genome, genome_config, leaf_names, node_names, output_activation)
+
     required = required_for_output(genome_config.input_keys, genome_config.output_keys, genome.connections)
 
     node_inputs = {i: [] for i in genome_config.output_keys}
@@ -196,6 +202,110 @@ def create_cppn(genome, config, leaf_names, node_names, output_activation=None):
     return outputs
 
 
+class CppnPlan:
+    """
+    Topology-dependent part of create_cppn for a native genome: the inputs of
+    every node taking part in the outputs, with the gene rows their weights,
+    biases and responses are read from.
+    """
+
+    def __init__(self, genome, genome_config):
+        self.signature = TopologySignature(genome)
+        required = required_for_output(genome_config.input_keys, genome_config.output_keys, list(genome.connections))
+        output_keys = set(genome_config.output_keys)
+
+        node_inputs = {i: [] for i in genome_config.output_keys}
+        enabled = genome.enabled.tolist()
+        for row, (i, o) in enumerate(genome.connection_keys.tolist()):
+            if not enabled[row]:
+                continue
+            if o not in required and i not in required:
+                continue
+            if i in output_keys:
+                continue
+            node_inputs.setdefault(o, []).append((i, row))
+            node_inputs.setdefault(i, [])
+        self.node_inputs = node_inputs
+        self.node_rows = {key: row for row, key in enumerate(genome.node_keys.tolist())}
+
+    def build(self, genome, genome_config, leaf_names, node_names, output_activation=None):
+        weights = genome.weights
+        biases = genome.biases
+        responses = genome.responses
+        activations = genome.activations
+        aggregations = genome.aggregations
+
+        nodes = {i: Leaf() for i in genome_config.input_keys}
+        assert len(leaf_names) == len(genome_config.input_keys)
+        leaves = {name: nodes[i] for name, i in zip(leaf_names, genome_config.input_keys)}
+
+        def build_node(idx):
+            if idx in nodes:
+                return nodes[idx]
+            row = self.node_rows[idx]
+            conns = self.node_inputs[idx]
+            children = [build_node(i) for i, _ in conns]
+            conn_rows = [r for _, r in conns]
+            if idx in genome_config.output_keys and output_activation is not None:
+                activation = output_activation
+            else:
+                activation = str_to_activation[activations[row]]
+            aggregation = str_to_aggregation[aggregations[row]]
+            node = Node(
+                children,
+                weights[conn_rows].tolist(),
+                float(responses[row]),
+                float(biases[row]),
+                activation,
+                aggregation,
+                leaves=leaves,
+            )
+            node.param_rows = (row, conn_rows)
+            node.plan = self
+            nodes[idx] = node
+            return node
+
+        for idx in genome_config.output_keys:
+            build_node(idx)
+
+        for name in leaf_names:
+            leaves[name].name = name
+
+        for i, name in zip(genome_config.output_keys, node_names):
+            nodes[i].name = name
+
+        return [nodes[i] for i in genome_config.output_keys]
+
+
+def update_cppn_parameters(outputs, genome):
+    """
+    Refreshes, in place, the weights, biases and responses of the CPPN nodes
+    returned by create_cppn for a native genome with the same topology as `genome`.
+    """
+    weights = genome.weights
+    biases = genome.biases
+    responses = genome.responses
+    stack = list(outputs)
+    seen = set()
+    checked = set()
+    while stack:
+        node = stack.pop()
+        if id(node) in seen or not isinstance(node, Node):
+            continue
+        seen.add(id(node))
+        if not hasattr(node, "param_rows"):
+            raise RuntimeError("update_cppn_parameters needs nodes created from a native genome")
+        if id(node.plan) not in checked:
+            if not node.plan.signature.matches(genome):
+                raise ValueError("Genome topology differs from the one the CPPN was created from")
+            checked.add(id(node.plan))
+        row, conn_rows = node.param_rows
+        node.weights = weights[conn_rows].tolist()
+        node.bias = float(biases[row])
+        node.response = float(responses[row])
+        stack.extend(node.children)
+
+
 def clamp_weights_(weights, weight_threshold=0.2, weight_max=3.0):
     low_idxs = weights.abs() < weight_threshold
     weights[low_idxs] = 0
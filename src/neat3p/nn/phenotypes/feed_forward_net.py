@@ -1,7 +1,10 @@
 import torch
 import torch.nn as nn
 
+from neat3p._neat3p import DefaultGenome as NativeDefaultGenome
+from neat3p._neat3p import export_feed_forward
 from neat3p.graphs import feed_forward_layers
+from neat3p.nn.phenotypes.plan_cache import TopologySignature, cached_plan
 
 
 class TorchFeedForwardNetwork(nn.Module):
@@ -16,6 +19,8 @@ class TorchFeedForwardNetwork(nn.Module):
         self.input_nodes = input_nodes
         self.output_nodes = output_nodes
         self.node_evals = node_evals
+        # Set by create() for native genomes; enables update_parameters().
+        self.plan = None
 
         all_node_ids = list(input_nodes) + list(output_nodes) + [ne[0] for ne in node_evals]
         self.max_index = max(all_node_ids) if all_node_ids else 0
@@ -49,7 +54,9 @@ class TorchFeedForwardNetwork(nn.Module):
         return outputs
 
     @staticmethod
-    def create(genome, config):
+    def create(genome, config, plan_cache=None):
+        if isinstance(genome, NativeDefaultGenome):
+            return TorchFeedForwardNetwork.create_native(genome, config, plan_cache)
         connections = [cg.key for cg in genome.connections.values() if cg.enabled]
         layers = feed_forward_layers(config.genome_config.input_keys, config.genome_config.output_keys, connections)
         node_evals = []
@@ -67,3 +74,71 @@ class TorchFeedForwardNetwork(nn.Module):
                 node_evals.append((node, activation_function, aggregation_function, ng.bias, ng.response, links))
 
         return TorchFeedForwardNetwork(config.genome_config.input_keys, config.genome_config.output_keys, node_evals)
+
+    @staticmethod
+    def create_native(genome, config, plan_cache=None):
+        """Builds the network from a compiled plan instead of walking the gene dicts."""
+        genome_config = config.genome_config
+        plan = cached_plan(plan_cache, "feed_forward", genome, lambda g: FeedForwardPlan(g, genome_config))
+        net = TorchFeedForwardNetwork(genome_config.input_keys, genome_config.output_keys, plan.node_evals(genome))
+        net.plan = plan
+        return net
+
+    def update_parameters(self, genome):
+        """
+        Refreshes weights, biases and responses from `genome`, which must have the
+        topology of the native genome this network was created from.
+        """
+        if self.plan is None:
+            raise RuntimeError("update_parameters needs a network created from a native genome")
+        if not self.plan.signature.matches(genome):
+            raise ValueError("Genome topology differs from the one the network was created from")
+        self.plan.update_node_evals(self.node_evals, genome)
+
+
+class FeedForwardPlan:
+    """
+    Topology-dependent part of TorchFeedForwardNetwork.create for a native genome:
+    evaluation order, link sources, node functions, and the gene rows each
+    weight, bias and response is read from.
+    """
+
+    def __init__(self, genome, genome_config):
+        data = export_feed_forward(genome, genome_config.input_keys, genome_config.output_keys)
+        self.signature = TopologySignature(genome)
+        self.node_keys = data["node_keys"].tolist()
+        self.node_rows = data["node_rows"]
+        self.connection_rows = data["connection_rows"]
+        indptr = data["indptr"].tolist()
+        indices = data["indices"].tolist()
+        self.links = [
+            (indices[indptr[i] : indptr[i + 1]], indptr[i], indptr[i + 1]) for i in range(len(self.node_keys))
+        ]
+        self.functions = [
+            (genome_config.activation_defs.get(act), genome_config.aggregation_function_defs.get(agg))
+            for act, agg in zip(data["activations"], data["aggregations"])
+        ]
+
+    def _parameters(self, genome):
+        return (
+            genome.biases[self.node_rows].tolist(),
+            genome.responses[self.node_rows].tolist(),
+            genome.weights[self.connection_rows].tolist(),
+        )
+
+    def node_evals(self, genome):
+        biases, responses, weights = self._parameters(genome)
+        return [
+            (node, act, agg, bias, response, list(zip(sources, weights[begin:end])))
+            for node, (act, agg), bias, response, (sources, begin, end) in zip(
+                self.node_keys, self.functions, biases, responses, self.links
+            )
+        ]
+
+    def update_node_evals(self, node_evals, genome):
+        """Writes `genome`'s parameters into `node_evals`, as built by node_evals() from this plan."""
+        biases, responses, weights = self._parameters(genome)
+        for index, (bias, response, (sources, begin, end)) in enumerate(zip(biases, responses, self.links)):
+            node, act, agg, _, _, links = node_evals[index]
+            links[:] = zip(sources, weights[begin:end])
+            node_evals[index] = (node, act, agg, bias, response, links)
@@ -0,0 +1,46 @@
+import numpy as np
+
+from neat3p._neat3p import PackedNetworks
+
+
+class PackedNet:
+    """
+    The phenotypes of a whole population of native genomes, packed into one
+    block-diagonal sparse network. A single `activate` call advances every
+    genome on every one of its `batch_size` environment instances.
+
+    With recurrent=False the networks behave like feed-forward networks; with
+    recurrent=True every node reads the previous step's values.
+    """
+
+    def __init__(self, genome_ids, packed):
+        self.genome_ids = genome_ids
+        self.packed = packed
+
+    @property
+    def batch_size(self):
+        return self.packed.batch_size
+
+    def reset(self):
+        self.packed.reset()
+
+    def activate(self, inputs):
+        """
+        inputs: (n_genomes, batch_size, n_inputs)
+        returns: (n_genomes, batch_size, n_outputs) float32 array
+        """
+        return self.packed.activate(np.ascontiguousarray(inputs, dtype=np.float32))
+
+    @staticmethod
+    def create(genomes, config, batch_size=1, recurrent=False):
+        """`genomes` is the list of (genome_id, genome) pairs handed to the fitness function."""
+        genome_config = config.genome_config
+        genome_ids = [genome_id for genome_id, _ in genomes]
+        packed = PackedNetworks(
+            [genome for _, genome in genomes],
+            genome_config.input_keys,
+            genome_config.output_keys,
+            batch_size=batch_size,
+            recurrent=recurrent,
+        )
+        return PackedNet(genome_ids, packed)
@@ -0,0 +1,78 @@
+from collections import OrderedDict
+
+import numpy as np
+
+
+class TopologySignature:
+    """Exact structure of a native genome, used to rule out topology hash collisions."""
+
+    __slots__ = ("node_keys", "connection_keys", "enabled", "activations", "aggregations")
+
+    def __init__(self, genome):
+        self.node_keys = genome.node_keys.copy()
+        self.connection_keys = genome.connection_keys.copy()
+        self.enabled = genome.enabled.copy()
+        self.activations = genome.activations
+        self.aggregations = genome.aggregations
+
+    def matches(self, genome):
+        return (
+            np.array_equal(self.node_keys, genome.node_keys)
+            and np.array_equal(self.connection_keys, genome.connection_keys)
+            and np.array_equal(self.enabled, genome.enabled)
+            and self.activations == genome.activations
+            and self.aggregations == genome.aggregations
+        )
+
+
+class PlanCache:
+    """
+    Compiled phenotype plans of native genomes, keyed by topology.
+
+    A plan holds everything a phenotype's `create` derives from the graph:
+    evaluation order, index structures and the gene rows each parameter is read
+    from, plus the TopologySignature of the genome it was compiled from as
+    `signature`. Offspring that differ from a cached genome only in weights, biases or
+    responses reuse its plan, so building their phenotype only gathers parameters.
+    Least recently used plans are evicted beyond `maxsize`.
+    """
+
+    def __init__(self, maxsize=1024):
+        self.maxsize = maxsize
+        self.hits = 0
+        self.misses = 0
+        self._plans = OrderedDict()
+
+    def __len__(self):
+        return len(self._plans)
+
+    def clear(self):
+        self._plans.clear()
+
+    def lookup(self, kind, genome, compile_plan):
+        """
+        Returns the plan stored for `kind` (a hashable describing the phenotype and
+        its structural options) and the genome's topology, compiling it with
+        `compile_plan(genome)` on a miss.
+        """
+        key = (kind, genome.topology_hash())
+        plan = self._plans.get(key)
+        if plan is not None and plan.signature.matches(genome):
+            self._plans.move_to_end(key)
+            self.hits += 1
+            return plan
+
+        self.misses += 1
+        plan = compile_plan(genome)
+        self._plans[key] = plan
+        self._plans.move_to_end(key)
+        while len(self._plans) > self.maxsize:
+            self._plans.popitem(last=False)
+        return plan
+
+
+def cached_plan(plan_cache, kind, genome, compile_plan):
+    """Looks the plan up in `plan_cache`, or just compiles it when no cache is given."""
+    if plan_cache is None:
+        return compile_plan(genome)
+    return plan_cache.lookup(kind, genome, compile_plan)
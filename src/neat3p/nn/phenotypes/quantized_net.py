@@ -0,0 +1,55 @@
+import numpy as np
+
+from neat3p._neat3p import QuantizedLayer
+from neat3p.nn.phenotypes.substrate_net import NativeSubstrateNet
+
+
+def output_drift(reference, outputs):
+    """
+    How far `outputs` stray from `reference` (both (batch_size, n_outputs)):
+    max / mean / RMS absolute difference, and the fraction of rows whose argmax
+    (the chosen action) is unchanged.
+    """
+    reference = np.asarray(reference, dtype=np.float64)
+    outputs = np.asarray(outputs, dtype=np.float64)
+    diff = np.abs(outputs - reference)
+    return {
+        "max_abs": float(diff.max(initial=0.0)),
+        "mean_abs": float(diff.mean()) if diff.size else 0.0,
+        "rms": float(np.sqrt((diff**2).mean())) if diff.size else 0.0,
+        "argmax_agreement": (
+            float(np.mean(reference.argmax(axis=1) == outputs.argmax(axis=1))) if diff.size else 1.0
+        ),
+    }
+
+
+class QuantizedSubstrateNet(NativeSubstrateNet):
+    """
+    A NativeSubstrateNet with int8 (per-row scaled) or fp16 weights. Built by
+    HyperNEATNet.quantized() / HyperNEATLinearNet.quantized().
+
+    Outputs drift slightly from the full-precision net; calibrate() measures by
+    how much on representative inputs before trading it for throughput.
+    """
+
+    layer_type = QuantizedLayer
+
+    @property
+    def precision(self):
+        return self.layers[0].precision
+
+    def calibrate(self, reference, inputs):
+        """
+        output_drift() of this net against `reference` (the full-precision net it
+        was built from) on `inputs`, plus the bytes of quantized weights.
+        """
+        expected = reference.activate(inputs)
+        if hasattr(expected, "cpu"):
+            expected = expected.cpu().numpy()
+        report = output_drift(expected, self.activate(inputs))
+        report["weight_bytes"] = self.weight_bytes
+        return report
+
+    @classmethod
+    def create(cls, layers, precision="int8", activation="tanh", batch_size=1):
+        return super().create(layers, activation=activation, batch_size=batch_size, precision=precision)
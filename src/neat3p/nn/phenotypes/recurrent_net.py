@@ -3,8 +3,11 @@ from contextlib import contextmanager
 import numpy as np
 import torch
 
+from neat3p._neat3p import DefaultGenome as NativeDefaultGenome
+from neat3p._neat3p import export_recurrent
 from neat3p.graphs import required_for_output
 from neat3p.nn.modules.activations import sigmoid_activation
+from neat3p.nn.phenotypes.plan_cache import TopologySignature, cached_plan
 
 
 def dense_from_coo(shape, conns, dtype=torch.float64, device="cpu"):
@@ -12,6 +15,10 @@ def dense_from_coo(shape, conns, dtype=torch.float64, device="cpu"):
     idxs, weights = conns
     if len(idxs) == 0:
         return mat
+    if isinstance(idxs, torch.Tensor):
+        rows, cols = idxs.to(device=device, dtype=torch.long).unbind(1)
+        mat[rows, cols] = weights.to(device=device, dtype=dtype)
+        return mat
     rows, cols = np.array(idxs).transpose()
     mat[torch.tensor(rows, device=device), torch.tensor(cols, device=device)] = torch.tensor(
         weights, dtype=dtype, device=device
@@ -19,6 +26,76 @@ def dense_from_coo(shape, conns, dtype=torch.float64, device="cpu"):
     return mat
 
 
+_BLOCKS = (
+    "input_to_hidden",
+    "hidden_to_hidden",
+    "output_to_hidden",
+    "input_to_output",
+    "hidden_to_output",
+    "output_to_output",
+)
+
+
+class RecurrentPlan:
+    """
+    Topology-dependent part of RecurrentNet.create for a native genome: the block
+    partitioning, as (destination, source) index tensors, and the gene rows every
+    weight, bias and response is read from.
+    """
+
+    def __init__(self, genome, genome_config, prune_empty=False):
+        data = export_recurrent(genome, genome_config.input_keys, genome_config.output_keys, prune_empty)
+        self.signature = TopologySignature(genome)
+        self.n_inputs = data["num_inputs"]
+        self.n_hidden = data["num_hidden"]
+        self.n_outputs = data["num_outputs"]
+        coo = torch.from_dlpack(data["coo"]).long()
+        offsets = data["block_offsets"]
+        self.block_indices = [coo[offsets[b] : offsets[b + 1]] for b in range(len(_BLOCKS))]
+        self.block_rows = [data["connection_rows"][offsets[b] : offsets[b + 1]] for b in range(len(_BLOCKS))]
+        self.hidden_rows = data["hidden_rows"]
+        self.output_rows = data["output_rows"]
+        self.output_bias_mask = data["output_bias_mask"]
+
+    def arguments(self, genome):
+        """Positional RecurrentNet arguments with the parameters of `genome`."""
+        weights = genome.weights
+        biases = genome.biases
+        responses = genome.responses
+        blocks = [(idxs, torch.from_numpy(weights[rows])) for idxs, rows in zip(self.block_indices, self.block_rows)]
+        return (
+            self.n_inputs,
+            self.n_hidden,
+            self.n_outputs,
+            *blocks,
+            torch.from_numpy(responses[self.hidden_rows]),
+            torch.from_numpy(responses[self.output_rows]),
+            torch.from_numpy(biases[self.hidden_rows]),
+            torch.from_numpy(biases[self.output_rows] * self.output_bias_mask),
+        )
+
+
+def update_recurrent_parameters(net, genome):
+    """Writes the parameters of `genome` into the matrices of a net built from its plan."""
+    if net.plan is None:
+        raise RuntimeError("update_parameters needs a net created from a native genome")
+    if not net.plan.signature.matches(genome):
+        raise ValueError("Genome topology differs from the one the net was created from")
+    _, _, _, *blocks, hidden_responses, output_responses, hidden_biases, output_biases = net.plan.arguments(genome)
+    with torch.no_grad():
+        for name, (idxs, weights) in zip(_BLOCKS, blocks):
+            if len(idxs) == 0:
+                continue
+            mat = getattr(net, name)
+            rows, cols = idxs.to(device=mat.device).unbind(1)
+            mat[rows, cols] = weights.to(device=mat.device, dtype=mat.dtype)
+        if net.n_hidden > 0:
+            net.hidden_responses.copy_(hidden_responses)
+            net.hidden_biases.copy_(hidden_biases)
+        net.output_responses.copy_(output_responses)
+        net.output_biases.copy_(output_biases)
+
+
 @contextmanager
 def _dummy_context():
     yield
@@ -56,6 +133,8 @@ class RecurrentNet:
         self.n_inputs = n_inputs
         self.n_hidden = n_hidden
         self.n_outputs = n_outputs
+        # Set by create() for native genomes; enables update_parameters().
+        self.plan = None
 
         if n_hidden > 0:
             self.input_to_hidden = dense_from_coo((n_hidden, n_inputs), input_to_hidden, dtype=dtype, device=self.device)
@@ -66,11 +145,11 @@ class RecurrentNet:
         self.output_to_output = dense_from_coo((n_outputs, n_outputs), output_to_output, dtype=dtype, device=self.device)
 
         if n_hidden > 0:
-            self.hidden_responses = torch.tensor(hidden_responses, dtype=dtype, device=self.device)
-            self.hidden_biases = torch.tensor(hidden_biases, dtype=dtype, device=self.device)
+            self.hidden_responses = torch.as_tensor(hidden_responses, dtype=dtype, device=self.device)
+            self.hidden_biases = torch.as_tensor(hidden_biases, dtype=dtype, device=self.device)
 
-        self.output_responses = torch.tensor(output_responses, dtype=dtype, device=self.device)
-        self.output_biases = torch.tensor(output_biases, dtype=dtype, device=self.device)
+        self.output_responses = torch.as_tensor(output_responses, dtype=dtype, device=self.device)
+        self.output_biases = torch.as_tensor(output_biases, dtype=dtype, device=self.device)
 
         self.reset(batch_size)
 
@@ -81,6 +160,14 @@ class RecurrentNet:
             self.activs = None
         self.outputs = torch.zeros(batch_size, self.n_outputs, dtype=self.dtype, device=self.device)
 
+    def update_parameters(self, genome):
+        """
+        Refreshes weights, biases and responses in place from `genome`, which must
+        have the topology of the native genome this net was created from (e.g. a
+        child that only went through weight mutations).
+        """
+        update_recurrent_parameters(self, genome)
+
     def activate(self, inputs):
         """
         inputs: (batch_size, n_inputs)
@@ -118,8 +205,26 @@ class RecurrentNet:
         use_current_activs=False,
         n_internal_steps=1,
         device="cuda",
+        plan_cache=None,
     ):
         genome_config = config.genome_config
+        if isinstance(genome, NativeDefaultGenome):
+            plan = cached_plan(
+                plan_cache,
+                ("recurrent", prune_empty),
+                genome,
+                lambda g: RecurrentPlan(g, genome_config, prune_empty),
+            )
+            net = RecurrentNet(
+                *plan.arguments(genome),
+                batch_size=batch_size,
+                activation=activation,
+                use_current_activs=use_current_activs,
+                n_internal_steps=n_internal_steps,
+                device=device,
+            )
+            net.plan = plan
+            return net
         required = required_for_output(genome_config.input_keys, genome_config.output_keys, genome.connections)
         if prune_empty:
             nonempty = {conn.key[1] for conn in genome.connections.values() if conn.enabled}.union(
@@ -246,6 +351,12 @@ class OptimizedRecurrentNet:
         self.dtype = dtype
         self.device = device
 
+        self.n_inputs = n_inputs
+        self.n_hidden = n_hidden
+        self.n_outputs = n_outputs
+        # Set by create() for native genomes; enables update_parameters().
+        self.plan = None
+
         self.transfer_stream = torch.cuda.Stream(device=self.device) if device.startswith("cuda") else None
 
         def async_to_device(tensor):
@@ -275,10 +386,10 @@ class OptimizedRecurrentNet:
                 dense_from_coo((n_outputs, n_outputs), output_to_output, dtype=dtype)
             )
             if n_hidden > 0:
-                self.hidden_responses = async_to_device(torch.tensor(hidden_responses, dtype=dtype))
-                self.hidden_biases = async_to_device(torch.tensor(hidden_biases, dtype=dtype))
-            self.output_responses = async_to_device(torch.tensor(output_responses, dtype=dtype))
-            self.output_biases = async_to_device(torch.tensor(output_biases, dtype=dtype))
+                self.hidden_responses = async_to_device(torch.as_tensor(hidden_responses, dtype=dtype))
+                self.hidden_biases = async_to_device(torch.as_tensor(hidden_biases, dtype=dtype))
+            self.output_responses = async_to_device(torch.as_tensor(output_responses, dtype=dtype))
+            self.output_biases = async_to_device(torch.as_tensor(output_biases, dtype=dtype))
 
         if self.transfer_stream:
             self.transfer_event = torch.cuda.Event()
@@ -297,6 +408,14 @@ class OptimizedRecurrentNet:
                 self.activs = None
             self.outputs = torch.zeros(batch_size, self.n_outputs, dtype=self.dtype, device=self.device)
 
+    def update_parameters(self, genome):
+        """
+        Refreshes weights, biases and responses in place from `genome`, which must
+        have the topology of the native genome this net was created from (e.g. a
+        child that only went through weight mutations).
+        """
+        update_recurrent_parameters(self, genome)
+
     def activate(self, inputs):
         if self.transfer_event and not self.transfer_event.query():
             raise RuntimeError("GPU transfers not complete yet!")
@@ -332,8 +451,26 @@ class OptimizedRecurrentNet:
         use_current_activs=False,
         n_internal_steps=1,
         device="cuda",
+        plan_cache=None,
     ):
         genome_config = config.genome_config
+        if isinstance(genome, NativeDefaultGenome):
+            plan = cached_plan(
+                plan_cache,
+                ("recurrent", prune_empty),
+                genome,
+                lambda g: RecurrentPlan(g, genome_config, prune_empty),
+            )
+            net = OptimizedRecurrentNet(
+                *plan.arguments(genome),
+                batch_size=batch_size,
+                activation=activation,
+                use_current_activs=use_current_activs,
+                n_internal_steps=n_internal_steps,
+                device=device,
+            )
+            net.plan = plan
+            return net
         required = required_for_output(genome_config.input_keys, genome_config.output_keys, genome.connections)
         if prune_empty:
             nonempty = {conn.key[1] for conn in genome.connections.values() if conn.enabled}.union(
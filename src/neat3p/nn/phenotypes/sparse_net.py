@@ -0,0 +1,34 @@
+from neat3p._neat3p import SparseLayer
+from neat3p.nn.phenotypes.substrate_net import NativeSubstrateNet
+
+
+class SparseSubstrateNet(NativeSubstrateNet):
+    """
+    A NativeSubstrateNet with every layer whose thresholded weights are sparse
+    enough stored and multiplied in CSR. Built by HyperNEATNet.sparse() /
+    HyperNEATLinearNet.sparse(), and what those nets run on the CPU.
+
+    Each layer picks its format from its measured density (see ``formats`` and
+    ``densities``), so mostly-pruned layers skip their zeros while dense ones
+    keep the dense kernel. Outputs match the dense computation up to float
+    rounding.
+    """
+
+    layer_type = SparseLayer
+
+    @property
+    def formats(self):
+        return [layer.format for layer in self.layers]
+
+    @property
+    def densities(self):
+        return [layer.density for layer in self.layers]
+
+    @classmethod
+    def create(cls, layers, activation="tanh", max_density=None, batch_size=1):
+        """
+        Layers with at most `max_density` nonzero weights are stored in CSR;
+        None uses the native break-even density.
+        """
+        options = {} if max_density is None else {"max_density": max_density}
+        return super().create(layers, activation=activation, batch_size=batch_size, **options)
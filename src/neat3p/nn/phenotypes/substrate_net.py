@@ -0,0 +1,51 @@
+import numpy as np
+
+
+class NativeSubstrateNet:
+    """
+    A fixed-weight substrate network (a chain of dense layers, as painted by a
+    HyperNEAT CPPN) evaluated natively on the CPU, with numpy inputs and
+    outputs. Subclasses pick the native layer (``layer_type``) and so how the
+    weights are stored: QuantizedSubstrateNet in int8 / fp16,
+    SparseSubstrateNet in CSR where few enough of them are nonzero.
+    """
+
+    layer_type = None
+
+    def __init__(self, layers, batch_size=1):
+        self.layers = layers
+        self.batch_size = batch_size
+
+    @property
+    def weight_bytes(self):
+        return sum(layer.weight_bytes for layer in self.layers)
+
+    def reset(self, batch_size=None):
+        if batch_size is not None:
+            self.batch_size = batch_size
+
+    def activate(self, inputs):
+        """inputs: (batch_size, n_inputs) → (batch_size, n_outputs) float32 array"""
+        values = np.ascontiguousarray(inputs, dtype=np.float32)
+        for layer in self.layers:
+            values = layer.forward(values)
+        return values
+
+    @classmethod
+    def create(cls, layers, activation="tanh", batch_size=1, **options):
+        """
+        `layers` is a list of (weights, bias) pairs: (rows, cols) and (rows,)
+        arrays. `options` are passed on to every ``layer_type``.
+        """
+        return cls(
+            [
+                cls.layer_type(
+                    np.ascontiguousarray(weights, dtype=np.float32),
+                    np.ascontiguousarray(np.reshape(bias, -1), dtype=np.float32),
+                    activation=activation,
+                    **options,
+                )
+                for weights, bias in layers
+            ],
+            batch_size=batch_size,
+        )
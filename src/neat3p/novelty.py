@@ -0,0 +1,115 @@
+"""
+Novelty search: scores genomes by how different their behaviour is from that of
+the population and of an archive of past behaviours, so that evolution keeps
+exploring on deceptive tasks where fitness alone stalls.
+"""
+
+import copy
+import random
+
+import numpy as np
+
+from . import _neat3p
+
+
+class NoveltySearch(object):
+    """
+    Wraps a fitness function so that each genome's fitness becomes
+    `novelty_weight * novelty + fitness_weight * fitness` before reproduction
+    sees it. Pass `evaluate` to Population.run in place of the wrapped function.
+
+    eval_function(genomes, config) sets genome.fitness as usual and returns the
+    behaviour characterization of each genome: either a dict from genome id to
+    a vector, or a sequence of vectors in the order of `genomes`.
+
+    Novelty is the mean distance to the k nearest behaviours among the current
+    population and the archive. A genome joins the archive when its novelty
+    exceeds `archive_threshold` (taken from the first nonzero median novelty
+    of a generation if None), or at random with `add_probability`. The
+    threshold is raised when many genomes get in and lowered when none do,
+    keeping the archive growth steady.
+
+    The raw fitness and the novelty of the last evaluated genomes are kept in
+    `fitness` and `novelty`; `best_genome` is a copy of the genome with the
+    highest raw fitness seen so far, taken with that raw fitness as its fitness.
+    """
+
+    def __init__(
+        self,
+        eval_function,
+        behavior_dim=None,
+        k=15,
+        novelty_weight=1.0,
+        fitness_weight=0.0,
+        archive_threshold=None,
+        add_probability=0.0,
+        num_threads=0,
+    ):
+        self.eval_function = eval_function
+        self.k = k
+        self.novelty_weight = novelty_weight
+        self.fitness_weight = fitness_weight
+        self.archive_threshold = archive_threshold
+        self.add_probability = add_probability
+        self.num_threads = num_threads
+        self.archive = _neat3p.NoveltyArchive(behavior_dim, k) if behavior_dim is not None else None
+        self.fitness = {}
+        self.novelty = {}
+        self.best_genome = None
+        self.best_fitness = None
+        self._generations_without_additions = 0
+
+    def evaluate(self, genomes, config):
+        behaviors = self.eval_function(genomes, config)
+        if isinstance(behaviors, dict):
+            behaviors = [behaviors[gid] for gid, _ in genomes]
+        behaviors = np.ascontiguousarray(behaviors, dtype=np.float32)
+        if behaviors.ndim == 1:
+            behaviors = behaviors.reshape(len(genomes), -1)
+        if len(behaviors) != len(genomes):
+            raise RuntimeError(f"Expected {len(genomes)} behaviours, got {len(behaviors)}")
+        if self.archive is None:
+            self.archive = _neat3p.NoveltyArchive(behaviors.shape[1], self.k)
+
+        novelty = self.archive.score(behaviors, self.num_threads)
+
+        self.fitness = {}
+        self.novelty = {}
+        for (gid, genome), score in zip(genomes, novelty):
+            fitness = genome.fitness if genome.fitness is not None else 0.0
+            if self.best_fitness is None or fitness > self.best_fitness:
+                self.best_genome = copy.deepcopy(genome)
+                self.best_genome.fitness = fitness
+                self.best_fitness = fitness
+            self.fitness[gid] = fitness
+            self.novelty[gid] = float(score)
+            genome.fitness = self.novelty_weight * float(score) + self.fitness_weight * fitness
+
+        self._update_archive(behaviors, novelty)
+
+    def _update_archive(self, behaviors, novelty):
+        if self.archive_threshold is None:
+            # A zero median (e.g. a first generation that all behaves alike)
+            # would never scale up, so wait for a generation that spreads out.
+            median = float(np.median(novelty))
+            if median > 0.0:
+                self.archive_threshold = median
+        threshold = self.archive_threshold if self.archive_threshold is not None else float("inf")
+        added = [
+            i
+            for i, score in enumerate(novelty)
+            if score > threshold or random.random() < self.add_probability
+        ]
+        if added:
+            self.archive.add(behaviors[added])
+        if self.archive_threshold is None:
+            return
+
+        if len(added) > 4:
+            self.archive_threshold *= 1.2
+        if added:
+            self._generations_without_additions = 0
+        else:
+            self._generations_without_additions += 1
+            if self._generations_without_additions >= 5:
+                self.archive_threshold *= 0.95
@@ -0,0 +1,107 @@
+"""
+Racing evaluation: episodes are run one round at a time, and genomes that can
+no longer make it into their species' parent pool stop being evaluated.
+"""
+
+import math
+
+
+class RacingEvaluator(object):
+    """
+    Evaluates each genome on up to `episodes` episodes, one round at a time
+    (every remaining genome plays episode 0, then episode 1, ...), so that
+    all genomes see the same episodes as long as they are in the race.
+
+    After `min_episodes` rounds, each genome gets the confidence interval
+    mean +- confidence * sigma / sqrt(n), where sigma is the within-genome
+    standard deviation of the rewards, pooled over the generation. DefaultReproduction
+    keeps the best max(ceil(survival_threshold * size), 2, elitism) members of
+    each species as parents. A genome is cut when its upper bound falls
+    below the lower bound of that many members of its species. Such a genome
+    is then almost surely not a parent, so further episodes would not change
+    the next generation.
+
+    Each genome's fitness is the mean reward over the episodes it played,
+    except for cut genomes: their few episodes give a mean as noisy as any, so
+    they get the lower bound of their interval at the time of the cut instead.
+    This keeps a lucky cut genome from outranking the survivors in adjusted
+    fitness or elitism. `episodes_run` and `episodes_budget` count the work of
+    the last generation.
+
+    episode_function(genome, config, episode) returns the reward of one
+    episode. `species_set` (Population.species) provides the species of each
+    genome. Without it, the whole population races as a single species.
+    """
+
+    def __init__(self, episode_function, episodes, species_set=None, min_episodes=2, confidence=2.0):
+        if episodes < 1:
+            raise RuntimeError("RacingEvaluator needs at least one episode")
+        self.episode_function = episode_function
+        self.episodes = episodes
+        self.species_set = species_set
+        self.min_episodes = max(2, min_episodes)
+        self.confidence = confidence
+        self.episodes_run = 0
+        self.episodes_budget = 0
+        self.cut = set()
+        self.cut_fitness = {}
+
+    def evaluate(self, genomes, config):
+        rewards = {gid: [] for gid, _ in genomes}
+        active = list(genomes)
+        self.cut = set()
+        self.cut_fitness = {}
+        for episode in range(self.episodes):
+            for gid, genome in active:
+                rewards[gid].append(float(self.episode_function(genome, config, episode)))
+            if episode + 1 >= self.min_episodes and episode + 1 < self.episodes:
+                losers = self._losers(rewards, config)
+                self.cut |= set(losers)
+                self.cut_fitness.update(losers)
+                active = [(gid, genome) for gid, genome in active if gid not in losers]
+            if not active:
+                break
+
+        self.episodes_run = sum(len(r) for r in rewards.values())
+        self.episodes_budget = self.episodes * len(genomes)
+        for gid, genome in genomes:
+            if gid in self.cut_fitness:
+                genome.fitness = self.cut_fitness[gid]
+            else:
+                genome.fitness = sum(rewards[gid]) / len(rewards[gid])
+
+    def _losers(self, rewards, config):
+        """The genomes to cut now, with the lower bounds of their intervals."""
+        # Pooled within-genome variance of the rewards seen so far.
+        squares = 0.0
+        dof = 0
+        for r in rewards.values():
+            if len(r) > 1:
+                m = sum(r) / len(r)
+                squares += sum((x - m) ** 2 for x in r)
+                dof += len(r) - 1
+        sigma = math.sqrt(squares / dof) if dof > 0 else 0.0
+
+        groups = {}
+        for gid in rewards:
+            sid = self.species_set.get_species_id(gid) if self.species_set is not None else None
+            groups.setdefault(sid, []).append(gid)
+
+        reproduction_config = config.reproduction_config
+        losers = {}
+        for members in groups.values():
+            parents = max(int(math.ceil(reproduction_config.survival_threshold * len(members))), 2)
+            parents = max(parents, reproduction_config.elitism)
+            if parents >= len(members):
+                continue
+            bounds = {}
+            for gid in members:
+                r = rewards[gid]
+                half_width = self.confidence * sigma / math.sqrt(len(r))
+                mean = sum(r) / len(r)
+                bounds[gid] = (mean - half_width, mean + half_width)
+            cutoff = sorted((lower for lower, _ in bounds.values()), reverse=True)[parents - 1]
+            losers.update(
+                (gid, lower) for gid, (lower, upper) in bounds.items() if upper < cutoff and gid not in self.cut
+            )
+        return losers
@@ -183,6 +183,8 @@ class DefaultReproduction(DefaultClassConfig):
                 child = config.genome_type(key=gid)
                 child.configure_crossover(parent1, parent2, config.genome_config)
                 child.mutate(config.genome_config)
+                if hasattr(species, "record_birth"):
+                    species.record_birth(child, parent1, parent2)
                 # TODO: if config.genome_config.feed_forward, no cycles should exist
                 new_population[gid] = child
                 self.ancestors[gid] = (parent1_id, parent2_id)
@@ -2,6 +2,7 @@
 
 from itertools import count
 
+from . import _neat3p
 from .config import ConfigParameter, DefaultClassConfig
 from .math_util import mean, stdev
 
@@ -26,9 +27,10 @@ class Species(object):
 
 
 class GenomeDistanceCache(object):
-    def __init__(self, config):
+    def __init__(self, config, native=None):
         self.distances = {}
         self.config = config
+        self.native = native
         self.hits = 0
         self.misses = 0
 
@@ -38,7 +40,10 @@ class GenomeDistanceCache(object):
         d = self.distances.get((g0, g1))
         if d is None:
             # Distance is not already computed.
-            d = genome0.distance(genome1, self.config)
+            if self.native is not None:
+                d = self.native.distance(genome0, genome1, self.config.native)
+            else:
+                d = genome0.distance(genome1, self.config)
             self.distances[g0, g1] = d
             self.distances[g1, g0] = d
             self.misses += 1
@@ -58,6 +63,14 @@ class DefaultSpeciesSet(DefaultClassConfig):
         self.indexer = count(1)
         self.species = {}
         self.genome_to_species = {}
+        # Native distances kept across generations, for genomes backed by the C++ DefaultGenome.
+        self.distance_cache = None
+
+    def __getstate__(self):
+        # The native cache is not picklable; the next speciate() starts a new one.
+        state = self.__dict__.copy()
+        state["distance_cache"] = None
+        return state
 
     @classmethod
     def parse_config(cls, param_dict):
@@ -79,7 +92,8 @@ class DefaultSpeciesSet(DefaultClassConfig):
 
         # Find the best representatives for each existing species.
         unspeciated = set(population)
-        distances = GenomeDistanceCache(config.genome_config)
+        native = self._native_distance_cache(config)
+        distances = GenomeDistanceCache(config.genome_config, native)
         new_representatives = {}
         new_members = {}
         for sid, s in self.species.items():
@@ -140,6 +154,25 @@ class DefaultSpeciesSet(DefaultClassConfig):
             gdstdev = stdev(distances.distances.values())
             self.reporters.info("Mean genetic distance {0:.3f}, standard deviation {1:.3f}".format(gdmean, gdstdev))
 
+        if native is not None:
+            native.retain(list(population))
+
+    def _native_distance_cache(self, config):
+        if getattr(self, "distance_cache", None) is None:
+            self.distance_cache = None
+            if issubclass(config.genome_type, _neat3p.DefaultGenome) and hasattr(config.genome_config, "native"):
+                self.distance_cache = _neat3p.DistanceCache()
+        return self.distance_cache
+
+    def record_birth(self, child, parent1, parent2):
+        """
+        Called by reproduction for each new child. With native genomes, the child's
+        distances to the old representatives are then derived from its parent's
+        instead of being recomputed from scratch in the next speciate().
+        """
+        if getattr(self, "distance_cache", None) is not None:
+            self.distance_cache.record_birth(child, parent1, parent2)
+
     def get_species_id(self, individual_id):
         return self.genome_to_species[individual_id]
 
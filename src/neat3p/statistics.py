@@ -5,13 +5,14 @@ the most-fit genomes and information on genome/species fitness and species sizes
 
 import copy
 import csv
+import math
 
+import numpy as np
+
+from ._neat3p import StreamingStats
 from .math_util import mean, median2, stdev
 from .reporting import BaseReporter
 
-# TODO: Make a version of this reporter that doesn't continually increase memory usage.
-# (Maybe periodically write blocks of history to disk, or log stats in a database?)
-
 
 class StatisticsReporter(BaseReporter):
     """
@@ -140,3 +141,128 @@ class StatisticsReporter(BaseReporter):
             species_fitness.append(fitness)
 
         return species_fitness
+
+
+class StreamingStatisticsReporter(BaseReporter):
+    """
+    Constant-memory counterpart of StatisticsReporter. Each generation's fitness
+    and species arrays go to a native sink that keeps per-generation summaries
+    for the last `window` generations, plus run-wide moments and quantile
+    estimates over every fitness value. Only the `keep_best` fittest genomes are
+    stored. Queries and CSV exports cover the window; with `log_filename`, one
+    row per generation (generation, best, mean, stdev, median) is also appended
+    to a CSV file as the run goes.
+    """
+
+    def __init__(self, window=1024, quantiles=(0.1, 0.5, 0.9), keep_best=10, log_filename=None, delimiter=" "):
+        BaseReporter.__init__(self)
+        self.stats = StreamingStats(window, list(quantiles))
+        self.keep_best = keep_best
+        self.log_filename = log_filename
+        self.delimiter = delimiter
+        self.generation = 0
+        self._best = {}
+
+    def start_generation(self, generation):
+        self.generation = generation
+
+    def post_evaluate(self, config, population, species, best_genome):
+        n = len(population)
+        fitness = np.fromiter((g.fitness for g in population.values()), dtype=np.float64, count=n)
+        species_ids = np.fromiter((species.get_species_id(k) for k in population), dtype=np.int32, count=n)
+        self.stats.ingest(self.generation, fitness, species_ids)
+
+        self._remember_best(best_genome)
+        self._log()
+
+    def _remember_best(self, genome):
+        if self.keep_best <= 0:
+            return
+        if genome.key not in self._best and len(self._best) >= self.keep_best:
+            worst = min(self._best.values(), key=lambda g: g.fitness)
+            if worst.fitness >= genome.fitness:
+                return
+            del self._best[worst.key]
+        self._best[genome.key] = copy.deepcopy(genome)
+
+    def _log(self):
+        if self.log_filename is None:
+            return
+        summary = self.stats.summary()
+        row = [self.generation] + [float(summary[name][-1]) for name in ("max", "mean", "stdev", "median")]
+        with open(self.log_filename, "a") as f:
+            csv.writer(f, delimiter=self.delimiter).writerow(row)
+
+    def get_fitness_mean(self):
+        """Get the per-generation mean fitness."""
+        return self.stats.summary()["mean"].tolist()
+
+    def get_fitness_stdev(self):
+        """Get the per-generation standard deviation of the fitness."""
+        return self.stats.summary()["stdev"].tolist()
+
+    def get_fitness_median(self):
+        """Get the per-generation median fitness."""
+        return self.stats.summary()["median"].tolist()
+
+    def get_fitness_best(self):
+        """Get the per-generation best fitness."""
+        return self.stats.summary()["max"].tolist()
+
+    def get_run_statistics(self):
+        """Mean, stdev, min, max and quantile estimates of every fitness value seen in the run."""
+        return {
+            "count": self.stats.run_count,
+            "mean": self.stats.run_mean,
+            "stdev": self.stats.run_stdev,
+            "min": self.stats.run_min,
+            "max": self.stats.run_max,
+            "quantiles": self.stats.run_quantiles(),
+        }
+
+    def best_unique_genomes(self, n):
+        """Returns the most n fit genomes, with no duplication."""
+        return sorted(self._best.values(), key=lambda g: g.fitness, reverse=True)[:n]
+
+    def best_genomes(self, n):
+        """Returns the n most fit genomes ever seen (at most keep_best)."""
+        return self.best_unique_genomes(n)
+
+    def best_genome(self):
+        """Returns the most fit genome ever seen."""
+        return self.best_genomes(1)[0]
+
+    def get_species_sizes(self):
+        return self.stats.species_table()["sizes"].tolist()
+
+    def get_species_fitness(self, null_value=""):
+        return [
+            [null_value if math.isnan(f) else f for f in row] for row in self.stats.species_table()["fitness"].tolist()
+        ]
+
+    def save(self):
+        self.save_genome_fitness()
+        self.save_species_count()
+        self.save_species_fitness()
+
+    def save_genome_fitness(self, delimiter=" ", filename="fitness_history.csv"):
+        """Saves the population's best and average fitness."""
+        summary = self.stats.summary()
+        with open(filename, "w") as f:
+            w = csv.writer(f, delimiter=delimiter)
+            for best, avg in zip(summary["max"].tolist(), summary["mean"].tolist()):
+                w.writerow([best, avg])
+
+    def save_species_count(self, delimiter=" ", filename="speciation.csv"):
+        """Log speciation throughout evolution."""
+        with open(filename, "w") as f:
+            w = csv.writer(f, delimiter=delimiter)
+            for s in self.get_species_sizes():
+                w.writerow(s)
+
+    def save_species_fitness(self, delimiter=" ", null_value="NA", filename="species_fitness.csv"):
+        """Log species' average fitness throughout evolution."""
+        with open(filename, "w") as f:
+            w = csv.writer(f, delimiter=delimiter)
+            for s in self.get_species_fitness(null_value):
+                w.writerow(s)
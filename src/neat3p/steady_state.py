@@ -0,0 +1,239 @@
+"""
+Steady-state (rtNEAT-style) evolution: evaluation and reproduction overlap, with
+one offspring replacing the worst individual whenever a worker frees up.
+"""
+
+import math
+import os
+import random
+from concurrent.futures import FIRST_COMPLETED, ProcessPoolExecutor, wait
+
+from .population import Population
+from .species import Species
+
+
+class SteadyStatePopulation(Population):
+    """
+    Continuous replacement instead of generational barriers:
+        1. Keep every worker busy evaluating one genome.
+        2. When an evaluation finishes, place the genome into the closest species
+           (only its distance to the current representatives is computed).
+        3. Remove the worst evaluated individual, by fitness shared within its
+           species, and submit an offspring of a species chosen in proportion to
+           its adjusted fitness.
+
+    `species.members` and `population` only ever contain evaluated genomes, so the
+    usual reporters work unchanged. Every pop_size completed evaluations count as a
+    generation: reporters get their start/post_evaluate/end callbacks and species
+    stagnation is updated; stagnant species stop breeding and lose members first.
+
+    Reproduction, speciation and stagnation parameters are read from the usual
+    DefaultReproduction / DefaultSpeciesSet / DefaultStagnation sections.
+    """
+
+    def __init__(self, config, initial_state=None):
+        super().__init__(config, initial_state)
+        self.pending = {}
+        self.stagnant = set()
+        self.evaluations = 0
+        self._fitness_sums = {}
+
+        # Genomes without a fitness (all of them for a new population) are moved
+        # out of their species and queued; they rejoin a species once evaluated.
+        for gid, g in list(self.population.items()):
+            if g.fitness is None:
+                self.pending[gid] = self.population.pop(gid)
+                self._leave_species(gid)
+        for sid, s in self.species.species.items():
+            self._fitness_sums[sid] = sum(s.get_fitnesses())
+
+    def run(self, eval_function, n=None, num_workers=None, executor=None):
+        """
+        Runs for at most n generations' worth of evaluations (n * pop_size). If n
+        is None, run until a solution is found.
+
+        `eval_function(genome, config)` returns the genome's fitness, as for
+        ParallelEvaluator. Evaluations are submitted to `executor` (any
+        concurrent.futures.Executor) with `num_workers` evaluations in flight, or
+        to a process pool of `num_workers` (default: one per CPU).
+        """
+        if self.config.no_fitness_termination and (n is None):
+            raise RuntimeError("Cannot have no generational limit with no fitness termination")
+
+        num_workers = num_workers or os.cpu_count() or 1
+        owns_executor = executor is None
+        if owns_executor:
+            executor = ProcessPoolExecutor(max_workers=num_workers)
+
+        max_evaluations = None if n is None else self.evaluations + n * self.config.pop_size
+        submitted = self.evaluations
+        queued = list(self.pending.values())
+        running = {}
+        self.reporters.start_generation(self.generation)
+        try:
+            while True:
+                while len(running) < num_workers and (max_evaluations is None or submitted < max_evaluations):
+                    # Offspring need an evaluated parent; until one exists, only
+                    # the initial genomes can be handed out.
+                    if not queued and not self.population:
+                        break
+                    genome = queued.pop() if queued else self._breed()
+                    running[executor.submit(eval_function, genome, self.config)] = genome
+                    submitted += 1
+                if not running:
+                    break
+
+                done, _ = wait(running, return_when=FIRST_COMPLETED)
+                for future in done:
+                    genome = running.pop(future)
+                    genome.fitness = future.result()
+                    if self._add_evaluated(genome):
+                        self.reporters.found_solution(self.config, self.generation, self.best_genome)
+                        return self.best_genome
+        finally:
+            for future in running:
+                future.cancel()
+            if owns_executor:
+                executor.shutdown(wait=True, cancel_futures=True)
+
+        if self.config.no_fitness_termination:
+            self.reporters.found_solution(self.config, self.generation, self.best_genome)
+
+        return self.best_genome
+
+    def _add_evaluated(self, genome):
+        """Files an evaluated genome into its species. Returns True if it meets the fitness threshold."""
+        if genome.fitness is None:
+            raise RuntimeError("Fitness not assigned to genome {}".format(genome.key))
+        del self.pending[genome.key]
+        self._join_species(genome)
+        self.population[genome.key] = genome
+        self.evaluations += 1
+
+        if self.best_genome is None or genome.fitness > self.best_genome.fitness:
+            self.best_genome = genome
+
+        if self.evaluations % self.config.pop_size == 0:
+            self._end_generation()
+
+        if self.config.no_fitness_termination:
+            return False
+        fv = self.fitness_criterion(g.fitness for g in self.population.values())
+        return fv >= self.config.fitness_threshold
+
+    def _end_generation(self):
+        best = max(self.population.values(), key=lambda g: g.fitness)
+        self.reporters.post_evaluate(self.config, self.population, self.species, best)
+
+        self.stagnant = set()
+        for sid, s, stagnant in self.reproduction.stagnation.update(self.species, self.generation):
+            if stagnant:
+                self.reporters.species_stagnant(sid, s)
+                self.stagnant.add(sid)
+        self._adjusted_fitnesses()
+
+        self.reporters.end_generation(self.config, self.population, self.species)
+        self.generation += 1
+        self.reporters.start_generation(self.generation)
+
+    def _join_species(self, genome):
+        """Adds the genome to the species with the closest representative, or founds a new one."""
+        species_set = self.species
+        threshold = species_set.species_set_config.compatibility_threshold
+        best_sid, best_distance = None, threshold
+        for sid, s in species_set.species.items():
+            d = s.representative.distance(genome, self.config.genome_config)
+            if d < best_distance:
+                best_sid, best_distance = sid, d
+
+        if best_sid is None:
+            best_sid = next(species_set.indexer)
+            s = Species(best_sid, self.generation)
+            s.update(genome, {})
+            species_set.species[best_sid] = s
+            self._fitness_sums[best_sid] = 0.0
+        species_set.species[best_sid].members[genome.key] = genome
+        species_set.genome_to_species[genome.key] = best_sid
+        self._fitness_sums[best_sid] += genome.fitness
+
+    def _leave_species(self, gid):
+        """
+        Removes a genome from its species, dropping the species when it empties.
+        If the genome represented its species, the member closest to it takes over.
+        """
+        species_set = self.species
+        sid = species_set.genome_to_species.pop(gid)
+        s = species_set.species[sid]
+        g = s.members.pop(gid)
+        if sid in self._fitness_sums and g.fitness is not None:
+            self._fitness_sums[sid] -= g.fitness
+        if not s.members:
+            del species_set.species[sid]
+            self._fitness_sums.pop(sid, None)
+            self.stagnant.discard(sid)
+        elif s.representative is g:
+            genome_config = self.config.genome_config
+            s.representative = min(s.members.values(), key=lambda m: g.distance(m, genome_config))
+
+    def _adjusted_fitnesses(self):
+        """Sets each species' adjusted fitness: its mean fitness, normalized across species."""
+        species = self.species.species
+        means = {sid: self._fitness_sums[sid] / len(s.members) for sid, s in species.items()}
+        if not means:
+            return
+        min_fitness = min(means.values())
+        fitness_range = max(1.0, max(means.values()) - min_fitness)
+        for sid, s in species.items():
+            s.adjusted_fitness = (means[sid] - min_fitness) / fitness_range
+
+    def _remove_worst(self):
+        """
+        Drops the evaluated individual with the lowest fitness shared within its
+        species, preferring stagnant species; the best genome is never removed.
+        """
+        fitnesses = [g.fitness for g in self.population.values()]
+        min_fitness = min(fitnesses)
+        fitness_range = max(1.0, max(fitnesses) - min_fitness)
+
+        def key(item):
+            gid, g = item
+            size = len(self.species.get_species(gid).members)
+            shared = (g.fitness - min_fitness) / fitness_range / size
+            return self.species.get_species_id(gid) not in self.stagnant, shared, -size
+
+        candidates = [item for item in self.population.items() if item[1] is not self.best_genome]
+        if not candidates:
+            return
+        gid, _ = min(candidates, key=key)
+        del self.population[gid]
+        self._leave_species(gid)
+
+    def _breed(self):
+        """Replaces the worst individual by an offspring, which is queued for evaluation."""
+        if len(self.population) + len(self.pending) >= self.config.pop_size:
+            self._remove_worst()
+
+        self._adjusted_fitnesses()
+        species = [s for sid, s in self.species.species.items() if sid not in self.stagnant]
+        if not species:
+            species = list(self.species.species.values())
+        weights = [s.adjusted_fitness for s in species]
+        if sum(weights) > 0:
+            parent_species = random.choices(species, weights=weights)[0]
+        else:
+            parent_species = random.choice(species)
+
+        reproduction_config = self.reproduction.reproduction_config
+        members = sorted(parent_species.members.items(), reverse=True, key=lambda x: x[1].fitness)
+        cutoff = max(2, int(math.ceil(reproduction_config.survival_threshold * len(members))))
+        members = members[:cutoff]
+        parent1_id, parent1 = random.choice(members)
+        parent2_id, parent2 = random.choice(members)
+
+        gid = next(self.reproduction.genome_indexer)
+        child = self.config.genome_type(key=gid)
+        child.configure_crossover(parent1, parent2, self.config.genome_config)
+        child.mutate(self.config.genome_config)
+        self.reproduction.ancestors[gid] = (parent1_id, parent2_id)
+        self.pending[gid] = child
+        return child
@@ -0,0 +1,168 @@
+#include "novelty.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+using Neighbour = std::pair<float, uint32_t>;
+
+float squared_distance(const float *a, const float *b, size_t dim) {
+    float d = 0.0f;
+    for (size_t i = 0; i < dim; i++) {
+        const float diff = a[i] - b[i];
+        d += diff * diff;
+    }
+    return d;
+}
+
+// Offers a candidate to the bounded max-heap of the k best neighbours.
+void offer(std::vector<Neighbour> &best, size_t k, float d, uint32_t index) {
+    if (best.size() < k) {
+        best.emplace_back(d, index);
+        std::push_heap(best.begin(), best.end());
+    }
+    else if (d < best.front().first) {
+        std::pop_heap(best.begin(), best.end());
+        best.back() = {d, index};
+        std::push_heap(best.begin(), best.end());
+    }
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// KdTree
+// ---------------------------------------------------------------------------
+KdTree::KdTree(const float *points, size_t n, size_t dim) : points_(points), dim_(dim) {
+    order_.resize(n);
+    for (size_t i = 0; i < n; i++) order_[i] = static_cast<uint32_t>(i);
+    nodes_.reserve(2 * (n / kLeafSize + 1));
+    if (n > 0) build(0, static_cast<uint32_t>(n));
+}
+
+int32_t KdTree::build(uint32_t begin, uint32_t end) {
+    const int32_t id = static_cast<int32_t>(nodes_.size());
+    nodes_.push_back({begin, end});
+    if (end - begin <= kLeafSize) return id;
+
+    // Split along the dimension with the widest spread.
+    uint32_t split_dim = 0;
+    float widest = -1.0f;
+    for (size_t d = 0; d < dim_; d++) {
+        float lo = points_[order_[begin] * dim_ + d];
+        float hi = lo;
+        for (uint32_t i = begin + 1; i < end; i++) {
+            const float v = points_[order_[i] * dim_ + d];
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+        }
+        if (hi - lo > widest) {
+            widest = hi - lo;
+            split_dim = static_cast<uint32_t>(d);
+        }
+    }
+
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(order_.begin() + begin, order_.begin() + mid, order_.begin() + end,
+                     [&](uint32_t a, uint32_t b) {
+                         return points_[a * dim_ + split_dim] < points_[b * dim_ + split_dim];
+                     });
+    const float split = points_[order_[mid] * dim_ + split_dim];
+    const int32_t left = build(begin, mid);
+    const int32_t right = build(mid, end);
+    Node &node = nodes_[id];
+    node.left = left;
+    node.right = right;
+    node.split_dim = split_dim;
+    node.split = split;
+    return id;
+}
+
+void KdTree::nearest(const float *query, size_t k, std::vector<Neighbour> &best,
+                     size_t skip) const {
+    if (!nodes_.empty() && k > 0) search(0, query, k, best, skip);
+}
+
+void KdTree::search(int32_t id, const float *query, size_t k, std::vector<Neighbour> &best,
+                    size_t skip) const {
+    const Node &node = nodes_[id];
+    if (node.left < 0) {
+        for (uint32_t i = node.begin; i < node.end; i++) {
+            const uint32_t p = order_[i];
+            if (p == skip) continue;
+            offer(best, k, squared_distance(query, points_ + p * dim_, dim_), p);
+        }
+        return;
+    }
+
+    // Left holds values <= split, right values >= split; visit the near side
+    // first and the far side only if it can still hold a closer point.
+    const float diff = query[node.split_dim] - node.split;
+    const int32_t near = diff < 0.0f ? node.left : node.right;
+    const int32_t far = diff < 0.0f ? node.right : node.left;
+    search(near, query, k, best, skip);
+    if (best.size() < k || diff * diff < best.front().first) search(far, query, k, best, skip);
+}
+
+// ---------------------------------------------------------------------------
+// NoveltyArchive
+// ---------------------------------------------------------------------------
+NoveltyArchive::NoveltyArchive(size_t dim, size_t k) : dim_(dim), k_(k) {
+    if (dim_ == 0) throw std::invalid_argument("behaviour dimension must be positive");
+    if (k_ == 0) throw std::invalid_argument("k must be positive");
+}
+
+void NoveltyArchive::add(const float *behaviors, size_t n) {
+    const float *old_data = points_.data();
+    points_.insert(points_.end(), behaviors, behaviors + n * dim_);
+    // The tree points into points_; rebuild if it moved or the unindexed tail
+    // has grown too long to scan.
+    const size_t tail = size() - tree_.size();
+    if (points_.data() != old_data || tail > std::max<size_t>(64, tree_.size() / 4)) reindex();
+}
+
+void NoveltyArchive::reindex() { tree_ = KdTree(points_.data(), size(), dim_); }
+
+void NoveltyArchive::score(const float *behaviors, size_t n, float *novelty,
+                           size_t num_threads) {
+    const KdTree batch(behaviors, n, dim_);
+    const size_t indexed = tree_.size();
+    const size_t archived = size();
+
+    auto work = [&](size_t begin, size_t end) {
+        std::vector<Neighbour> best;
+        best.reserve(k_);
+        for (size_t q = begin; q < end; q++) {
+            const float *query = behaviors + q * dim_;
+            best.clear();
+            tree_.nearest(query, k_, best);
+            for (size_t p = indexed; p < archived; p++)
+                offer(best, k_, squared_distance(query, points_.data() + p * dim_, dim_),
+                      static_cast<uint32_t>(p));
+            // Batch indices are offset past the archive so they stay distinct.
+            std::vector<Neighbour> from_batch;
+            batch.nearest(query, k_, from_batch, q);
+            for (const Neighbour &nb : from_batch)
+                offer(best, k_, nb.first, static_cast<uint32_t>(archived + nb.second));
+
+            float sum = 0.0f;
+            for (const Neighbour &nb : best) sum += std::sqrt(nb.first);
+            novelty[q] = best.empty() ? 0.0f : sum / static_cast<float>(best.size());
+        }
+    };
+
+    if (num_threads == 0) num_threads = std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::min(num_threads, std::max<size_t>(1, n / 16));
+    if (num_threads <= 1) {
+        work(0, n);
+        return;
+    }
+    std::vector<std::thread> threads;
+    const size_t chunk = (n + num_threads - 1) / num_threads;
+    for (size_t begin = 0; begin < n; begin += chunk)
+        threads.emplace_back(work, begin, std::min(n, begin + chunk));
+    for (std::thread &t : threads) t.join();
+}
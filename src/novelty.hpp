@@ -0,0 +1,82 @@
+#ifndef NOVELTY_HPP
+#define NOVELTY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// KdTree: a static k-d tree over row-major float points, split at the median
+// of the widest dimension, with leaves of up to kLeafSize points. It stores
+// indices only; the points stay owned by the caller.
+// ---------------------------------------------------------------------------
+class KdTree {
+   public:
+    KdTree() = default;
+    KdTree(const float *points, size_t n, size_t dim);
+
+    size_t size() const { return order_.size(); }
+
+    // Adds the squared distances from `query` to its k nearest points to the
+    // bounded max-heap `best` (holding at most k entries), skipping the point
+    // with index `skip`.
+    void nearest(const float *query, size_t k, std::vector<std::pair<float, uint32_t>> &best,
+                 size_t skip = SIZE_MAX) const;
+
+   private:
+    static constexpr size_t kLeafSize = 16;
+
+    struct Node {
+        uint32_t begin;
+        uint32_t end;
+        int32_t left = -1;  // -1 for a leaf
+        int32_t right = -1;
+        uint32_t split_dim = 0;
+        float split = 0.0f;
+    };
+
+    int32_t build(uint32_t begin, uint32_t end);
+    void search(int32_t node, const float *query, size_t k,
+                std::vector<std::pair<float, uint32_t>> &best, size_t skip) const;
+
+    const float *points_ = nullptr;
+    size_t dim_ = 0;
+    std::vector<uint32_t> order_;
+    std::vector<Node> nodes_;
+};
+
+// ---------------------------------------------------------------------------
+// NoveltyArchive: behaviour characterizations of past genomes, indexed for
+// k-nearest-neighbour queries. New behaviours are appended to a tail that is
+// scanned linearly until it grows past a quarter of the indexed points, at
+// which point the tree is rebuilt; the amortized cost of adding stays
+// O(log n) per point.
+// ---------------------------------------------------------------------------
+class NoveltyArchive {
+   public:
+    explicit NoveltyArchive(size_t dim, size_t k = 15);
+
+    size_t dim() const { return dim_; }
+    size_t k() const { return k_; }
+    size_t size() const { return points_.size() / dim_; }
+    const std::vector<float> &points() const { return points_; }
+
+    void add(const float *behaviors, size_t n);
+
+    // Novelty of each of the n behaviours: the mean Euclidean distance to its
+    // k nearest neighbours among the archive and the other behaviours of the
+    // batch (the current population). Queries are split over num_threads
+    // threads (0 = hardware concurrency).
+    void score(const float *behaviors, size_t n, float *novelty, size_t num_threads = 0);
+
+   private:
+    void reindex();
+
+    size_t dim_;
+    size_t k_;
+    std::vector<float> points_;
+    KdTree tree_;
+};
+
+#endif  // NOVELTY_HPP
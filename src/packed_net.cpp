@@ -0,0 +1,356 @@
+#include "packed_net.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "connectivity.hpp"
+#include "graphs.hpp"
+
+namespace {
+
+// Incoming links of one evaluated node, by node key.
+struct NodeEval {
+    int key;
+    std::vector<std::pair<int, float>> links;
+};
+
+std::vector<NodeEval> feed_forward_evals(const DefaultGenome &genome,
+                                         const std::vector<int> &input_keys,
+                                         const std::vector<int> &output_keys) {
+    FeedForwardConnectivity ff = feed_forward_connectivity(genome, input_keys, output_keys);
+    std::vector<NodeEval> evals(ff.node_keys.size());
+    for (size_t i = 0; i < evals.size(); i++) {
+        evals[i].key = ff.node_keys[i];
+        for (int32_t k = ff.indptr[i]; k < ff.indptr[i + 1]; k++)
+            evals[i].links.emplace_back(ff.indices[k], ff.weights[k]);
+    }
+    return evals;
+}
+
+std::vector<NodeEval> recurrent_evals(const DefaultGenome &genome,
+                                      const std::vector<int> &input_keys,
+                                      const std::vector<int> &output_keys) {
+    const ConnectionGeneTable &conns = genome.connections;
+    std::unordered_set<int> required = required_for_output(input_keys, output_keys, conns.keys);
+
+    std::vector<NodeEval> evals;
+    std::unordered_map<int, size_t> row_of;
+    for (size_t c = 0; c < conns.size(); c++) {
+        if (!conns.enabled[c]) continue;
+        const auto [i, o] = conns.keys[c];
+        if (!required.count(i) && !required.count(o)) continue;
+        auto [it, added] = row_of.emplace(o, evals.size());
+        if (added) evals.push_back({o, {}});
+        evals[it->second].links.emplace_back(i, conns.weight[c]);
+    }
+    return evals;
+}
+
+// Folds links [begin, end) of one row into acc[l * batch + b] for the lanes
+// [lane_begin, lane_end), of which lane l has counts[l] real links. src is the
+// group's state.
+template <typename Combine>
+void fold_links(const float *weights, const int32_t *indices, int32_t begin, int32_t end,
+                const int32_t *counts, const float *src, size_t batch, int lane_begin,
+                int lane_end, float *acc, Combine combine) {
+    constexpr int kLanes = PackedNetworks::kLanes;
+    if (batch == 1) {
+        // One genome per lane: every link is a gather across the lanes,
+        // padding included.
+        for (int32_t k = begin; k < end; k++) {
+            const float *w = weights + static_cast<size_t>(k) * kLanes;
+            const int32_t *idx = indices + static_cast<size_t>(k) * kLanes;
+            for (int l = lane_begin; l < lane_end; l++)
+                acc[l] = combine(acc[l], w[l] * src[idx[l]], k == begin);
+        }
+        return;
+    }
+    // Each lane's links are contiguous loops over the batch; padding is skipped.
+    for (int l = lane_begin; l < lane_end; l++) {
+        float *a = acc + l * batch;
+        for (int32_t k = begin; k < begin + counts[l]; k++) {
+            const float w = weights[static_cast<size_t>(k) * kLanes + l];
+            const float *s = src + indices[static_cast<size_t>(k) * kLanes + l];
+            for (size_t b = 0; b < batch; b++) a[b] = combine(a[b], w * s[b], k == begin);
+        }
+    }
+}
+
+// Aggregates one row for the lanes [lane_begin, lane_end), all of which use
+// `agg`.
+void aggregate(Aggregation agg, const float *weights, const int32_t *indices, int32_t begin,
+               int32_t end, const int32_t *counts, const float *scale, const float *src,
+               size_t batch, int lane_begin, int lane_end, float *acc) {
+    const float init = agg == Aggregation::kProduct ? 1.0f : 0.0f;
+    std::fill(acc + lane_begin * batch, acc + lane_end * batch, init);
+    auto fold = [&](auto combine) {
+        fold_links(weights, indices, begin, end, counts, src, batch, lane_begin, lane_end, acc,
+                   combine);
+    };
+    switch (agg) {
+        case Aggregation::kSum:
+        case Aggregation::kMean:
+            fold([](float a, float v, bool) { return a + v; });
+            break;
+        case Aggregation::kProduct:
+            fold([](float a, float v, bool) { return a * v; });
+            break;
+        case Aggregation::kMax:
+            fold([](float a, float v, bool first) { return first ? v : std::max(a, v); });
+            break;
+        case Aggregation::kMin:
+            fold([](float a, float v, bool first) { return first ? v : std::min(a, v); });
+            break;
+        case Aggregation::kMaxAbs:
+            fold([](float a, float v, bool first) {
+                return first || std::fabs(v) > std::fabs(a) ? v : a;
+            });
+            break;
+    }
+    if (agg == Aggregation::kMean)
+        for (int l = lane_begin; l < lane_end; l++)
+            for (size_t b = 0; b < batch; b++) acc[l * batch + b] *= scale[l];
+}
+
+}  // namespace
+
+PackedNetworks::PackedNetworks(const std::vector<const DefaultGenome *> &genomes,
+                               const std::vector<int> &input_keys,
+                               const std::vector<int> &output_keys, int batch_size,
+                               bool recurrent)
+    : batch_size_(batch_size),
+      num_inputs_(static_cast<int>(input_keys.size())),
+      num_outputs_(static_cast<int>(output_keys.size())),
+      recurrent_(recurrent) {
+    if (batch_size_ < 1) throw std::invalid_argument("batch_size must be positive");
+
+    const size_t n = genomes.size();
+    std::vector<std::vector<NodeEval>> evals(n);
+    std::vector<size_t> links(n, 0);
+    for (size_t g = 0; g < n; g++) {
+        evals[g] = recurrent_ ? recurrent_evals(*genomes[g], input_keys, output_keys)
+                              : feed_forward_evals(*genomes[g], input_keys, output_keys);
+        for (const NodeEval &eval : evals[g]) links[g] += eval.links.size();
+    }
+
+    // Size classes: genomes of similar size share a group, which keeps the
+    // padding small.
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return std::make_pair(evals[a].size(), links[a]) <
+               std::make_pair(evals[b].size(), links[b]);
+    });
+
+    const size_t stride = static_cast<size_t>(batch_size_) * kLanes;
+    const int32_t zero_slot = num_inputs_;
+    const int32_t one_slot = num_inputs_ + 1;
+    const int32_t first_row_slot = num_inputs_ + 2;
+    lane_state_.resize(n);
+    output_state_.resize(n * num_outputs_);
+    indptr_.push_back(0);
+    size_t state_size = 0;
+    for (size_t first = 0; first < n; first += kLanes) {
+        const int lanes = static_cast<int>(std::min<size_t>(kLanes, n - first));
+        size_t rows = 0;
+        for (int l = 0; l < lanes; l++) rows = std::max(rows, evals[order[first + l]].size());
+
+        // Slots of each lane. Nodes that are never evaluated get a slot after
+        // the rows, which stays at zero.
+        std::vector<std::unordered_map<int, int32_t>> slots(lanes);
+        int32_t num_slots = first_row_slot + static_cast<int32_t>(rows);
+        for (int l = 0; l < lanes; l++) {
+            const size_t g = order[first + l];
+            std::unordered_map<int, int32_t> &slot = slots[l];
+            for (int i = 0; i < num_inputs_; i++) slot[input_keys[i]] = i;
+            for (size_t r = 0; r < evals[g].size(); r++)
+                slot[evals[g][r].key] = first_row_slot + static_cast<int32_t>(r);
+            int32_t next_slot = first_row_slot + static_cast<int32_t>(rows);
+            auto slot_of = [&](int key) {
+                auto [it, added] = slot.emplace(key, next_slot);
+                if (added) next_slot++;
+                return it->second;
+            };
+            for (const NodeEval &eval : evals[g])
+                for (const auto &link : eval.links) slot_of(link.first);
+            lane_state_[g] = state_size + l * batch_size_;
+            for (int o = 0; o < num_outputs_; o++)
+                output_state_[g * num_outputs_ + o] =
+                    state_size + slot_of(output_keys[o]) * stride + l * batch_size_;
+            num_slots = std::max(num_slots, next_slot);
+            num_nodes_ += num_inputs_ + evals[g].size() + (next_slot - first_row_slot - rows);
+            num_links_ += links[g];
+        }
+
+        Group group{state_size, static_cast<int32_t>(row_slot_.size()), 0};
+        for (size_t r = 0; r < rows; r++) {
+            const NodeEval *eval[kLanes] = {};
+            size_t row_links = 0;
+            for (int l = 0; l < lanes; l++) {
+                const std::vector<NodeEval> &lane_evals = evals[order[first + l]];
+                if (r >= lane_evals.size()) continue;
+                eval[l] = &lane_evals[r];
+                row_links = std::max(row_links, eval[l]->links.size());
+            }
+
+            const size_t base = aggregation_.size();
+            int shape = -1;
+            for (int l = 0; l < kLanes; l++) {
+                float bias = 0.0f;
+                float response = 0.0f;
+                Aggregation aggregation = Aggregation::kSum;
+                Activation activation = Activation::kIdentity;
+                if (eval[l]) {
+                    const DefaultGenome &genome = *genomes[order[first + l]];
+                    std::ptrdiff_t row = genome.nodes.find(eval[l]->key);
+                    if (row < 0)
+                        throw std::out_of_range("node " + std::to_string(eval[l]->key) +
+                                                " not in genome");
+                    bias = genome.nodes.bias[row];
+                    response = genome.nodes.response[row];
+                    aggregation = aggregation_from_name(genome.nodes.aggregation[row]);
+                    activation = activation_from_name(genome.nodes.activation[row]);
+                    if (shape < 0) shape = l;
+                }
+                bias_.push_back(bias);
+                response_.push_back(response);
+                aggregation_.push_back(aggregation);
+                activation_.push_back(activation);
+                const size_t real_links = eval[l] ? eval[l]->links.size() : 0;
+                links_.push_back(static_cast<int32_t>(real_links));
+                scale_.push_back(real_links > 0 ? 1.0f / static_cast<float>(real_links) : 1.0f);
+            }
+            // Lanes without a row r take the aggregation and activation of one
+            // that has it, so that they do not break uniform rows.
+            for (int l = 0; l < kLanes; l++) {
+                if (eval[l]) continue;
+                aggregation_[base + l] = aggregation_[base + shape];
+                activation_[base + l] = activation_[base + shape];
+            }
+            bool uniform = true;
+            for (int l = 1; l < kLanes; l++)
+                uniform = uniform && aggregation_[base + l] == aggregation_[base] &&
+                          activation_[base + l] == activation_[base];
+            row_uniform_.push_back(uniform);
+            row_slot_.push_back(first_row_slot + static_cast<int32_t>(r));
+
+            // Padding links: zero for sums, one for products, and a repeat of
+            // the last link for max, min and maxabs.
+            for (size_t k = 0; k < row_links; k++) {
+                for (int l = 0; l < kLanes; l++) {
+                    int32_t source = zero_slot;
+                    float weight = 0.0f;
+                    const size_t real_links = eval[l] ? eval[l]->links.size() : 0;
+                    const Aggregation aggregation = aggregation_[base + l];
+                    const bool repeat = aggregation == Aggregation::kMax ||
+                                        aggregation == Aggregation::kMin ||
+                                        aggregation == Aggregation::kMaxAbs;
+                    if (k < real_links || (repeat && real_links > 0)) {
+                        const auto &[key, w] = eval[l]->links[std::min(k, real_links - 1)];
+                        source = slots[l].at(key);
+                        weight = w;
+                    }
+                    else if (aggregation == Aggregation::kProduct) {
+                        source = one_slot;
+                        weight = 1.0f;
+                    }
+                    indices_.push_back(static_cast<int32_t>(source * stride + l * batch_size_));
+                    weights_.push_back(weight);
+                }
+            }
+            indptr_.push_back(static_cast<int32_t>(indices_.size() / kLanes));
+        }
+        group.row_end = static_cast<int32_t>(row_slot_.size());
+        groups_.push_back(group);
+        state_size += num_slots * stride;
+    }
+
+    state_[0].assign(state_size, 0.0f);
+    if (recurrent_) state_[1].assign(state_size, 0.0f);
+    set_constants();
+    scratch_.resize(stride);
+}
+
+void PackedNetworks::set_constants() {
+    const size_t stride = static_cast<size_t>(batch_size_) * kLanes;
+    for (const Group &group : groups_) {
+        for (std::vector<float> &state : state_) {
+            if (state.empty()) continue;
+            float *one = state.data() + group.state + (num_inputs_ + 1) * stride;
+            std::fill(one, one + stride, 1.0f);
+        }
+    }
+}
+
+void PackedNetworks::reset() {
+    std::fill(state_[0].begin(), state_[0].end(), 0.0f);
+    std::fill(state_[1].begin(), state_[1].end(), 0.0f);
+    set_constants();
+    active_ = 0;
+}
+
+void PackedNetworks::activate(const float *inputs, float *outputs) {
+    const size_t batch = batch_size_;
+    const size_t stride = batch * kLanes;
+    float *read = state_[active_].data();
+    float *write = recurrent_ ? state_[1 - active_].data() : read;
+
+    for (int g = 0; g < num_genomes(); g++) {
+        const float *in = inputs + static_cast<size_t>(g) * batch * num_inputs_;
+        for (int i = 0; i < num_inputs_; i++) {
+            const size_t slot = lane_state_[g] + i * stride;
+            for (size_t b = 0; b < batch; b++) {
+                read[slot + b] = in[b * num_inputs_ + i];
+                write[slot + b] = in[b * num_inputs_ + i];
+            }
+        }
+    }
+
+    float *acc = scratch_.data();
+    for (const Group &group : groups_) {
+        const float *src = read + group.state;
+        for (int32_t r = group.row_begin; r < group.row_end; r++) {
+            const size_t lanes = static_cast<size_t>(r) * kLanes;
+            const bool uniform = row_uniform_[r];
+            if (uniform) {
+                aggregate(aggregation_[lanes], weights_.data(), indices_.data(), indptr_[r],
+                          indptr_[r + 1], &links_[lanes], &scale_[lanes], src, batch, 0, kLanes,
+                          acc);
+            }
+            else {
+                for (int l = 0; l < kLanes; l++)
+                    aggregate(aggregation_[lanes + l], weights_.data(), indices_.data(),
+                              indptr_[r], indptr_[r + 1], &links_[lanes], &scale_[lanes], src,
+                              batch, l, l + 1, acc);
+            }
+
+            float *dst = write + group.state + row_slot_[r] * stride;
+            const float *bias = &bias_[lanes];
+            const float *response = &response_[lanes];
+            for (int l = 0; l < kLanes; l++)
+                for (size_t b = 0; b < batch; b++)
+                    dst[l * batch + b] = bias[l] + response[l] * acc[l * batch + b];
+            if (uniform) {
+                apply_activation(activation_[lanes], dst, stride);
+            }
+            else {
+                for (int l = 0; l < kLanes; l++)
+                    apply_activation(activation_[lanes + l], dst + l * batch, batch);
+            }
+        }
+    }
+
+    for (int g = 0; g < num_genomes(); g++) {
+        float *out = outputs + static_cast<size_t>(g) * batch * num_outputs_;
+        for (int o = 0; o < num_outputs_; o++) {
+            const float *src = write + output_state_[g * num_outputs_ + o];
+            for (size_t b = 0; b < batch; b++) out[b * num_outputs_ + o] = src[b];
+        }
+    }
+    if (recurrent_) active_ = 1 - active_;
+}
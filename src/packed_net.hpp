@@ -0,0 +1,103 @@
+#ifndef PACKED_NET_HPP
+#define PACKED_NET_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "activations.hpp"
+#include "aggregations.hpp"
+#include "genome.hpp"
+
+// ---------------------------------------------------------------------------
+// PackedNetworks: the phenotypes of many genomes advanced together, one call
+// per step.
+//
+// Genomes are sorted by size and packed kLanes at a time into groups, one SIMD
+// lane per genome. Row r of a group evaluates the r-th node of every genome in
+// it, and link k of a row the k-th incoming link of each of those nodes; lanes
+// with fewer rows or links are padded with links that leave the aggregate
+// unchanged. State is stored state[group][slot][lane][b]: at batch_size 1 (the
+// common case) each link is one gather and multiply-add across the lanes; with
+// larger batches each lane loops over its own links without the padding, each
+// a contiguous loop over the batch. Either way every activation is a
+// contiguous loop over a whole row.
+//
+// The slots of a group are its inputs, then one slot fixed at zero and one
+// fixed at one (the sources of padding links), then one slot per row, then the
+// nodes that are never evaluated (e.g. an unconnected output) and stay zero.
+//
+// Feed-forward mode follows FeedForwardNetwork (nodes in feed_forward_layers
+// order, reading current values). Recurrent mode follows RecurrentNetwork: every
+// node with inputs reads the previous step's values from a second buffer.
+// ---------------------------------------------------------------------------
+class PackedNetworks {
+   public:
+    static constexpr int kLanes = 8;
+
+    PackedNetworks(const std::vector<const DefaultGenome *> &genomes,
+                   const std::vector<int> &input_keys, const std::vector<int> &output_keys,
+                   int batch_size, bool recurrent);
+
+    int num_genomes() const { return static_cast<int>(lane_state_.size()); }
+    int batch_size() const { return batch_size_; }
+    int num_inputs() const { return num_inputs_; }
+    int num_outputs() const { return num_outputs_; }
+    bool recurrent() const { return recurrent_; }
+    // Node slots and links of the genomes themselves, without padding.
+    size_t num_nodes() const { return num_nodes_; }
+    size_t num_links() const { return num_links_; }
+
+    // Advances every network by one step.
+    // inputs: [genome][batch][input], outputs: [genome][batch][output].
+    void activate(const float *inputs, float *outputs);
+
+    // Clears all node values (only matters in recurrent mode).
+    void reset();
+
+   private:
+    struct Group {
+        size_t state;  // offset of the group's first slot
+        int32_t row_begin;
+        int32_t row_end;
+    };
+
+    // Sets the slot fixed at one in every group.
+    void set_constants();
+
+    int batch_size_;
+    int num_inputs_;
+    int num_outputs_;
+    bool recurrent_;
+    size_t num_nodes_ = 0;
+    size_t num_links_ = 0;
+
+    std::vector<Group> groups_;
+    // lane_state_[g] is the offset of slot 0, batch 0 of genome g; a slot of a
+    // group spans kLanes * batch_size_ values.
+    std::vector<size_t> lane_state_;
+    // output_state_[g * num_outputs_ + o] is the offset of output o of genome g.
+    std::vector<size_t> output_state_;
+
+    // Per row: the slot it writes and whether all its lanes share aggregation
+    // and activation. Per-lane values are stored [row][lane].
+    std::vector<int32_t> row_slot_;
+    std::vector<uint8_t> row_uniform_;
+    std::vector<float> bias_;
+    std::vector<float> response_;
+    std::vector<int32_t> links_;  // links before padding
+    std::vector<float> scale_;    // 1 / links for mean aggregation
+    std::vector<Activation> activation_;
+    std::vector<Aggregation> aggregation_;
+    // Links of row r are [indptr_[r], indptr_[r + 1]), each stored [link][lane]
+    // as the offset of its source within the group, (slot * kLanes + lane) *
+    // batch_size_.
+    std::vector<int32_t> indptr_;
+    std::vector<int32_t> indices_;
+    std::vector<float> weights_;
+
+    std::vector<float> state_[2];
+    std::vector<float> scratch_;
+    int active_ = 0;
+};
+
+#endif  // PACKED_NET_HPP
@@ -0,0 +1,76 @@
+#include "population.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+Population::Population(const DefaultGenomeConfig &genome_config, const PopulationParams &params)
+    : genome_config(genome_config),
+      params(params),
+      reproduction(params.reproduction, params.stagnation),
+      species(params.species_set) {
+    const std::string &criterion = params.fitness_criterion;
+    if (criterion != "max" && criterion != "min" && criterion != "mean" &&
+        !params.no_fitness_termination)
+        throw std::invalid_argument("Unexpected fitness_criterion: " + criterion);
+
+    // Create a population from scratch, then partition it into species.
+    population = reproduction.create_new(this->genome_config, params.pop_size);
+    species.speciate(this->genome_config, population, generation);
+}
+
+double Population::fitness_criterion(const std::vector<double> &fitnesses) const {
+    if (params.fitness_criterion == "min")
+        return *std::min_element(fitnesses.begin(), fitnesses.end());
+    if (params.fitness_criterion == "mean")
+        return std::accumulate(fitnesses.begin(), fitnesses.end(), 0.0) /
+               static_cast<double>(fitnesses.size());
+    return *std::max_element(fitnesses.begin(), fitnesses.end());
+}
+
+GenomePtr Population::run(const FitnessFunction &fitness_function, std::optional<int> n) {
+    if (params.no_fitness_termination && !n.has_value())
+        throw std::invalid_argument("Cannot have no generational limit with no fitness termination");
+
+    for (int k = 0; !n.has_value() || k < *n; k++) {
+        // Evaluate all genomes using the user-provided function.
+        std::vector<DefaultGenome *> genomes;
+        genomes.reserve(population.size());
+        for (auto &[key, genome] : population) genomes.push_back(genome.get());
+        fitness_function(genomes);
+
+        GenomePtr best;
+        std::vector<double> fitnesses;
+        fitnesses.reserve(population.size());
+        for (auto &[key, genome] : population) {
+            if (!genome->fitness.has_value())
+                throw std::runtime_error("Fitness not assigned to genome " + std::to_string(key));
+            fitnesses.push_back(*genome->fitness);
+            if (!best || *genome->fitness > *best->fitness) best = genome;
+        }
+
+        // Track the best genome ever seen.
+        if (!best_genome || *best->fitness > *best_genome->fitness) best_genome = best;
+
+        // End if the fitness threshold is reached.
+        if (!params.no_fitness_termination &&
+            fitness_criterion(fitnesses) >= params.fitness_threshold)
+            break;
+
+        // Create the next generation from the current generation.
+        population = reproduction.reproduce(genome_config, species, params.pop_size, generation);
+
+        // Check for complete extinction.
+        if (species.species.empty()) {
+            if (!params.reset_on_extinction) throw CompleteExtinctionException();
+            population = reproduction.create_new(genome_config, params.pop_size);
+        }
+
+        // Divide the new population into species.
+        species.speciate(genome_config, population, generation);
+
+        if (on_generation) on_generation(*this);
+
+        generation++;
+    }
+    return best_genome;
+}
@@ -0,0 +1,68 @@
+#ifndef POPULATION_HPP
+#define POPULATION_HPP
+
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "genome.hpp"
+#include "reproduction.hpp"
+#include "species.hpp"
+
+class CompleteExtinctionException : public std::runtime_error {
+   public:
+    CompleteExtinctionException() : std::runtime_error("complete extinction") {}
+};
+
+// The [NEAT], [DefaultSpeciesSet], [DefaultStagnation] and
+// [DefaultReproduction] sections of a config file.
+struct PopulationParams {
+    int pop_size = 150;
+    std::string fitness_criterion = "max";
+    double fitness_threshold = 0.0;
+    bool reset_on_extinction = false;
+    bool no_fitness_termination = false;
+    SpeciesSetParams species_set;
+    StagnationParams stagnation;
+    ReproductionParams reproduction;
+};
+
+// Assigns `fitness` to every genome of the generation. Evaluations may run in
+// parallel, but must not modify the genomes otherwise.
+using FitnessFunction = std::function<void(const std::vector<DefaultGenome *> &genomes)>;
+
+// ---------------------------------------------------------------------------
+// Population: the evolution loop of neat3p.Population, without Python.
+//   1. Evaluate the fitness of all genomes.
+//   2. Stop if the termination criterion is satisfied.
+//   3. Generate the next generation from the current one.
+//   4. Partition the new generation into species.
+//   5. Go to 1.
+// ---------------------------------------------------------------------------
+class Population {
+   public:
+    Population(const DefaultGenomeConfig &genome_config, const PopulationParams &params);
+
+    // Runs at most n generations (until a solution is found if n is empty)
+    // and returns the best genome seen. Throws CompleteExtinctionException if
+    // every species stagnates and reset_on_extinction is off.
+    GenomePtr run(const FitnessFunction &fitness_function, std::optional<int> n = std::nullopt);
+
+    // Called at the end of each generation, after speciation.
+    std::function<void(const Population &)> on_generation;
+
+    DefaultGenomeConfig genome_config;
+    PopulationParams params;
+    DefaultReproduction reproduction;
+    DefaultSpeciesSet species;
+    GenomeMap population;
+    int generation = 0;
+    GenomePtr best_genome;
+
+   private:
+    double fitness_criterion(const std::vector<double> &fitnesses) const;
+};
+
+#endif  // POPULATION_HPP
@@ -0,0 +1,119 @@
+#include "quantized.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+uint32_t float_bits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+float bits_float(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+// Round-to-nearest-even float -> half. Values beyond the half range saturate
+// to the largest finite half and subnormal results flush to zero; substrate
+// weights are clamped well inside that range.
+uint16_t float_to_half(float f) {
+    const uint32_t u = float_bits(f);
+    const uint16_t sign = static_cast<uint16_t>((u >> 16) & 0x8000u);
+    const uint32_t magnitude = u & 0x7fffffffu;
+    if (magnitude < 0x38800000u) return sign;                     // below 2^-14
+    if (magnitude >= 0x477ff000u) return sign | uint16_t(0x7bffu);  // rounds past 65504
+    const uint32_t rebiased = magnitude - 0x38000000u;              // exponent 127 -> 15
+    const uint32_t rounded = rebiased + 0x0fffu + ((rebiased >> 13) & 1u);
+    return sign | static_cast<uint16_t>(rounded >> 13);
+}
+
+// Inverse of float_to_half for the values it produces. Branch-free so that
+// the decode loop vectorizes.
+float half_to_float(uint16_t h) {
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    const uint32_t magnitude = h & 0x7fffu;
+    const uint32_t value = magnitude == 0 ? 0u : (magnitude << 13) + 0x38000000u;
+    return bits_float(sign | value);
+}
+
+}  // namespace
+
+Precision precision_from_name(const std::string &name) {
+    if (name == "int8") return Precision::kInt8;
+    if (name == "fp16" || name == "float16") return Precision::kFloat16;
+    throw std::invalid_argument("Unknown precision " + name + " (expected int8 or fp16)");
+}
+
+QuantizedLayer::QuantizedLayer(const float *weights, const float *bias, size_t rows, size_t cols,
+                               Precision precision, Activation activation)
+    : rows_(rows),
+      cols_(cols),
+      precision_(precision),
+      activation_(activation),
+      bias_(bias, bias + rows) {
+    const size_t n = rows * cols;
+    if (precision_ == Precision::kInt8) {
+        int8_.resize(n);
+        scale_.resize(rows);
+        for (size_t r = 0; r < rows; r++) {
+            const float *row = weights + r * cols;
+            float max_abs = 0.0f;
+            for (size_t c = 0; c < cols; c++) max_abs = std::max(max_abs, std::fabs(row[c]));
+            const float scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+            const float inverse = 1.0f / scale;
+            for (size_t c = 0; c < cols; c++)
+                int8_[r * cols + c] =
+                    static_cast<int8_t>(std::clamp(std::nearbyint(row[c] * inverse), -127.0f, 127.0f));
+            scale_[r] = scale;
+        }
+    }
+    else {
+        half_.resize(n);
+        for (size_t i = 0; i < n; i++) half_[i] = float_to_half(weights[i]);
+    }
+}
+
+size_t QuantizedLayer::weight_bytes() const {
+    return int8_.size() * sizeof(int8_t) + half_.size() * sizeof(uint16_t) +
+           scale_.size() * sizeof(float);
+}
+
+void QuantizedLayer::decode_row(size_t r, float *out) const {
+    if (precision_ == Precision::kInt8) {
+        const int8_t *q = int8_.data() + r * cols_;
+        const float scale = scale_[r];
+        for (size_t c = 0; c < cols_; c++) out[c] = scale * static_cast<float>(q[c]);
+    }
+    else {
+        const uint16_t *h = half_.data() + r * cols_;
+        for (size_t c = 0; c < cols_; c++) out[c] = half_to_float(h[c]);
+    }
+}
+
+std::vector<float> QuantizedLayer::dequantized() const {
+    std::vector<float> out(rows_ * cols_);
+    for (size_t r = 0; r < rows_; r++) decode_row(r, out.data() + r * cols_);
+    return out;
+}
+
+void QuantizedLayer::forward(const float *inputs, size_t batch, float *outputs) const {
+    std::vector<float> row(cols_);
+    std::vector<float> column(batch);
+    for (size_t r = 0; r < rows_; r++) {
+        decode_row(r, row.data());
+        for (size_t b = 0; b < batch; b++) {
+            const float *x = inputs + b * cols_;
+            float acc = 0.0f;
+            for (size_t c = 0; c < cols_; c++) acc += row[c] * x[c];
+            column[b] = bias_[r] + acc;
+        }
+        apply_activation(activation_, column.data(), batch);
+        for (size_t b = 0; b < batch; b++) outputs[b * rows_ + r] = column[b];
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef QUANTIZED_HPP
+#define QUANTIZED_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "activations.hpp"
+
+enum class Precision : uint8_t {
+    kInt8,     // symmetric, one float scale per row
+    kFloat16,  // IEEE half
+};
+
+// Throws std::invalid_argument for anything but "int8" / "fp16".
+Precision precision_from_name(const std::string &name);
+
+// ---------------------------------------------------------------------------
+// QuantizedLayer: y = activation(W x + bias) with the dense weight matrix W
+// held in reduced precision, for the large fixed substrate matrices painted by
+// HyperNEAT CPPNs, whose evaluation is bound by memory bandwidth.
+//
+// Int8 weights take a quarter and fp16 weights half the space of float32. Each
+// weight row is decoded once per call into a float buffer and dotted with
+// every input of the batch, so the decode cost is amortized over the batch and
+// the dot products are plain float loops the compiler vectorizes.
+// ---------------------------------------------------------------------------
+class QuantizedLayer {
+   public:
+    // weights: [rows][cols], bias: [rows].
+    QuantizedLayer(const float *weights, const float *bias, size_t rows, size_t cols,
+                   Precision precision, Activation activation);
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    Precision precision() const { return precision_; }
+    // Bytes held by the quantized weights and row scales.
+    size_t weight_bytes() const;
+
+    // The weight matrix as decoded by forward(), [rows][cols].
+    std::vector<float> dequantized() const;
+
+    // inputs: [batch][cols], outputs: [batch][rows].
+    void forward(const float *inputs, size_t batch, float *outputs) const;
+
+   private:
+    void decode_row(size_t r, float *out) const;
+
+    size_t rows_;
+    size_t cols_;
+    Precision precision_;
+    Activation activation_;
+    std::vector<int8_t> int8_;
+    std::vector<uint16_t> half_;
+    std::vector<float> scale_;
+    std::vector<float> bias_;
+};
+
+#endif  // QUANTIZED_HPP
@@ -0,0 +1,224 @@
+#include "reproduction.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+double mean(std::vector<double> values) {
+    return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+double median2(std::vector<double> values) {
+    const size_t n = values.size();
+    if (n <= 2) return mean(std::move(values));
+    std::sort(values.begin(), values.end());
+    if (n % 2 == 1) return values[n / 2];
+    return (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+double min_value(std::vector<double> values) {
+    return *std::min_element(values.begin(), values.end());
+}
+
+double max_value(std::vector<double> values) {
+    return *std::max_element(values.begin(), values.end());
+}
+
+// Python's round(): halves go to the nearest even integer.
+int round_half_even(double value) { return static_cast<int>(std::nearbyint(value)); }
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// DefaultStagnation
+// ---------------------------------------------------------------------------
+DefaultStagnation::DefaultStagnation(const StagnationParams &params) : params(params) {
+    const std::string &name = params.species_fitness_func;
+    if (name == "mean")
+        species_fitness_func_ = mean;
+    else if (name == "max")
+        species_fitness_func_ = max_value;
+    else if (name == "min")
+        species_fitness_func_ = min_value;
+    else if (name == "median")
+        species_fitness_func_ = median;
+    else if (name == "median2")
+        species_fitness_func_ = median2;
+    else
+        throw std::invalid_argument("Unexpected species fitness func: " + name);
+}
+
+std::vector<std::pair<int, bool>> DefaultStagnation::update(DefaultSpeciesSet &species_set,
+                                                            int generation) const {
+    std::vector<Species *> species_data;
+    for (auto &[sid, s] : species_set.species) {
+        const double prev_fitness =
+            s.fitness_history.empty()
+                ? -std::numeric_limits<double>::max()
+                : *std::max_element(s.fitness_history.begin(), s.fitness_history.end());
+        s.fitness = species_fitness_func_(s.get_fitnesses());
+        s.fitness_history.push_back(*s.fitness);
+        s.adjusted_fitness.reset();
+        if (*s.fitness > prev_fitness) s.last_improved = generation;
+        species_data.push_back(&s);
+    }
+
+    // Ascending fitness order, so that less fit species are marked stagnant first.
+    std::stable_sort(species_data.begin(), species_data.end(),
+                     [](const Species *a, const Species *b) { return *a->fitness < *b->fitness; });
+
+    std::vector<std::pair<int, bool>> result;
+    size_t num_non_stagnant = species_data.size();
+    for (size_t idx = 0; idx < species_data.size(); idx++) {
+        const Species &s = *species_data[idx];
+        // Never let the number of species drop below species_elitism.
+        const int stagnant_time = generation - s.last_improved;
+        bool is_stagnant = false;
+        if (num_non_stagnant > static_cast<size_t>(params.species_elitism))
+            is_stagnant = stagnant_time >= params.max_stagnation;
+        if (species_data.size() - idx <= static_cast<size_t>(params.species_elitism))
+            is_stagnant = false;
+        if (is_stagnant) num_non_stagnant--;
+        result.emplace_back(s.key, is_stagnant);
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// DefaultReproduction
+// ---------------------------------------------------------------------------
+GenomeMap DefaultReproduction::create_new(DefaultGenomeConfig &config, int num_genomes) {
+    GenomeMap genomes;
+    for (int i = 0; i < num_genomes; i++) {
+        const int key = next_genome_key_++;
+        auto genome = std::make_shared<DefaultGenome>(key);
+        genome->configure_new(config);
+        genomes.emplace(key, std::move(genome));
+    }
+    return genomes;
+}
+
+std::vector<int> DefaultReproduction::compute_spawn(const std::vector<double> &adjusted_fitness,
+                                                    const std::vector<int> &previous_sizes,
+                                                    int pop_size, int min_species_size) {
+    const double af_sum = std::accumulate(adjusted_fitness.begin(), adjusted_fitness.end(), 0.0);
+
+    std::vector<int> spawn_amounts;
+    for (size_t i = 0; i < adjusted_fitness.size(); i++) {
+        const double s =
+            af_sum > 0 ? std::max<double>(min_species_size, adjusted_fitness[i] / af_sum * pop_size)
+                       : min_species_size;
+        const double d = (s - previous_sizes[i]) * 0.5;
+        const int c = round_half_even(d);
+        int spawn = previous_sizes[i];
+        if (c != 0)
+            spawn += c;
+        else if (d > 0)
+            spawn += 1;
+        else if (d < 0)
+            spawn -= 1;
+        spawn_amounts.push_back(spawn);
+    }
+
+    // Normalize the spawn amounts so that the next generation is roughly the
+    // population size requested by the user.
+    const int total_spawn = std::accumulate(spawn_amounts.begin(), spawn_amounts.end(), 0);
+    const double norm = static_cast<double>(pop_size) / total_spawn;
+    for (int &n : spawn_amounts) n = std::max(min_species_size, round_half_even(n * norm));
+    return spawn_amounts;
+}
+
+GenomeMap DefaultReproduction::reproduce(DefaultGenomeConfig &config,
+                                         DefaultSpeciesSet &species_set, int pop_size,
+                                         int generation) {
+    // Filter out stagnant species and collect the fitnesses of the rest.
+    std::vector<double> all_fitnesses;
+    std::vector<Species *> remaining_species;
+    for (const auto &[sid, stagnant] : stagnation.update(species_set, generation)) {
+        if (stagnant) continue;
+        Species &s = species_set.species.at(sid);
+        for (double f : s.get_fitnesses()) all_fitnesses.push_back(f);
+        remaining_species.push_back(&s);
+    }
+
+    if (remaining_species.empty()) {
+        species_set.species.clear();
+        return {};
+    }
+
+    // Adjusted fitness: mean member fitness normalized to the population's
+    // fitness range, which allows negative fitness values.
+    const double min_fitness = *std::min_element(all_fitnesses.begin(), all_fitnesses.end());
+    const double max_fitness = *std::max_element(all_fitnesses.begin(), all_fitnesses.end());
+    const double fitness_range = std::max(1.0, max_fitness - min_fitness);
+    std::vector<double> adjusted_fitnesses;
+    std::vector<int> previous_sizes;
+    for (Species *s : remaining_species) {
+        s->adjusted_fitness = (mean(s->get_fitnesses()) - min_fitness) / fitness_range;
+        adjusted_fitnesses.push_back(*s->adjusted_fitness);
+        previous_sizes.push_back(static_cast<int>(s->members.size()));
+    }
+
+    const int min_species_size = std::max(params.min_species_size, params.elitism);
+    const std::vector<int> spawn_amounts =
+        compute_spawn(adjusted_fitnesses, previous_sizes, pop_size, min_species_size);
+
+    std::mt19937 &gen = neat3p::random_engine();
+    GenomeMap new_population;
+    std::map<int, Species> kept;
+    for (size_t i = 0; i < remaining_species.size(); i++) {
+        Species &s = *remaining_species[i];
+        // Each species always at least gets to retain its elites.
+        int spawn = std::max(spawn_amounts[i], params.elitism);
+
+        // Members in order of descending fitness.
+        std::vector<GenomePtr> old_members;
+        for (auto &[gid, genome] : s.members) old_members.push_back(genome);
+        std::stable_sort(old_members.begin(), old_members.end(),
+                         [](const GenomePtr &a, const GenomePtr &b) {
+                             return a->fitness.value_or(0.0) > b->fitness.value_or(0.0);
+                         });
+        s.members.clear();
+
+        // Transfer elites to the new generation.
+        for (int e = 0; e < params.elitism && e < static_cast<int>(old_members.size()); e++) {
+            new_population.emplace(old_members[e]->key, old_members[e]);
+            spawn--;
+        }
+
+        if (spawn > 0) {
+            // Only the survival_threshold fraction, and at least two, become parents.
+            size_t repro_cutoff = static_cast<size_t>(
+                std::ceil(params.survival_threshold * static_cast<double>(old_members.size())));
+            repro_cutoff = std::min(std::max<size_t>(repro_cutoff, 2), old_members.size());
+            std::uniform_int_distribution<size_t> pick(0, repro_cutoff - 1);
+
+            for (; spawn > 0; spawn--) {
+                const DefaultGenome &parent1 = *old_members[pick(gen)];
+                const DefaultGenome &parent2 = *old_members[pick(gen)];
+
+                // If the parents are not distinct, crossover produces a
+                // genetically identical clone of the parent with a new key.
+                const int gid = next_genome_key_++;
+                auto child = std::make_shared<DefaultGenome>(gid);
+                child->configure_crossover(parent1, parent2);
+                child->mutate(config);
+                species_set.record_birth(*child, parent1, parent2);
+                new_population.emplace(gid, std::move(child));
+            }
+        }
+        kept.emplace(s.key, std::move(s));
+    }
+    species_set.species = std::move(kept);
+    return new_population;
+}
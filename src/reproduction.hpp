@@ -0,0 +1,70 @@
+#ifndef REPRODUCTION_HPP
+#define REPRODUCTION_HPP
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "genome.hpp"
+#include "species.hpp"
+
+struct StagnationParams {
+    std::string species_fitness_func = "mean";
+    int max_stagnation = 15;
+    int species_elitism = 0;
+};
+
+// ---------------------------------------------------------------------------
+// DefaultStagnation: keeps track of whether species are making progress, as
+// neat3p.DefaultStagnation does.
+// ---------------------------------------------------------------------------
+class DefaultStagnation {
+   public:
+    explicit DefaultStagnation(const StagnationParams &params);
+
+    // Updates the fitness history of every species and returns
+    // (species key, is stagnant) in ascending species fitness order. The
+    // species_elitism best species are never marked stagnant.
+    std::vector<std::pair<int, bool>> update(DefaultSpeciesSet &species_set, int generation) const;
+
+    StagnationParams params;
+
+   private:
+    double (*species_fitness_func_)(std::vector<double>);
+};
+
+struct ReproductionParams {
+    int elitism = 0;
+    double survival_threshold = 0.2;
+    int min_species_size = 1;
+};
+
+// ---------------------------------------------------------------------------
+// DefaultReproduction: explicit fitness sharing with fixed-time species
+// stagnation, as neat3p.DefaultReproduction does.
+// ---------------------------------------------------------------------------
+class DefaultReproduction {
+   public:
+    DefaultReproduction(const ReproductionParams &params, const StagnationParams &stagnation)
+        : params(params), stagnation(stagnation) {}
+
+    GenomeMap create_new(DefaultGenomeConfig &config, int num_genomes);
+
+    // Number of offspring per species, proportional to adjusted fitness.
+    static std::vector<int> compute_spawn(const std::vector<double> &adjusted_fitness,
+                                          const std::vector<int> &previous_sizes, int pop_size,
+                                          int min_species_size);
+
+    // The next generation. Drops stagnant species from `species_set`; returns
+    // an empty population if none remain.
+    GenomeMap reproduce(DefaultGenomeConfig &config, DefaultSpeciesSet &species_set, int pop_size,
+                        int generation);
+
+    ReproductionParams params;
+    DefaultStagnation stagnation;
+
+   private:
+    int next_genome_key_ = 1;
+};
+
+#endif  // REPRODUCTION_HPP
@@ -0,0 +1,108 @@
+#include "sparse_layer.hpp"
+
+#include <algorithm>
+#include <limits>
+
+SparseLayer::SparseLayer(const float *weights, const float *bias, size_t rows, size_t cols,
+                         Activation activation, double max_density)
+    : rows_(rows), cols_(cols), activation_(activation), bias_(bias, bias + rows) {
+    const size_t n = rows * cols;
+    nnz_ = static_cast<size_t>(
+        std::count_if(weights, weights + n, [](float w) { return w != 0.0f; }));
+
+    // CSR indices are 32-bit; layers beyond that stay dense.
+    const bool indexable = nnz_ <= std::numeric_limits<uint32_t>::max() &&
+                           cols <= std::numeric_limits<uint32_t>::max();
+    format_ = indexable && density() <= max_density ? WeightFormat::kCsr : WeightFormat::kDense;
+    if (format_ == WeightFormat::kDense) {
+        dense_.assign(weights, weights + n);
+        return;
+    }
+    row_offsets_.reserve(rows + 1);
+    col_indices_.reserve(nnz_);
+    values_.reserve(nnz_);
+    row_offsets_.push_back(0);
+    for (size_t r = 0; r < rows; r++) {
+        const float *row = weights + r * cols;
+        for (size_t c = 0; c < cols; c++) {
+            if (row[c] == 0.0f) continue;
+            col_indices_.push_back(static_cast<uint32_t>(c));
+            values_.push_back(row[c]);
+        }
+        row_offsets_.push_back(static_cast<uint32_t>(values_.size()));
+    }
+}
+
+double SparseLayer::density() const {
+    const size_t n = rows_ * cols_;
+    return n > 0 ? static_cast<double>(nnz_) / static_cast<double>(n) : 0.0;
+}
+
+size_t SparseLayer::weight_bytes() const {
+    return dense_.size() * sizeof(float) + values_.size() * sizeof(float) +
+           (row_offsets_.size() + col_indices_.size()) * sizeof(uint32_t);
+}
+
+std::vector<float> SparseLayer::dense() const {
+    if (format_ == WeightFormat::kDense) return dense_;
+    std::vector<float> out(rows_ * cols_, 0.0f);
+    for (size_t r = 0; r < rows_; r++)
+        for (uint32_t k = row_offsets_[r]; k < row_offsets_[r + 1]; k++)
+            out[r * cols_ + col_indices_[k]] = values_[k];
+    return out;
+}
+
+namespace {
+
+// [batch][cols] -> [cols][batch], so that each weight scales one contiguous run
+// of inputs: the kernels' inner loops run over the batch and vectorize.
+std::vector<float> transpose(const float *inputs, size_t batch, size_t cols) {
+    std::vector<float> transposed(cols * batch);
+    for (size_t b = 0; b < batch; b++)
+        for (size_t c = 0; c < cols; c++) transposed[c * batch + b] = inputs[b * cols + c];
+    return transposed;
+}
+
+// Like QuantizedLayer's decode-and-dot loop, this relies on the -ffast-math
+// build, which lets the compiler reassociate the sum and vectorize it.
+float dot(const float *a, const float *b, size_t n) {
+    float acc = 0.0f;
+    for (size_t i = 0; i < n; i++) acc += a[i] * b[i];
+    return acc;
+}
+
+}  // namespace
+
+void SparseLayer::forward(const float *inputs, size_t batch, float *outputs) const {
+    // CSR reads the inputs as [cols][batch], which for one input is the same.
+    std::vector<float> transposed;
+    const float *columns = inputs;
+    if (format_ == WeightFormat::kCsr && batch > 1) {
+        transposed = transpose(inputs, batch, cols_);
+        columns = transposed.data();
+    }
+
+    std::vector<float> column(batch);
+    for (size_t r = 0; r < rows_; r++) {
+        std::fill(column.begin(), column.end(), bias_[r]);
+        if (format_ == WeightFormat::kDense) {
+            const float *row = dense_.data() + r * cols_;
+            for (size_t b = 0; b < batch; b++) column[b] += dot(row, inputs + b * cols_, cols_);
+        }
+        else if (batch == 1) {
+            float acc = 0.0f;
+            for (uint32_t k = row_offsets_[r]; k < row_offsets_[r + 1]; k++)
+                acc += values_[k] * columns[col_indices_[k]];
+            column[0] += acc;
+        }
+        else {
+            for (uint32_t k = row_offsets_[r]; k < row_offsets_[r + 1]; k++) {
+                const float w = values_[k];
+                const float *x = columns + static_cast<size_t>(col_indices_[k]) * batch;
+                for (size_t b = 0; b < batch; b++) column[b] += w * x[b];
+            }
+        }
+        apply_activation(activation_, column.data(), batch);
+        for (size_t b = 0; b < batch; b++) outputs[b * rows_ + r] = column[b];
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef SPARSE_LAYER_HPP
+#define SPARSE_LAYER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "activations.hpp"
+
+enum class WeightFormat : uint8_t {
+    kDense,  // row-major [rows][cols]
+    kCsr,    // compressed sparse rows: row offsets, column indices, values
+};
+
+// ---------------------------------------------------------------------------
+// SparseLayer: y = activation(W x + bias) for the substrate matrices painted by
+// HyperNEAT CPPNs, whose weight threshold zeroes most entries.
+//
+// The nonzero weights are counted at construction; up to `max_density` they
+// are stored in CSR and the forward pass only visits those, otherwise W stays
+// dense, since a CSR product pays an index load and a gather per weight.
+//
+// The CSR kernel transposes a batch once per call, so that every stored weight
+// scales one contiguous run of inputs and the inner loop over the batch
+// vectorizes; the dense kernel takes row-by-input dot products.
+// ---------------------------------------------------------------------------
+class SparseLayer {
+   public:
+    // Density above which the layer stays dense: where the two kernels break
+    // even on substrate-sized layers (512 x 2048, batches of 1 to 64). It only
+    // decides the layout, not the result.
+    static constexpr double kDefaultMaxDensity = 0.25;
+
+    // weights: [rows][cols], bias: [rows]. Exact zeros are dropped.
+    SparseLayer(const float *weights, const float *bias, size_t rows, size_t cols,
+                Activation activation, double max_density = kDefaultMaxDensity);
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    WeightFormat format() const { return format_; }
+    // Number of nonzero weights, and their fraction of rows * cols.
+    size_t nnz() const { return nnz_; }
+    double density() const;
+    // Bytes held by the weights, including CSR indices.
+    size_t weight_bytes() const;
+
+    // The weight matrix, [rows][cols].
+    std::vector<float> dense() const;
+
+    // inputs: [batch][cols], outputs: [batch][rows].
+    void forward(const float *inputs, size_t batch, float *outputs) const;
+
+   private:
+    size_t rows_;
+    size_t cols_;
+    size_t nnz_ = 0;
+    WeightFormat format_;
+    Activation activation_;
+    std::vector<float> dense_;
+    std::vector<uint32_t> row_offsets_;
+    std::vector<uint32_t> col_indices_;
+    std::vector<float> values_;
+    std::vector<float> bias_;
+};
+
+#endif  // SPARSE_LAYER_HPP
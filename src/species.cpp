@@ -0,0 +1,90 @@
+#include "species.hpp"
+
+#include <limits>
+#include <set>
+#include <utility>
+
+std::vector<double> Species::get_fitnesses() const {
+    std::vector<double> result;
+    result.reserve(members.size());
+    for (const auto &[key, genome] : members) result.push_back(genome->fitness.value_or(0.0));
+    return result;
+}
+
+void DefaultSpeciesSet::speciate(const DefaultGenomeConfig &config, const GenomeMap &population,
+                                 int generation) {
+    const double compatibility_threshold = params.compatibility_threshold;
+
+    // Find the best representatives for each existing species: the genome
+    // closest to the current representative.
+    std::set<int> unspeciated;
+    for (const auto &[key, genome] : population) unspeciated.insert(key);
+    std::map<int, int> new_representatives;
+    std::map<int, std::vector<int>> new_members;
+    for (auto &[sid, s] : species) {
+        if (unspeciated.empty()) break;
+        int new_rid = -1;
+        double best = std::numeric_limits<double>::infinity();
+        for (int gid : unspeciated) {
+            const double d = distance_cache.distance(*s.representative, *population.at(gid), config);
+            if (new_rid < 0 || d < best) {
+                best = d;
+                new_rid = gid;
+            }
+        }
+        new_representatives[sid] = new_rid;
+        new_members[sid] = {new_rid};
+        unspeciated.erase(new_rid);
+    }
+
+    // Partition the population into species based on genetic similarity.
+    while (!unspeciated.empty()) {
+        const int gid = *unspeciated.begin();
+        unspeciated.erase(unspeciated.begin());
+        const DefaultGenome &g = *population.at(gid);
+
+        // Find the species with the most similar representative.
+        int best_sid = -1;
+        double best = std::numeric_limits<double>::infinity();
+        for (const auto &[sid, rid] : new_representatives) {
+            const double d = distance_cache.distance(*population.at(rid), g, config);
+            if (d < compatibility_threshold && d < best) {
+                best = d;
+                best_sid = sid;
+            }
+        }
+
+        if (best_sid >= 0) {
+            new_members[best_sid].push_back(gid);
+        }
+        else {
+            // No species is similar enough: create a new species, using this
+            // genome as its representative.
+            const int sid = next_species_key_++;
+            new_representatives[sid] = gid;
+            new_members[sid] = {gid};
+        }
+    }
+
+    // Update the species collection based on the new speciation. Species that
+    // got no members are dropped.
+    genome_to_species.clear();
+    std::map<int, Species> updated;
+    for (const auto &[sid, rid] : new_representatives) {
+        auto it = species.find(sid);
+        Species s = it != species.end() ? std::move(it->second) : Species(sid, generation);
+        s.members.clear();
+        for (int gid : new_members[sid]) {
+            genome_to_species[gid] = sid;
+            s.members.emplace(gid, population.at(gid));
+        }
+        s.representative = population.at(rid);
+        updated.emplace(sid, std::move(s));
+    }
+    species = std::move(updated);
+
+    std::vector<int> keys;
+    keys.reserve(population.size());
+    for (const auto &[key, genome] : population) keys.push_back(key);
+    distance_cache.retain(keys);
+}
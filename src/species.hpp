@@ -0,0 +1,71 @@
+#ifndef SPECIES_HPP
+#define SPECIES_HPP
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "distance_cache.hpp"
+#include "genome.hpp"
+
+// Genomes are shared between the population, the species member lists and
+// the representatives, which outlive the generation they were taken from.
+using GenomePtr = std::shared_ptr<DefaultGenome>;
+using GenomeMap = std::map<int, GenomePtr>;
+
+// ---------------------------------------------------------------------------
+// Species: a group of genomes within compatibility_threshold of a
+// representative, together with its fitness history for stagnation.
+// ---------------------------------------------------------------------------
+struct Species {
+    int key;
+    int created;
+    int last_improved;
+    GenomePtr representative;
+    GenomeMap members;
+    std::optional<double> fitness;
+    std::optional<double> adjusted_fitness;
+    std::vector<double> fitness_history;
+
+    Species(int key, int generation) : key(key), created(generation), last_improved(generation) {}
+
+    std::vector<double> get_fitnesses() const;
+};
+
+struct SpeciesSetParams {
+    double compatibility_threshold = 3.0;
+};
+
+// ---------------------------------------------------------------------------
+// DefaultSpeciesSet: the speciation scheme of neat3p.DefaultSpeciesSet.
+// Distances go through a DistanceCache, so children registered with
+// record_birth() are compared to the old representatives incrementally.
+// ---------------------------------------------------------------------------
+class DefaultSpeciesSet {
+   public:
+    explicit DefaultSpeciesSet(const SpeciesSetParams &params) : params(params) {}
+
+    // Place genomes into species by genetic similarity. The representatives of
+    // the existing species are expected to come from the previous generation.
+    void speciate(const DefaultGenomeConfig &config, const GenomeMap &population, int generation);
+
+    void record_birth(const DefaultGenome &child, const DefaultGenome &parent1,
+                      const DefaultGenome &parent2) {
+        distance_cache.record_birth(child, parent1, parent2);
+    }
+
+    int get_species_id(int genome_key) const { return genome_to_species.at(genome_key); }
+    Species &get_species(int genome_key) { return species.at(get_species_id(genome_key)); }
+
+    SpeciesSetParams params;
+    std::map<int, Species> species;
+    std::unordered_map<int, int> genome_to_species;
+    DistanceCache distance_cache;
+
+   private:
+    int next_species_key_ = 1;
+};
+
+#endif  // SPECIES_HPP
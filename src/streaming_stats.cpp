@@ -0,0 +1,154 @@
+#include "streaming_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// RunningMoments
+// ---------------------------------------------------------------------------
+void RunningMoments::add(double x) {
+    count_++;
+    double delta = x - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (x - mean_);
+    min_ = count_ == 1 ? x : std::min(min_, x);
+    max_ = count_ == 1 ? x : std::max(max_, x);
+}
+
+double RunningMoments::stdev() const {
+    return count_ > 0 ? std::sqrt(m2_ / static_cast<double>(count_)) : kNaN;
+}
+
+// ---------------------------------------------------------------------------
+// P2Quantile
+// ---------------------------------------------------------------------------
+P2Quantile::P2Quantile(double q) : q_(q) {
+    if (!(q > 0.0 && q < 1.0)) throw std::invalid_argument("quantile must be in (0, 1)");
+    desired_ = {1.0, 1.0 + 2.0 * q, 1.0 + 4.0 * q, 3.0 + 2.0 * q, 5.0};
+    increments_ = {0.0, q / 2.0, q, (1.0 + q) / 2.0, 1.0};
+    positions_ = {1.0, 2.0, 3.0, 4.0, 5.0};
+}
+
+void P2Quantile::add(double x) {
+    if (count_ < 5) {
+        heights_[count_++] = x;
+        if (count_ == 5) std::sort(heights_.begin(), heights_.end());
+        return;
+    }
+    count_++;
+
+    // Cell k holds x; markers above it move up one position.
+    size_t k;
+    if (x < heights_[0]) {
+        heights_[0] = x;
+        k = 0;
+    }
+    else if (x >= heights_[4]) {
+        heights_[4] = x;
+        k = 3;
+    }
+    else {
+        k = 0;
+        while (x >= heights_[k + 1]) k++;
+    }
+    for (size_t i = k + 1; i < 5; i++) positions_[i] += 1.0;
+    for (size_t i = 0; i < 5; i++) desired_[i] += increments_[i];
+
+    // Move the middle markers toward their desired positions.
+    for (size_t i = 1; i < 4; i++) {
+        double d = desired_[i] - positions_[i];
+        if ((d >= 1.0 && positions_[i + 1] - positions_[i] > 1.0) ||
+            (d <= -1.0 && positions_[i - 1] - positions_[i] < -1.0)) {
+            double s = d > 0.0 ? 1.0 : -1.0;
+            double n0 = positions_[i - 1], n1 = positions_[i], n2 = positions_[i + 1];
+            double h0 = heights_[i - 1], h1 = heights_[i], h2 = heights_[i + 1];
+            double parabolic = h1 + s / (n2 - n0) *
+                                        ((n1 - n0 + s) * (h2 - h1) / (n2 - n1) +
+                                         (n2 - n1 - s) * (h1 - h0) / (n1 - n0));
+            if (h0 < parabolic && parabolic < h2) {
+                heights_[i] = parabolic;
+            }
+            else {
+                size_t j = s > 0.0 ? i + 1 : i - 1;
+                heights_[i] = h1 + s * (heights_[j] - h1) / (positions_[j] - n1);
+            }
+            positions_[i] += s;
+        }
+    }
+}
+
+double P2Quantile::value() const {
+    if (count_ == 0) return kNaN;
+    if (count_ >= 5) return heights_[2];
+    std::array<double, 5> sorted = heights_;
+    std::sort(sorted.begin(), sorted.begin() + count_);
+    size_t rank = static_cast<size_t>(std::lround(q_ * static_cast<double>(count_ - 1)));
+    return sorted[rank];
+}
+
+// ---------------------------------------------------------------------------
+// StreamingStats
+// ---------------------------------------------------------------------------
+StreamingStats::StreamingStats(size_t window, std::vector<double> quantiles)
+    : summaries_(window), species_(window) {
+    if (window == 0) throw std::invalid_argument("window must be positive");
+    for (double q : quantiles) quantiles_.emplace_back(q);
+}
+
+void StreamingStats::ingest(int generation, const double *fitness, const int32_t *species,
+                            size_t n) {
+    GenerationSummary summary{generation, n, kNaN, kNaN, kNaN, kNaN, kNaN};
+    RunningMoments moments;
+    std::unordered_map<int32_t, std::pair<int32_t, double>> per_species;
+    for (size_t i = 0; i < n; i++) {
+        moments.add(fitness[i]);
+        run_.add(fitness[i]);
+        for (P2Quantile &q : quantiles_) q.add(fitness[i]);
+        auto &entry = per_species[species[i]];
+        entry.first++;
+        entry.second += fitness[i];
+    }
+
+    if (n > 0) {
+        summary.mean = moments.mean();
+        summary.stdev = moments.stdev();
+        summary.min = moments.min();
+        summary.max = moments.max();
+        // Median as in math_util.median2: mean of the middle two values.
+        scratch_.assign(fitness, fitness + n);
+        auto mid = scratch_.begin() + n / 2;
+        std::nth_element(scratch_.begin(), mid, scratch_.end());
+        summary.median = *mid;
+        if (n % 2 == 0)
+            summary.median = (summary.median + *std::max_element(scratch_.begin(), mid)) / 2.0;
+    }
+
+    std::vector<SpeciesSummary> species_summary;
+    species_summary.reserve(per_species.size());
+    for (const auto &[sid, entry] : per_species)
+        species_summary.push_back({sid, entry.first, entry.second / entry.first});
+    std::sort(species_summary.begin(), species_summary.end(),
+              [](const SpeciesSummary &a, const SpeciesSummary &b) {
+                  return a.species < b.species;
+              });
+
+    summaries_.push(summary);
+    species_.push(std::move(species_summary));
+    total_generations_++;
+}
+
+int32_t StreamingStats::max_species() const {
+    int32_t out = 0;
+    for (size_t i = 0; i < species_.size(); i++)
+        if (!species_[i].empty()) out = std::max(out, species_[i].back().species);
+    return out;
+}
@@ -0,0 +1,132 @@
+#ifndef STREAMING_STATS_HPP
+#define STREAMING_STATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Constant-memory statistics over a run: per-generation summaries kept in a
+// fixed-size ring buffer, plus run-wide moments and quantile sketches over
+// every fitness value ever seen. Memory depends on the window size and the
+// number of live species, never on the number of generations.
+// ---------------------------------------------------------------------------
+
+// Fixed-capacity FIFO; pushing into a full buffer overwrites the oldest item.
+template <typename T>
+class RingBuffer {
+   public:
+    explicit RingBuffer(size_t capacity) : items_(capacity) {}
+
+    size_t capacity() const { return items_.size(); }
+    size_t size() const { return size_; }
+
+    void push(T item) {
+        const size_t capacity = items_.size();
+        items_[(head_ + size_) % capacity] = std::move(item);
+        if (size_ < capacity) {
+            size_++;
+        }
+        else {
+            head_ = (head_ + 1) % capacity;
+        }
+    }
+
+    // i = 0 is the oldest item.
+    const T &operator[](size_t i) const { return items_[(head_ + i) % items_.size()]; }
+
+   private:
+    std::vector<T> items_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+// Welford's online mean and variance.
+class RunningMoments {
+   public:
+    void add(double x);
+    size_t count() const { return count_; }
+    double mean() const { return mean_; }
+    // Population standard deviation, like math_util.stdev.
+    double stdev() const;
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+   private:
+    size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+};
+
+// The P-square estimator (Jain & Chlamtac, 1985) of one quantile: five
+// markers, adjusted with a piecewise-parabolic fit as values stream in.
+class P2Quantile {
+   public:
+    explicit P2Quantile(double q);
+
+    void add(double x);
+    double q() const { return q_; }
+    // Exact while fewer than five values have been seen.
+    double value() const;
+
+   private:
+    double q_;
+    size_t count_ = 0;
+    std::array<double, 5> heights_{};
+    std::array<double, 5> positions_{};
+    std::array<double, 5> desired_{};
+    std::array<double, 5> increments_{};
+};
+
+struct GenerationSummary {
+    int32_t generation;
+    size_t count;
+    double mean;
+    double stdev;
+    double median;
+    double min;
+    double max;
+};
+
+struct SpeciesSummary {
+    int32_t species;
+    int32_t size;
+    double mean_fitness;
+};
+
+class StreamingStats {
+   public:
+    explicit StreamingStats(size_t window = 1024, std::vector<double> quantiles = {0.1, 0.5, 0.9});
+
+    // Adds one generation: the fitness and species id of each of its genomes.
+    void ingest(int generation, const double *fitness, const int32_t *species, size_t n);
+
+    size_t window() const { return summaries_.capacity(); }
+    // Generations currently held, at most window().
+    size_t size() const { return summaries_.size(); }
+    size_t total_generations() const { return total_generations_; }
+
+    // Oldest first.
+    const GenerationSummary &summary(size_t i) const { return summaries_[i]; }
+    const std::vector<SpeciesSummary> &species(size_t i) const { return species_[i]; }
+
+    // Largest species id seen within the window.
+    int32_t max_species() const;
+
+    const RunningMoments &run_moments() const { return run_; }
+    const std::vector<P2Quantile> &run_quantiles() const { return quantiles_; }
+
+   private:
+    RingBuffer<GenerationSummary> summaries_;
+    RingBuffer<std::vector<SpeciesSummary>> species_;
+    RunningMoments run_;
+    std::vector<P2Quantile> quantiles_;
+    size_t total_generations_ = 0;
+    std::vector<double> scratch_;
+};
+
+#endif  // STREAMING_STATS_HPP
@@ -0,0 +1,23 @@
+"""Helpers shared by the native substrate net tests (quantized and sparse)."""
+
+import numpy as np
+import pytest
+import torch
+
+
+def cppn_node(phase, scale=3.0):
+    """A smooth stand-in for a CPPN output node, painting weights in [-scale, scale]."""
+
+    def node(x_out, y_out, x_in, y_in):
+        return scale * torch.sin(2.0 * x_in * x_out + 1.5 * y_in - y_out + phase)
+
+    return node
+
+
+def check_rejects_bad_shapes(layer_type, *args):
+    """`layer_type(weights, bias, *args)` must refuse mismatched biases and inputs."""
+    layer = layer_type(np.eye(3, 4, dtype=np.float32), np.zeros(3, dtype=np.float32), *args)
+    with pytest.raises(ValueError):
+        layer.forward(np.ones((2, 5), dtype=np.float32))
+    with pytest.raises(ValueError):
+        layer_type(np.ones((3, 4), dtype=np.float32), np.zeros(2, dtype=np.float32), *args)
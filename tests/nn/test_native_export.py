@@ -0,0 +1,235 @@
+"""
+Native phenotype export — RecurrentNet / TorchFeedForwardNetwork built from a
+NativeGenome must match the ones built from an equivalent Python DefaultGenome,
+PackedNet must match per-genome feed-forward evaluation, and phenotypes patched
+from a cached plan must match freshly created ones.
+"""
+
+import os
+
+import numpy as np
+import pytest
+import torch
+
+import neat3p
+from neat3p._neat3p import export_recurrent
+from neat3p.genes import DefaultConnectionGene, DefaultNodeGene
+from neat3p.graphs import feed_forward_layers
+from neat3p.nn.phenotypes.cppn import create_cppn, update_cppn_parameters
+from neat3p.nn.phenotypes.feed_forward_net import TorchFeedForwardNetwork
+from neat3p.nn.phenotypes.packed_net import PackedNet
+from neat3p.nn.phenotypes.plan_cache import PlanCache
+from neat3p.nn.phenotypes.recurrent_net import RecurrentNet
+
+
+def _load_config(genome_type):
+    cfg_path = os.path.join(os.path.dirname(__file__), "configs", "xor.cfg")
+    return neat3p.Config(
+        genome_type,
+        neat3p.DefaultReproduction,
+        neat3p.DefaultSpeciesSet,
+        neat3p.DefaultStagnation,
+        cfg_path,
+    )
+
+
+def _python_copy(native):
+    genome = neat3p.DefaultGenome(key=native.key)
+    for key, ng in native.nodes.items():
+        genome.nodes[key] = DefaultNodeGene(
+            key=key, bias=ng.bias, response=ng.response, activation=ng.activation, aggregation=ng.aggregation
+        )
+    for key, cg in native.connections.items():
+        genome.connections[key] = DefaultConnectionGene(key=key, weight=cg.weight, enabled=cg.enabled)
+    return genome
+
+
+@pytest.fixture
+def genomes():
+    config = _load_config(neat3p.NativeGenome)
+    neat3p._neat3p.seed(7)
+    native = neat3p.NativeGenome(key=1)
+    native.configure_new(config.genome_config)
+    for _ in range(40):
+        native.mutate(config.genome_config)
+    return config, native, _python_copy(native)
+
+
+@pytest.mark.parametrize("prune_empty", [False, True])
+def test_recurrent_net_parity(genomes, prune_empty):
+    config, native, python = genomes
+    kwargs = dict(batch_size=4, prune_empty=prune_empty, n_internal_steps=2, device="cpu")
+    net_native = RecurrentNet.create(native, config, **kwargs)
+    net_python = RecurrentNet.create(python, _load_config(neat3p.DefaultGenome), **kwargs)
+
+    torch.manual_seed(0)
+    for _ in range(3):
+        inputs = torch.rand(4, config.genome_config.num_inputs, dtype=torch.float64)
+        torch.testing.assert_close(net_native.activate(inputs), net_python.activate(inputs))
+
+
+def test_export_shares_memory(genomes):
+    config, native, _ = genomes
+    data = export_recurrent(native, config.genome_config.input_keys, config.genome_config.output_keys)
+    weights = torch.from_dlpack(data["weights"])
+    assert weights.dtype == torch.float32
+    assert torch.from_dlpack(data["coo"]).dtype == torch.int32
+    weights.fill_(0.25)
+    assert (data["weights"] == 0.25).all()
+
+
+def test_feed_forward_parity(genomes):
+    config, native, python = genomes
+    net_native = TorchFeedForwardNetwork.create(native, config)
+    net_python = TorchFeedForwardNetwork.create(python, _load_config(neat3p.DefaultGenome))
+
+    assert sorted(ne[0] for ne in net_native.node_evals) == sorted(ne[0] for ne in net_python.node_evals)
+    inputs = torch.rand(1, config.genome_config.num_inputs, dtype=torch.float64)
+    torch.testing.assert_close(net_native(inputs), net_python(inputs))
+
+
+def _perturb_weights(genome, seed):
+    rng = np.random.default_rng(seed)
+    genome.writable_weights()[:] += rng.normal(0.0, 0.5, genome.weights.shape).astype(np.float32)
+    genome.writable_biases()[:] += rng.normal(0.0, 0.5, genome.biases.shape).astype(np.float32)
+
+
+def test_topology_hash_ignores_parameters(genomes):
+    config, native, _ = genomes
+    child = neat3p.NativeGenome.from_bytes(native.to_bytes())
+    _perturb_weights(child, 0)
+    assert child.topology_hash() == native.topology_hash()
+    child.mutate_add_node(config.genome_config)
+    assert child.topology_hash() != native.topology_hash()
+
+
+def test_plan_cache_reuses_plan_for_weight_mutations(genomes):
+    config, native, _ = genomes
+    cache = PlanCache()
+    RecurrentNet.create(native, config, batch_size=2, device="cpu", plan_cache=cache)
+    child = neat3p.NativeGenome.from_bytes(native.to_bytes())
+    _perturb_weights(child, 1)
+    net = RecurrentNet.create(child, config, batch_size=2, device="cpu", plan_cache=cache)
+    assert (cache.hits, cache.misses, len(cache)) == (1, 1, 1)
+
+    fresh = RecurrentNet.create(child, config, batch_size=2, device="cpu")
+    inputs = torch.rand(2, config.genome_config.num_inputs, dtype=torch.float64)
+    torch.testing.assert_close(net.activate(inputs), fresh.activate(inputs))
+
+
+def test_phenotypes_keep_child_columns_shared(genomes):
+    config, native, _ = genomes
+    native.fitness = 1.0
+    child = neat3p.NativeGenome(key=2)
+    child.configure_crossover(native, native, config.genome_config)
+    assert child.shared_columns(native) == (5, 3)
+
+    cache = PlanCache()
+    RecurrentNet.create(child, config, batch_size=2, device="cpu", plan_cache=cache)
+    TorchFeedForwardNetwork.create(child, config, plan_cache=cache)
+    PackedNet.create([(child.key, child)], config)
+    assert child.shared_columns(native) == (5, 3)
+
+    child.writable_weights()[0] += 1.0
+    assert child.shared_columns(native) == (5, 2)
+
+
+@pytest.mark.parametrize("prune_empty", [False, True])
+def test_recurrent_update_parameters(genomes, prune_empty):
+    config, native, _ = genomes
+    kwargs = dict(batch_size=3, prune_empty=prune_empty, device="cpu")
+    net = RecurrentNet.create(native, config, **kwargs)
+    child = neat3p.NativeGenome.from_bytes(native.to_bytes())
+    _perturb_weights(child, 2)
+    net.update_parameters(child)
+    fresh = RecurrentNet.create(child, config, **kwargs)
+
+    for name in ("input_to_output", "hidden_to_output", "output_to_output", "output_biases", "output_responses"):
+        torch.testing.assert_close(getattr(net, name), getattr(fresh, name))
+    if net.n_hidden > 0:
+        for name in ("input_to_hidden", "hidden_to_hidden", "output_to_hidden", "hidden_biases", "hidden_responses"):
+            torch.testing.assert_close(getattr(net, name), getattr(fresh, name))
+
+    child.mutate_add_node(config.genome_config)
+    with pytest.raises(ValueError):
+        net.update_parameters(child)
+
+
+def test_feed_forward_update_parameters(genomes):
+    config, native, _ = genomes
+    cache = PlanCache()
+    net = TorchFeedForwardNetwork.create(native, config, plan_cache=cache)
+    child = neat3p.NativeGenome.from_bytes(native.to_bytes())
+    _perturb_weights(child, 3)
+    node_evals = net.node_evals
+    net.update_parameters(child)
+    assert net.node_evals is node_evals
+    fresh = TorchFeedForwardNetwork.create(child, config, plan_cache=cache)
+    assert cache.hits == 1
+
+    inputs = torch.rand(1, config.genome_config.num_inputs, dtype=torch.float64)
+    torch.testing.assert_close(net(inputs), fresh(inputs))
+
+    # A plan whose topology only shares the hash with the genome (as on a hash
+    # collision) is refused too.
+    net.plan.signature.enabled = ~net.plan.signature.enabled
+    assert child.topology_hash() == native.topology_hash()
+    with pytest.raises(ValueError):
+        net.update_parameters(child)
+
+
+def test_cppn_update_parameters(genomes):
+    config, native, _ = genomes
+    cache = PlanCache()
+    names = (["x", "y"], ["out"])
+    (node,) = create_cppn(native, config, *names, plan_cache=cache)
+    child = neat3p.NativeGenome.from_bytes(native.to_bytes())
+    _perturb_weights(child, 4)
+    update_cppn_parameters([node], child)
+    (cached,) = create_cppn(child, config, *names, plan_cache=cache)
+    (fresh,) = create_cppn(child, config, *names)
+    assert (cache.hits, cache.misses) == (1, 1)
+
+    x, y = torch.rand(2, 5, 3, dtype=torch.float64)
+    expected = fresh(x=x, y=y)
+    torch.testing.assert_close(node(x=x, y=y), expected)
+    torch.testing.assert_close(cached(x=x, y=y), expected)
+
+    child.mutate_add_node(config.genome_config)
+    with pytest.raises(ValueError):
+        update_cppn_parameters([node], child)
+
+
+def _reference_feed_forward(genome, genome_config, inputs):
+    connections = [key for key, cg in genome.connections.items() if cg.enabled]
+    values = dict(zip(genome_config.input_keys, inputs))
+    for layer in feed_forward_layers(genome_config.input_keys, genome_config.output_keys, connections):
+        for node in layer:
+            ng = genome.nodes[node]
+            links = [values[i] * genome.connections[(i, o)].weight for i, o in connections if o == node]
+            s = genome_config.aggregation_function_defs.get(ng.aggregation)(links)
+            values[node] = genome_config.activation_defs.get(ng.activation)(ng.bias + ng.response * s)
+    return [values.get(k, 0.0) for k in genome_config.output_keys]
+
+
+@pytest.mark.parametrize("batch_size", [1, 3])
+def test_packed_net_matches_feed_forward(genomes, batch_size):
+    config, native, _ = genomes
+    # More genomes than SIMD lanes, so that the last group is partly padding.
+    population = [(native.key, native)]
+    for key in range(2, 12):
+        g = neat3p.NativeGenome(key=key)
+        g.configure_new(config.genome_config)
+        for _ in range(20):
+            g.mutate(config.genome_config)
+        population.append((key, g))
+
+    packed = PackedNet.create(population, config, batch_size=batch_size)
+    inputs = np.random.default_rng(0).uniform(-1, 1, (len(population), batch_size, config.genome_config.num_inputs))
+    outputs = packed.activate(inputs)
+    assert outputs.shape == (len(population), batch_size, config.genome_config.num_outputs)
+
+    for row, (_, genome) in enumerate(population):
+        for b in range(batch_size):
+            expected = _reference_feed_forward(genome, config.genome_config, inputs[row, b].tolist())
+            np.testing.assert_allclose(outputs[row, b], expected, rtol=1e-4, atol=1e-5)
@@ -0,0 +1,81 @@
+"""
+Quantized substrate inference: int8 / fp16 layers must stay within their
+rounding error of the float32 computation, and calibrate() must report it.
+"""
+
+import numpy as np
+import pytest
+
+from neat3p._neat3p import QuantizedLayer
+from neat3p.nn.composite.hyper_neat import HyperNEATLinearNet, HyperNEATNet, make_grid_coords
+from neat3p.nn.modules.activations import identity_activation, sin_activation
+from neat3p.nn.phenotypes.quantized_net import output_drift
+
+from .substrate_helpers import check_rejects_bad_shapes, cppn_node
+
+
+@pytest.mark.parametrize("precision", ["int8", "fp16"])
+def test_layer_matches_float32(precision):
+    rng = np.random.default_rng(0)
+    weights = rng.uniform(-3, 3, size=(40, 70)).astype(np.float32)
+    bias = rng.uniform(-1, 1, size=40).astype(np.float32)
+    inputs = rng.uniform(-1, 1, size=(6, 70)).astype(np.float32)
+
+    layer = QuantizedLayer(weights, bias, precision, "identity")
+    decoded = layer.dequantized()
+    if precision == "int8":
+        assert layer.weight_bytes == 40 * 70 + 40 * 4
+        step = np.abs(weights).max(axis=1, keepdims=True) / 127
+        assert np.all(np.abs(decoded - weights) <= step / 2 + 1e-6)
+    else:
+        assert layer.weight_bytes == 40 * 70 * 2
+        np.testing.assert_allclose(decoded, weights, rtol=2**-11)
+
+    # forward() must compute exactly with the decoded weights.
+    expected = inputs @ decoded.T + bias
+    np.testing.assert_allclose(layer.forward(inputs), expected, rtol=1e-5, atol=1e-4)
+
+
+def test_layer_rejects_bad_shapes():
+    check_rejects_bad_shapes(QuantizedLayer)
+    with pytest.raises(ValueError):
+        QuantizedLayer(np.ones((3, 4), dtype=np.float32), np.zeros(3, dtype=np.float32), "int4")
+
+
+@pytest.mark.parametrize("precision,max_drift", [("int8", 5e-3), ("fp16", 5e-4)])
+def test_hyperneat_calibration(precision, max_drift):
+    # Identity activations, so that the drift is not hidden by saturation.
+    net = HyperNEATNet(
+        cppn_node(0.0),
+        cppn_node(0.5),
+        cppn_node(1.0),
+        cppn_node(1.5),
+        make_grid_coords(64, 1.0),
+        make_grid_coords(48, 0.0),
+        make_grid_coords(6, -1.0),
+        activation=identity_activation,
+        batch_size=16,
+        device="cpu",
+    )
+    quantized = net.quantized(precision)
+    inputs = np.random.default_rng(1).uniform(-1, 1, size=(16, 64)).astype(np.float32)
+
+    report = quantized.calibrate(net, inputs)
+    assert report["max_abs"] < max_drift * np.abs(net.activate(inputs).numpy()).max()
+    assert report["mean_abs"] <= report["rms"] <= report["max_abs"]
+    assert report["argmax_agreement"] >= 0.9
+    assert report["weight_bytes"] < (64 * 48 + 48 * 6) * 4 / (1.9 if precision == "fp16" else 3.5)
+    assert report == {**output_drift(net.activate(inputs).numpy(), quantized.activate(inputs)), **report}
+
+
+def test_linear_net_and_unsupported_activation():
+    net = HyperNEATLinearNet(
+        cppn_node(0.0), cppn_node(1.0), make_grid_coords(10, 0.5), make_grid_coords(3, -0.5), device="cpu"
+    )
+    inputs = np.random.default_rng(2).uniform(-1, 1, size=(4, 10)).astype(np.float32)
+    assert net.quantized("fp16").calibrate(net, inputs)["max_abs"] < 0.01
+
+    # The native sin differs from the torch one, so it is refused.
+    net.activation = sin_activation
+    with pytest.raises(ValueError):
+        net.quantized()
@@ -0,0 +1,95 @@
+"""
+Sparse substrate inference: CSR and dense layers must compute the same outputs,
+each layer must pick its format from the density of its thresholded weights,
+and HyperNEAT nets on the CPU must run through them.
+"""
+
+import numpy as np
+import pytest
+
+from neat3p._neat3p import SparseLayer
+from neat3p.nn.composite.hyper_neat import HyperNEATLinearNet, HyperNEATNet, make_grid_coords
+from neat3p.nn.modules.activations import identity_activation, sin_activation
+
+from .substrate_helpers import check_rejects_bad_shapes, cppn_node
+
+
+@pytest.mark.parametrize("density", [0.0, 0.05, 0.5, 1.0])
+@pytest.mark.parametrize("batch_size", [1, 9])
+def test_layer_matches_dense_product(density, batch_size):
+    rng = np.random.default_rng(0)
+    weights = rng.uniform(-3, 3, size=(40, 70)).astype(np.float32)
+    weights[rng.uniform(size=weights.shape) >= density] = 0.0
+    bias = rng.uniform(-1, 1, size=40).astype(np.float32)
+    inputs = rng.uniform(-1, 1, size=(batch_size, 70)).astype(np.float32)
+
+    layer = SparseLayer(weights, bias)
+    assert layer.nnz == np.count_nonzero(weights)
+    assert layer.density == pytest.approx(layer.nnz / weights.size)
+    assert layer.format == ("csr" if layer.density <= 0.25 else "dense")
+    np.testing.assert_array_equal(layer.dense(), weights)
+
+    expected = inputs @ weights.T + bias
+    np.testing.assert_allclose(layer.forward(inputs), expected, rtol=1e-5, atol=1e-4)
+    forced = SparseLayer(weights, bias, max_density=1.0)
+    assert forced.format == "csr"
+    np.testing.assert_allclose(forced.forward(inputs), expected, rtol=1e-5, atol=1e-4)
+
+
+def test_layer_rejects_bad_shapes():
+    check_rejects_bad_shapes(SparseLayer)
+
+
+def _hyperneat_net(native=None):
+    # The threshold prunes most input→hidden weights; hidden→output is painted
+    # at a scale that keeps nearly all of its weights above it.
+    return HyperNEATNet(
+        cppn_node(-1.5),
+        cppn_node(0.5),
+        cppn_node(1.0, scale=100.0),
+        cppn_node(1.5),
+        make_grid_coords(64, 1.0),
+        make_grid_coords(48, 0.0),
+        make_grid_coords(6, -1.0),
+        weight_threshold=2.5,
+        activation=identity_activation,
+        batch_size=16,
+        device="cpu",
+        native=native,
+    )
+
+
+def test_hyperneat_net_picks_format_per_layer():
+    net = _hyperneat_net()
+    reference = _hyperneat_net(native=False)
+    assert reference.native_net is None
+
+    # On the CPU the net itself runs on the per-layer formats.
+    assert net.native_net.formats == ["csr", "dense"]
+    assert net.native_net.densities[0] == pytest.approx(
+        float((net.input_to_hidden != 0).float().mean()), abs=1e-6
+    )
+    assert net.native_net.weight_bytes < (64 * 48 + 48 * 6) * 4
+
+    inputs = np.random.default_rng(1).uniform(-1, 1, size=(16, 64)).astype(np.float32)
+    expected = reference.activate(inputs).numpy()
+    np.testing.assert_allclose(net.activate(inputs).numpy(), expected, rtol=1e-4, atol=1e-4)
+    np.testing.assert_allclose(net.sparse().activate(inputs), expected, rtol=1e-4, atol=1e-4)
+
+    assert net.sparse(max_density=0.0).formats == ["dense", "dense"]
+
+
+def test_linear_net():
+    def linear_net(**kwargs):
+        return HyperNEATLinearNet(
+            cppn_node(0.0), cppn_node(1.0), make_grid_coords(10, 0.5), make_grid_coords(3, -0.5), **kwargs
+        )
+
+    net = linear_net(device="cpu")
+    assert net.native_net is not None
+    inputs = np.random.default_rng(2).uniform(-1, 1, size=(4, 10)).astype(np.float32)
+    expected = linear_net(device="cpu", native=False).activate(inputs).numpy()
+    np.testing.assert_allclose(net.activate(inputs).numpy(), expected, rtol=1e-4, atol=1e-5)
+
+    # Activations without a native implementation stay on torch.
+    assert linear_net(device="cpu", activation=sin_activation).native_net is None
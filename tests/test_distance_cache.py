@@ -0,0 +1,100 @@
+"""Tests for the native distance cache used by speciation."""
+
+import os
+import pickle
+import unittest
+
+import neat3p
+
+
+class TestDistanceCache(unittest.TestCase):
+    def setUp(self):
+        local_dir = os.path.dirname(__file__)
+        config_path = os.path.join(local_dir, "test_configuration")
+        self.config = neat3p.Config(
+            neat3p.NativeGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            config_path,
+        )
+        neat3p._neat3p.seed(7)
+
+    def _genome(self, key, mutations=10):
+        g = neat3p.NativeGenome(key=key)
+        g.configure_new(self.config.genome_config)
+        for _ in range(mutations):
+            g.mutate(self.config.genome_config)
+        return g
+
+    def test_derived_distance_matches_full(self):
+        # test_configuration perturbs most weights and biases of every child.
+        config = self.config.genome_config
+        cache = neat3p._neat3p.DistanceCache()
+        reps = [self._genome(k) for k in range(3)]
+        parents = [self._genome(k) for k in range(10, 20)]
+        for rep in reps:
+            for parent in parents:
+                cache.distance(rep, parent, config.native)
+
+        key = 100
+        for parent in parents:
+            child = neat3p.NativeGenome(key=key)
+            key += 1
+            child.configure_crossover(parent, parent, config)
+            child.mutate(config)
+            cache.record_birth(child, parent, parent)
+            for rep in reps:
+                self.assertAlmostEqual(cache.distance(rep, child, config.native), rep.distance(child, config))
+                self.assertAlmostEqual(cache.distance(child, rep, config.native), rep.distance(child, config))
+        self.assertGreater(cache.derived, 0)
+        self.assertGreater(cache.hits, 0)
+
+    def test_large_edits_are_not_recorded(self):
+        config = self.config.genome_config
+        cache = neat3p._neat3p.DistanceCache(max_edit_fraction=0.0)
+        parent = self._genome(1)
+        child = neat3p.NativeGenome(key=2)
+        child.configure_crossover(parent, parent, config)
+        # Perturbing every weight is not a structural edit.
+        child.writable_weights()[:] += 1.0
+        cache.record_birth(child, parent, parent)
+        self.assertEqual(cache.num_edits, 1)
+
+        child.mutate_add_node(config)
+        cache.record_birth(child, parent, parent)
+        self.assertEqual(cache.num_edits, 0)
+
+        cache.distance(parent, child, config.native)
+        self.assertEqual(cache.computed, 1)
+        cache.retain([child.key])
+        self.assertEqual(cache.num_terms, 0)
+
+    def test_population_uses_cache(self):
+        def eval_genomes(genomes, config):
+            # Stays below fitness_threshold, so that all generations run.
+            for _, genome in genomes:
+                genome.fitness = 0.5 - 0.01 * len(genome.connections)
+
+        p = neat3p.Population(self.config)
+        p.run(eval_genomes, 5)
+        cache = p.species.distance_cache
+        self.assertIsNotNone(cache)
+        # With test_configuration's mutation rates a sizeable share of the
+        # distances to representatives is derived rather than merge-joined.
+        self.assertGreater(10 * cache.derived, cache.computed)
+
+        # Species membership must match the distances computed from scratch.
+        threshold = self.config.species_set_config.compatibility_threshold
+        for s in p.species.species.values():
+            rep = s.representative
+            for member in s.members.values():
+                if member.key != rep.key:
+                    self.assertLess(rep.distance(member, self.config.genome_config), threshold)
+
+        restored = pickle.loads(pickle.dumps(p.species))
+        self.assertIsNone(restored.distance_cache)
+
+
+if __name__ == "__main__":
+    unittest.main()
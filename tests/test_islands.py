@@ -0,0 +1,153 @@
+"""Island-model evolution and its shared-memory migration rings."""
+
+import os
+import tempfile
+import unittest
+
+import neat3p
+from neat3p import _neat3p
+from neat3p.islands import MigrationReporter, island_topology
+
+
+def eval_genomes(genomes, config):
+    for genome_id, genome in genomes:
+        genome.fitness = float(len(genome.connections) - len(genome.nodes))
+
+
+class TestMigrationRing(unittest.TestCase):
+    def test_round_trip_and_wraparound(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "ring")
+            producer = _neat3p.MigrationRing(path, 256, create=True)
+            consumer = _neat3p.MigrationRing(path)
+            self.assertIsNone(consumer.pop())
+
+            # 100-byte messages take 104 bytes, so the third push fails and
+            # later ones wrap around the end of the buffer.
+            for i in range(20):
+                message = bytes([i]) * 100
+                self.assertTrue(producer.push(message))
+                self.assertTrue(producer.push(message))
+                self.assertFalse(producer.push(message))
+                self.assertEqual(consumer.pop(), message)
+                self.assertEqual(consumer.pop(), message)
+                self.assertIsNone(consumer.pop())
+            self.assertEqual(producer.used, 0)
+
+            with self.assertRaises(ValueError):
+                producer.push(b"x" * 300)
+
+    def test_native_genome_migrant(self):
+        local_dir = os.path.dirname(__file__)
+        config = neat3p.Config(
+            neat3p.NativeGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            os.path.join(local_dir, "test_configuration"),
+        )
+        genome = neat3p.NativeGenome(1)
+        genome.configure_new(config.genome_config)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            ring = _neat3p.MigrationRing(os.path.join(tmpdir, "ring"), 1 << 16, create=True)
+            self.assertTrue(ring.push(genome.to_bytes()))
+            migrant = neat3p.NativeGenome.from_bytes(ring.pop())
+        self.assertEqual(str(migrant), str(genome))
+
+
+class TestIslandModel(unittest.TestCase):
+    def test_topologies(self):
+        self.assertEqual(island_topology("ring", 3), {0: [1], 1: [2], 2: [0]})
+        self.assertEqual(island_topology("bidirectional_ring", 3), {0: [1, 2], 1: [0, 2], 2: [0, 1]})
+        self.assertEqual(island_topology("fully_connected", 2), {0: [1], 1: [0]})
+        self.assertEqual(island_topology({0: [1]}, 2), {0: [1], 1: []})
+        with self.assertRaises(RuntimeError):
+            island_topology({0: [5]}, 2)
+
+    def test_islands_exchange_migrants(self):
+        local_dir = os.path.dirname(__file__)
+        for genome_type in [neat3p.NativeGenome, neat3p.DefaultGenome]:
+            config = neat3p.Config(
+                genome_type,
+                neat3p.DefaultReproduction,
+                neat3p.DefaultSpeciesSet,
+                neat3p.DefaultStagnation,
+                os.path.join(local_dir, "test_configuration"),
+            )
+            config.no_fitness_termination = True
+
+            # Long enough for migrants to go through add-node mutations on
+            # the islands that received them.
+            islands = neat3p.IslandModel(
+                config, num_islands=3, migration_interval=2, migration_rate=0.1, topology="ring", seed=1
+            )
+            best = islands.run(eval_genomes, 12)
+
+            self.assertIsInstance(best, genome_type)
+            self.assertEqual(best.fitness, max(g.fitness for g in islands.best_genomes.values()))
+            self.assertEqual(islands.generations, {0: 12, 1: 12, 2: 12})
+            # Islands run unsynchronized, so only migrants sent in time are received.
+            num_migrants = int(round(0.1 * config.pop_size))
+            counts = islands.migration_counts.values()
+            for c in counts:
+                self.assertEqual(c["sent"], 6 * num_migrants)
+                self.assertEqual(c["dropped"], 0)
+            self.assertLessEqual(sum(c["received"] for c in counts), sum(c["sent"] for c in counts))
+
+    def test_islands_are_seeded_independently(self):
+        local_dir = os.path.dirname(__file__)
+        config = neat3p.Config(
+            neat3p.NativeGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            os.path.join(local_dir, "test_configuration"),
+        )
+        config.no_fitness_termination = True
+
+        def initial_populations():
+            # Every island inherits this engine state when it is forked.
+            _neat3p.seed(3)
+            islands = neat3p.IslandModel(config, num_islands=2, migration_rate=0.0, seed=5)
+            islands.run(eval_genomes, 1)
+            return [islands.best_genomes[i].to_bytes() for i in range(2)]
+
+        first = initial_populations()
+        self.assertNotEqual(first[0], first[1])
+        self.assertEqual(initial_populations(), first)
+
+    def test_migrants_replace_offspring(self):
+        local_dir = os.path.dirname(__file__)
+        config = neat3p.Config(
+            neat3p.NativeGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            os.path.join(local_dir, "test_configuration"),
+        )
+        config.no_fitness_termination = True
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "ring")
+            _neat3p.MigrationRing(path, 1 << 20, create=True)
+            source = neat3p.Population(config)
+            source_migration = MigrationReporter(source.reproduction, [_neat3p.MigrationRing(path)], [], 2, 5)
+            source.add_reporter(source_migration)
+            target = neat3p.Population(config)
+            target_migration = MigrationReporter(target.reproduction, [], [_neat3p.MigrationRing(path)], 2, 5)
+            target.add_reporter(target_migration)
+
+            source.run(eval_genomes, 2)
+            self.assertEqual(source_migration.sent, 5)
+            target.run(eval_genomes, 2)
+            self.assertEqual(target_migration.received, 5)
+
+        self.assertEqual(set(target.species.genome_to_species), set(target.population))
+        migrant_keys = sorted(target.population)[-5:]
+        for key in migrant_keys:
+            self.assertEqual(target.population[key].key, key)
+            self.assertEqual(target.reproduction.ancestors[key], ())
+
+
+if __name__ == "__main__":
+    unittest.main()
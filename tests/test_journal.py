@@ -0,0 +1,106 @@
+"""Tests for the append-only genome journal."""
+
+import os
+import tempfile
+import unittest
+
+import neat3p
+
+
+class TestGenomeJournal(unittest.TestCase):
+    def setUp(self):
+        local_dir = os.path.dirname(__file__)
+        config_path = os.path.join(local_dir, "test_configuration")
+        self.config = neat3p.Config(
+            neat3p.NativeGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            config_path,
+        )
+        self.config.no_fitness_termination = True
+        neat3p._neat3p.seed(3)
+        self.tmpdir = tempfile.TemporaryDirectory()
+        self.path = os.path.join(self.tmpdir.name, "run.journal")
+
+    def tearDown(self):
+        self.tmpdir.cleanup()
+
+    def test_replays_every_genome(self):
+        p = neat3p.Population(self.config)
+        reporter = neat3p.JournalReporter(self.path, p.reproduction, keyframe_interval=3)
+        p.add_reporter(reporter)
+
+        seen = {}
+
+        def eval_genomes(genomes, config):
+            for genome_id, genome in genomes:
+                genome.fitness = float(len(genome.connections))
+                seen[genome_id] = genome.to_bytes()
+
+        p.run(eval_genomes, 5)
+        del reporter, p
+
+        journal = neat3p.GenomeJournal(self.path)
+        self.assertEqual(len(journal), len(seen))
+        self.assertEqual(list(journal.generations), list(range(5)))
+        for key, data in seen.items():
+            self.assertEqual(journal.genome(key).to_bytes(), data)
+
+        child = max(seen)
+        info = journal.info(child)
+        self.assertEqual(info.generation, 4)
+        self.assertIn(info.parent1, journal)
+        lineage = journal.lineage(child)
+        self.assertEqual(lineage[0], child)
+        self.assertEqual(journal.info(lineage[-1]).parent1, -1)
+
+        evals = journal.evaluations(4)
+        self.assertEqual(len(evals["keys"]), self.config.pop_size)
+        best = journal.best_genome(4)
+        self.assertEqual(best.fitness, evals["fitness"].max())
+
+    def test_reopen_after_truncated_tail(self):
+        config = self.config.genome_config
+        genomes = []
+        for key in range(1, 5):
+            genome = neat3p.NativeGenome(key)
+            genome.configure_new(config)
+            genome.fitness = float(key)
+            genomes.append(genome)
+
+        writer = neat3p._neat3p.JournalWriter(self.path)
+        for genome in genomes[:2]:
+            writer.record(genome, 0)
+        writer.end_generation(0)
+        del writer
+        # A crash in the middle of the generation 0 end marker.
+        with open(self.path, "r+b") as f:
+            f.truncate(os.path.getsize(self.path) - 3)
+
+        writer = neat3p._neat3p.JournalWriter(self.path)
+        for genome in genomes[2:]:
+            writer.record(genome, 1)
+        writer.end_generation(1)
+        del writer
+
+        journal = neat3p.GenomeJournal(self.path)
+        self.assertEqual(list(journal.generations), [0, 1])
+        for genome in genomes:
+            self.assertEqual(journal.genome(genome.key).to_bytes(), genome.to_bytes())
+        self.assertEqual(journal.evaluations(1)["keys"].tolist(), [3, 4])
+
+    def test_ancestors_are_pruned(self):
+        p = neat3p.Population(self.config)
+        p.add_reporter(neat3p.JournalReporter(self.path, p.reproduction))
+
+        def eval_genomes(genomes, config):
+            for genome_id, genome in genomes:
+                genome.fitness = 1.0
+
+        p.run(eval_genomes, 3)
+        self.assertLessEqual(len(p.reproduction.ancestors), self.config.pop_size)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,234 @@
+"""Tests for the native genome and its zero-copy NumPy views."""
+
+import os
+import pickle
+import unittest
+
+import numpy as np
+
+import neat3p
+
+
+class TestNativeGenome(unittest.TestCase):
+    def setUp(self):
+        local_dir = os.path.dirname(__file__)
+        config_path = os.path.join(local_dir, "test_configuration")
+        self.config = neat3p.Config(
+            neat3p.NativeGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            config_path,
+        )
+        neat3p._neat3p.seed(42)
+
+    def test_configure_full(self):
+        config = self.config.genome_config
+        config.initial_connection = "full_nodirect"
+        config.num_hidden = 2
+
+        g = neat3p.NativeGenome(key=7)
+        g.configure_new(config)
+        self.assertEqual(g.key, 7)
+        self.assertEqual(set(g.nodes), {0, 1, 2})
+        self.assertEqual(
+            set(g.connections),
+            {(-1, 1), (-2, 1), (-1, 2), (-2, 2), (1, 0), (2, 0)},
+        )
+
+    def test_views_share_memory(self):
+        config = self.config.genome_config
+        config.initial_connection = "full_direct"
+        g = neat3p.NativeGenome(key=1)
+        g.configure_new(config)
+
+        self.assertEqual(g.connection_keys.shape, (len(g.connections), 2))
+        self.assertEqual(list(g.node_keys), sorted(g.nodes))
+        self.assertFalse(g.node_keys.flags.writeable)
+
+        self.assertFalse(g.weights.flags.writeable)
+        g.writable_weights()[:] = 0.5
+        for cg in g.connections.values():
+            self.assertAlmostEqual(cg.weight, 0.5)
+
+        g.connections[(-1, 0)].enabled = False
+        row = [tuple(k) for k in g.connection_keys].index((-1, 0))
+        self.assertFalse(g.enabled[row])
+
+        g.writable_biases()[0] = 1.25
+        self.assertAlmostEqual(g.nodes[0].bias, 1.25)
+
+    def test_structural_changes_wait_for_writable_views(self):
+        config = self.config.genome_config
+        config.initial_connection = "full_direct"
+        g = neat3p.NativeGenome(key=1)
+        g.configure_new(config)
+        node_keys = g.node_keys
+        connection_keys = g.connection_keys
+        data = g.to_bytes()
+
+        weights = g.writable_weights()
+        with self.assertRaises(RuntimeError):
+            g.mutate(config)
+        with self.assertRaises(RuntimeError):
+            g.mutate_add_node(config)
+        with self.assertRaises(RuntimeError):
+            del g.connections[(-1, 0)]
+        self.assertEqual(g.to_bytes(), data)
+        row = [tuple(k) for k in connection_keys].index((-1, 0))
+        weights[row] = 0.75
+        self.assertAlmostEqual(g.connections[(-1, 0)].weight, 0.75)
+
+        del weights
+        for _ in range(20):
+            g.mutate_add_node(config)
+        # The key arrays are copies, so they outlive the structural changes.
+        self.assertEqual(list(node_keys), [0])
+        self.assertEqual(len(connection_keys), 2)
+        self.assertGreater(len(g.node_keys), 1)
+
+    def test_mutate_keeps_tables_sorted(self):
+        config = self.config.genome_config
+        g = neat3p.NativeGenome(key=1)
+        g.configure_new(config)
+        for _ in range(200):
+            g.mutate(config)
+        self.assertTrue(np.all(np.diff(g.node_keys) > 0))
+        keys = [tuple(k) for k in g.connection_keys]
+        self.assertEqual(keys, sorted(set(keys)))
+
+    def test_crossover_and_distance(self):
+        config = self.config.genome_config
+        g1 = neat3p.NativeGenome(key=1)
+        g1.configure_new(config)
+        g2 = neat3p.NativeGenome(key=2)
+        g2.configure_new(config)
+        for _ in range(20):
+            g2.mutate(config)
+        g1.fitness = 1.0
+        g2.fitness = 0.0
+
+        child = neat3p.NativeGenome(key=3)
+        child.configure_crossover(g1, g2, config)
+        self.assertEqual(set(child.nodes), set(g1.nodes))
+        self.assertEqual(g1.distance(g1, config), 0.0)
+        self.assertAlmostEqual(g1.distance(g2, config), g2.distance(g1, config))
+
+    def test_clone_writes_do_not_reach_parent(self):
+        config = self.config.genome_config
+        config.initial_connection = "full_direct"
+        parent = neat3p.NativeGenome(key=1)
+        parent.configure_new(config)
+        parent.fitness = 1.0
+        weights = parent.weights.copy()
+        enabled = parent.enabled.copy()
+
+        child = neat3p.NativeGenome(key=2)
+        child.configure_crossover(parent, parent, config)
+        child.writable_weights()[:] = 7.0
+        for cg in child.connections.values():
+            cg.enabled = not cg.enabled
+        child.nodes[0].bias = 3.0
+        np.testing.assert_array_equal(parent.weights, weights)
+        np.testing.assert_array_equal(parent.enabled, enabled)
+        self.assertNotEqual(parent.nodes[0].bias, 3.0)
+
+        # A live writable view of the parent stays attached to the parent only.
+        view = parent.writable_biases()
+        clone = neat3p.NativeGenome(key=3)
+        clone.configure_crossover(parent, parent, config)
+        view[0] = -2.0
+        self.assertAlmostEqual(parent.nodes[0].bias, -2.0)
+        self.assertNotEqual(clone.nodes[0].bias, -2.0)
+
+    def test_mutation_copies_only_touched_blocks(self):
+        config = self.config.genome_config
+        config.initial_connection = "full_nodirect"
+        config.num_hidden = 300
+        config.node_add_prob = config.node_delete_prob = 0.0
+        config.conn_add_prob = config.conn_delete_prob = 0.0
+        config.weight_mutate_rate = config.bias_mutate_rate = 0.005
+        config.weight_replace_rate = config.bias_replace_rate = 0.0
+        config.enabled_mutate_rate = 0.0
+        parent = neat3p.NativeGenome(key=1)
+        parent.configure_new(config)
+        parent.fitness = 1.0
+        columns = {name: getattr(parent, name).copy() for name in ("weights", "enabled", "biases", "responses")}
+
+        child = neat3p.NativeGenome(key=2)
+        child.configure_crossover(parent, parent, config)
+        before = neat3p._neat3p.cow_copied_bytes()
+        child.mutate(config)
+        copied = neat3p._neat3p.cow_copied_bytes() - before
+
+        # Each changed gene copies the block of its column holding it, once.
+        block = neat3p._neat3p.gene_block_size
+        expected = 0
+        for name, values in columns.items():
+            rows = np.nonzero(getattr(child, name) != values)[0]
+            for b in set(rows // block):
+                expected += len(values[b * block : (b + 1) * block]) * values.itemsize
+        self.assertGreater(expected, 0)
+        self.assertEqual(copied, expected)
+        self.assertLess(copied, sum(values.nbytes for values in columns.values()) / 2)
+
+    def test_pickle_roundtrip(self):
+        config = self.config.genome_config
+        g = neat3p.NativeGenome(key=5)
+        g.configure_new(config)
+        for _ in range(10):
+            g.mutate(config)
+        g.fitness = 3.5
+
+        restored = pickle.loads(pickle.dumps(g))
+        self.assertIsInstance(restored, neat3p.NativeGenome)
+        self.assertEqual(restored.key, 5)
+        self.assertEqual(restored.fitness, 3.5)
+        np.testing.assert_array_equal(restored.connection_keys, g.connection_keys)
+        np.testing.assert_array_equal(restored.weights, g.weights)
+        self.assertEqual(restored.activations, g.activations)
+        self.assertEqual(g.distance(restored, config), 0.0)
+
+    def test_population_runs(self):
+        def eval_genomes(genomes, config):
+            for _, genome in genomes:
+                genome.fitness = float(len(genome.connections))
+
+        p = neat3p.Population(self.config)
+        winner = p.run(eval_genomes, 3)
+        self.assertIsInstance(winner, neat3p.NativeGenome)
+
+    def test_native_population_driver(self):
+        from neat3p.native_genome import build_population_params
+
+        params = build_population_params(self.config)
+        params.no_fitness_termination = True
+        p = neat3p._neat3p.Population(self.config.genome_config.native, params)
+        self.assertEqual(len(p.population_keys), self.config.pop_size)
+
+        seen = []
+        first_generation = []
+
+        def eval_genomes(genomes):
+            seen.append(len(genomes))
+            for _, genome in genomes:
+                genome.fitness = -abs(float(genome.weights.sum()) - 2.0)
+            if not first_generation:
+                first_generation.extend(genomes)
+
+        best = p.run(eval_genomes, 5)
+        self.assertEqual(p.generation, 5)
+        self.assertEqual(len(seen), 5)
+        # Genomes kept past reproduction stay valid and keep their fitness.
+        for key, genome in first_generation:
+            self.assertEqual(genome.key, key)
+            self.assertEqual(genome.fitness, -abs(float(genome.weights.sum()) - 2.0))
+        self.assertEqual(set(p.species_ids), set(p.population_keys))
+        self.assertIsNotNone(best.fitness)
+        self.assertGreater(best.fitness, -2.0)
+        key = p.population_keys[0]
+        self.assertEqual(p.genome(key).key, key)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,113 @@
+"""Novelty scores from the native archive must match a brute-force k-NN search."""
+
+import os
+import random
+import unittest
+
+import numpy as np
+
+import neat3p
+from neat3p import _neat3p
+
+
+def brute_force_novelty(archive, batch, k):
+    scores = []
+    for i, query in enumerate(batch):
+        others = np.concatenate([archive, np.delete(batch, i, axis=0)])
+        dist = np.sort(np.linalg.norm(others - query, axis=1))[:k]
+        scores.append(dist.mean() if len(dist) else 0.0)
+    return np.array(scores)
+
+
+class TestNoveltyArchive(unittest.TestCase):
+    def test_matches_brute_force(self):
+        rng = np.random.default_rng(3)
+        archive = _neat3p.NoveltyArchive(3, 7)
+        stored = np.empty((0, 3), dtype=np.float32)
+        # Several additions so that scoring covers both the indexed points and the unindexed tail.
+        for n in [40, 200, 30, 500, 10]:
+            batch = rng.normal(size=(120, 3)).astype(np.float32)
+            expected = brute_force_novelty(stored, batch, 7)
+            for num_threads in [1, 4]:
+                np.testing.assert_allclose(archive.score(batch, num_threads), expected, rtol=1e-4, atol=1e-5)
+
+            points = rng.normal(size=(n, 3)).astype(np.float32)
+            archive.add(points)
+            stored = np.concatenate([stored, points])
+            self.assertEqual(len(archive), len(stored))
+        np.testing.assert_array_equal(archive.behaviors(), stored)
+
+    def test_duplicates_and_small_batches(self):
+        archive = _neat3p.NoveltyArchive(2, 5)
+        self.assertEqual(list(archive.score(np.zeros((1, 2), dtype=np.float32))), [0.0])
+        archive.add(np.zeros((100, 2), dtype=np.float32))
+        scores = archive.score(np.array([[0, 0], [3, 4]], dtype=np.float32))
+        self.assertEqual(list(scores), [0.0, 5.0])
+
+    def test_wrong_dimension(self):
+        archive = _neat3p.NoveltyArchive(2)
+        with self.assertRaises(ValueError):
+            archive.score(np.zeros((4, 3), dtype=np.float32))
+
+
+class TestNoveltySearch(unittest.TestCase):
+    def setUp(self):
+        local_dir = os.path.dirname(__file__)
+        config_path = os.path.join(local_dir, "test_configuration")
+        self.config = neat3p.Config(
+            neat3p.DefaultGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            config_path,
+        )
+        self.config.no_fitness_termination = True
+        random.seed(5)
+
+    def test_combines_novelty_and_fitness(self):
+        def eval_genomes(genomes, config):
+            behaviors = {}
+            for genome_id, genome in genomes:
+                genome.fitness = float(len(genome.connections))
+                behaviors[genome_id] = [len(genome.nodes), len(genome.connections)]
+            return behaviors
+
+        novelty = neat3p.NoveltySearch(eval_genomes, k=5, novelty_weight=2.0, fitness_weight=0.5)
+        p = neat3p.Population(self.config)
+        p.run(novelty.evaluate, 6)
+
+        self.assertGreater(len(novelty.archive), 0)
+
+        genomes = list(p.population.items())
+        novelty.evaluate(genomes, self.config)
+        self.assertEqual(set(novelty.novelty), set(p.population))
+        for genome_id, genome in genomes:
+            expected = 2.0 * novelty.novelty[genome_id] + 0.5 * novelty.fitness[genome_id]
+            self.assertAlmostEqual(genome.fitness, expected, places=5)
+        self.assertEqual(novelty.best_fitness, max(novelty.best_fitness, *novelty.fitness.values()))
+        # The best genome is a snapshot: later generations do not rewrite its fitness.
+        self.assertEqual(novelty.best_genome.fitness, novelty.best_fitness)
+        self.assertFalse(any(genome is novelty.best_genome for _, genome in genomes))
+
+    def test_threshold_adapts_after_identical_generation(self):
+        rng = np.random.default_rng(2)
+        batches = [np.zeros((20, 2)), rng.uniform(size=(20, 2))]
+        genomes = [(gid, neat3p.DefaultGenome(gid)) for gid in range(20)]
+        novelty = neat3p.NoveltySearch(lambda genomes, config: batches.pop(0), k=5)
+
+        # Every genome behaves alike: no novelty, so no threshold to scale yet.
+        novelty.evaluate(genomes, self.config)
+        self.assertIsNone(novelty.archive_threshold)
+        self.assertEqual(len(novelty.archive), 0)
+
+        # The second one seeds it from its median, and half of it gets in,
+        # which raises the threshold.
+        novelty.evaluate(genomes, self.config)
+        median = np.median(list(novelty.novelty.values()))
+        self.assertGreater(median, 0.0)
+        self.assertAlmostEqual(novelty.archive_threshold, 1.2 * median, places=5)
+        self.assertGreater(len(novelty.archive), 4)
+
+
+if __name__ == "__main__":
+    unittest.main()
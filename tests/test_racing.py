@@ -0,0 +1,84 @@
+"""RacingEvaluator must save episodes without changing who gets to reproduce."""
+
+import math
+import os
+import random
+import unittest
+
+import neat3p
+
+
+class TestRacingEvaluator(unittest.TestCase):
+    def setUp(self):
+        local_dir = os.path.dirname(__file__)
+        config_path = os.path.join(local_dir, "test_configuration")
+        self.config = neat3p.Config(
+            neat3p.DefaultGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            config_path,
+        )
+        self.config.no_fitness_termination = True
+        random.seed(3)
+
+    @staticmethod
+    def episode(genome, config, episode):
+        # Well-separated true means, small noise that depends only on (genome, episode).
+        noise = random.Random(genome.key * 1000 + episode).gauss(0.0, 0.5)
+        return 10.0 * (genome.key % 17) + noise
+
+    def test_keeps_parents_and_saves_episodes(self):
+        p = neat3p.Population(self.config)
+        genomes = list(p.population.items())
+        racer = neat3p.RacingEvaluator(self.episode, 5, species_set=p.species)
+        racer.evaluate(genomes, self.config)
+
+        self.assertEqual(racer.episodes_budget, 5 * len(genomes))
+        self.assertLess(racer.episodes_run, 0.6 * racer.episodes_budget)
+
+        reproduction_config = self.config.reproduction_config
+        for s in p.species.species.values():
+            members = sorted(s.members.values(), key=lambda g: g.key % 17, reverse=True)
+            parents = max(math.ceil(reproduction_config.survival_threshold * len(members)), 2)
+            # Genomes with a true mean among the species' parents are never cut...
+            for g in members[:parents]:
+                self.assertNotIn(g.key, racer.cut)
+            # ...survivors get the mean of their episodes, cut genomes a lower
+            # bound on it...
+            for g in members:
+                self.assertAlmostEqual(g.fitness, 10.0 * (g.key % 17), delta=3.0 if g.key in racer.cut else 1.5)
+            # ...so cut genomes rank below every survivor of their species.
+            survivors = [g.fitness for g in members if g.key not in racer.cut]
+            for g in members:
+                if g.key in racer.cut:
+                    self.assertLess(g.fitness, min(survivors))
+        self.assertTrue(racer.cut)
+
+    def test_deterministic_rewards_without_species(self):
+        p = neat3p.Population(self.config)
+        genomes = list(p.population.items())
+        played = []
+
+        def episode(genome, config, episode):
+            played.append(genome.key)
+            return float(genome.key)
+
+        racer = neat3p.RacingEvaluator(episode, 4)
+        racer.evaluate(genomes, self.config)
+        # Zero variance: after two rounds only the parents of the single group race on.
+        parents = math.ceil(self.config.reproduction_config.survival_threshold * len(genomes))
+        self.assertEqual(len(played), 2 * len(genomes) + 2 * parents)
+        for gid, genome in genomes:
+            self.assertEqual(genome.fitness, float(gid))
+
+    def test_population_run(self):
+        p = neat3p.Population(self.config)
+        racer = neat3p.RacingEvaluator(self.episode, 3, species_set=p.species)
+        p.run(racer.evaluate, 5)
+        self.assertLessEqual(racer.episodes_run, racer.episodes_budget)
+        self.assertIsNotNone(p.best_genome)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,86 @@
+import os
+import unittest
+from concurrent.futures import ThreadPoolExecutor
+
+import neat3p
+
+
+def _load_config():
+    local_dir = os.path.dirname(__file__)
+    config_path = os.path.join(local_dir, "test_configuration")
+    return neat3p.Config(
+        neat3p.DefaultGenome,
+        neat3p.DefaultReproduction,
+        neat3p.DefaultSpeciesSet,
+        neat3p.DefaultStagnation,
+        config_path,
+    )
+
+
+def eval_size(genome, config):
+    return float(len(genome.connections)) - 0.1 * len(genome.nodes)
+
+
+class SteadyStateTests(unittest.TestCase):
+    def test_population_invariants(self):
+        config = _load_config()
+        config.no_fitness_termination = True
+        p = neat3p.SteadyStatePopulation(config)
+        self.assertEqual(len(p.pending), config.pop_size)
+        self.assertFalse(p.species.species)
+
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            best = p.run(eval_size, 3, num_workers=4, executor=executor)
+
+        self.assertEqual(p.evaluations, 3 * config.pop_size)
+        self.assertEqual(p.generation, 3)
+        self.assertFalse(p.pending)
+        self.assertEqual(len(p.population), config.pop_size)
+        self.assertIn(best.key, p.population)
+
+        members = {}
+        for sid, s in p.species.species.items():
+            self.assertTrue(s.members)
+            for gid, g in s.members.items():
+                self.assertIsNotNone(g.fitness)
+                self.assertEqual(p.species.get_species_id(gid), sid)
+                members[gid] = g
+            self.assertAlmostEqual(p._fitness_sums[sid], sum(s.get_fitnesses()), places=6)
+            self.assertIs(s.members.get(s.representative.key), s.representative)
+        self.assertEqual(members, p.population)
+
+    def test_removed_representative_is_replaced(self):
+        config = _load_config()
+        config.no_fitness_termination = True
+        p = neat3p.SteadyStatePopulation(config)
+        with ThreadPoolExecutor(max_workers=2) as executor:
+            p.run(eval_size, 1, num_workers=2, executor=executor)
+
+        # Make the representative of the largest species the worst individual.
+        sid, s = max(p.species.species.items(), key=lambda item: len(item[1].members))
+        self.assertGreater(len(s.members), 1)
+        representative = s.representative
+        self.assertIsNot(representative, p.best_genome)
+        worst = min(g.fitness for g in p.population.values()) - 100.0
+        p._fitness_sums[sid] += worst - representative.fitness
+        representative.fitness = worst
+        p.stagnant = set()
+
+        p._remove_worst()
+        self.assertNotIn(representative.key, p.population)
+        self.assertIn(sid, p.species.species)
+        self.assertIsNot(s.representative, representative)
+        self.assertIs(s.members.get(s.representative.key), s.representative)
+
+    def test_fitness_termination(self):
+        config = _load_config()
+        config.fitness_criterion = "max"
+        config.fitness_threshold = 1.0
+        p = neat3p.SteadyStatePopulation(config)
+        with ThreadPoolExecutor(max_workers=2) as executor:
+            best = p.run(eval_size, 50, num_workers=2, executor=executor)
+        self.assertGreaterEqual(best.fitness, 1.0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,75 @@
+"""StreamingStatisticsReporter must agree with StatisticsReporter over its window."""
+
+import math
+import os
+import random
+import tempfile
+import unittest
+
+import neat3p
+
+
+class TestStreamingStatistics(unittest.TestCase):
+    def setUp(self):
+        local_dir = os.path.dirname(__file__)
+        config_path = os.path.join(local_dir, "test_configuration")
+        self.config = neat3p.Config(
+            neat3p.DefaultGenome,
+            neat3p.DefaultReproduction,
+            neat3p.DefaultSpeciesSet,
+            neat3p.DefaultStagnation,
+            config_path,
+        )
+        self.config.no_fitness_termination = True
+        random.seed(11)
+
+    def _run(self, *reporters, generations=8):
+        p = neat3p.Population(self.config)
+        for r in reporters:
+            p.add_reporter(r)
+
+        def eval_genomes(genomes, config):
+            for genome_id, genome in genomes:
+                genome.fitness = random.gauss(len(genome.connections), 1.0)
+
+        p.run(eval_genomes, generations)
+
+    def test_matches_statistics_reporter(self):
+        full = neat3p.StatisticsReporter()
+        streaming = neat3p.StreamingStatisticsReporter(window=16)
+        self._run(full, streaming)
+
+        for expected, actual in [
+            (full.get_fitness_mean(), streaming.get_fitness_mean()),
+            (full.get_fitness_stdev(), streaming.get_fitness_stdev()),
+            (full.get_fitness_median(), streaming.get_fitness_median()),
+        ]:
+            self.assertEqual(len(expected), len(actual))
+            for e, a in zip(expected, actual):
+                self.assertAlmostEqual(e, a, places=9)
+
+        self.assertEqual(full.get_species_sizes(), streaming.get_species_sizes())
+        for sizes, fitness in zip(streaming.get_species_sizes(), streaming.get_species_fitness("NA")):
+            self.assertEqual([f == "NA" for f in fitness], [n == 0 for n in sizes])
+        self.assertEqual(full.best_genome().key, streaming.best_genome().key)
+
+    def test_window_bounds_history(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            log = os.path.join(tmpdir, "fitness.csv")
+            streaming = neat3p.StreamingStatisticsReporter(window=3, keep_best=2, log_filename=log)
+            self._run(streaming, generations=10)
+
+            self.assertEqual(len(streaming.get_fitness_mean()), 3)
+            self.assertEqual(streaming.stats.total_generations, 10)
+            self.assertEqual(len(streaming.best_genomes(5)), 2)
+            with open(log) as f:
+                self.assertEqual(len(f.readlines()), 10)
+
+        run = streaming.get_run_statistics()
+        self.assertEqual(run["count"], 10 * self.config.pop_size)
+        self.assertTrue(run["min"] <= run["quantiles"][0.5] <= run["max"])
+        self.assertFalse(math.isnan(run["stdev"]))
+
+
+if __name__ == "__main__":
+    unittest.main()